@@ -0,0 +1,577 @@
+/**
+ * Microbenchmarks for the CppLUT hot paths.
+ *
+ * Build and run from Classes with `make bench`. Every input is generated
+ * from a fixed seed, so runs on the same machine are comparable. Accuracy
+ * checks run before the timings, and the program exits with status 1 if one
+ * fails; `make check` runs only the checks. Options:
+ *
+ *   --json <path>      also write the results as JSON
+ *   --filter <text>    only run benchmarks and checks whose name contains `text`
+ *   --quick            fewer, shorter samples
+ *   --check            only run the accuracy checks
+ */
+
+#include "LUT1D.h"
+#include "LUT1DIntegerTable.h"
+#include "LUT3D.h"
+#include "LUT3DInverse.h"
+#include "LUTBakeGraph.h"
+#include "LUTColor.h"
+#include "LUTColorBatch.h"
+#include "LUTColorIndex.h"
+#include "LUTColorSpace.h"
+#include "LUTColorSpaceWhitePoint.h"
+#include "LUTColorTransferFunction.h"
+#include "LUTHelper.h"
+#include "LUTSIMD.h"
+#include "LUTShaper3D.h"
+
+#include <algorithm> // std::max std::sort
+#include <chrono> // std::chrono::steady_clock
+#include <cmath> // std::fabs std::isnan std::log2 std::pow
+#include <cstdint> // std::uint16_t
+#include <cstdio> // std::printf std::fprintf
+#include <cstring> // std::strcmp
+#include <functional> // std::function
+#include <limits> // std::numeric_limits
+#include <random> // std::mt19937
+#include <string> // std::string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+/** @brief      Keeps results alive so the optimiser cannot drop the work */
+volatile double sink;
+
+struct Options
+{
+	const char * jsonPath;
+	const char * filter;
+	int samples;
+	double minimumSampleSeconds;
+	bool checkOnly;
+};
+
+struct Result
+{
+	std::string name;
+	const char * unit;
+	std::size_t itemsPerRun;
+	double medianNanoseconds;
+	double minimumNanoseconds;
+};
+
+/**
+ * @brief      Times `run`, which processes `itemsPerRun` items per call. Each
+ *             sample repeats the call until it has taken at least the minimum
+ *             sample time, and the median and fastest samples are reported.
+ */
+Result measure(const Options & options, const std::string & name, const char * unit, std::size_t itemsPerRun,
+               const std::function<void()> & run)
+{
+	typedef std::chrono::steady_clock Clock;
+	run();
+
+	std::vector<double> perItem;
+	for (int sample = 0; sample < options.samples; sample++)
+	{
+		std::size_t runs = 0;
+		Clock::time_point start = Clock::now();
+		double elapsed = 0;
+		do
+		{
+			run();
+			runs++;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+		while (elapsed < options.minimumSampleSeconds);
+		perItem.push_back(elapsed * 1e9 / ((double)runs * itemsPerRun));
+	}
+	std::sort(perItem.begin(), perItem.end());
+
+	Result result = { name, unit, itemsPerRun, perItem[perItem.size() / 2], perItem.front() };
+	std::printf("%-52s %10.2f ns/%-5s %14.0f %s/s\n", name.c_str(), result.medianNanoseconds, unit,
+	            1e9 / result.medianNanoseconds, unit);
+	return result;
+}
+
+/**
+ * @brief      Runs `measure`, which returns an error, and reports whether the
+ *             error is within `bound`. A NaN error fails.
+ */
+bool check(const std::string & name, double bound, const std::function<double()> & measure)
+{
+	const double error = measure();
+	const bool passed = error <= bound;
+	std::printf("%-52s %10.3g error %10.3g bound %s\n", name.c_str(), error, bound, passed ? "ok" : "FAILED");
+	return passed;
+}
+
+const char * levelName(LUTSIMD::Level level)
+{
+	switch (level)
+	{
+		case LUTSIMD::AVX512: return "avx512";
+		case LUTSIMD::AVX2: return "avx2";
+		default: return "scalar";
+	}
+}
+
+std::vector<LUTColor> randomColors(std::mt19937 & random, std::size_t count)
+{
+	std::uniform_real_distribution<double> distribution(0, 1);
+	std::vector<LUTColor> colors;
+	colors.reserve(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		colors.push_back(LUTColor::colorWithRGB(distribution(random), distribution(random), distribution(random)));
+	}
+	return colors;
+}
+
+std::vector<float> randomPixels(std::mt19937 & random, std::size_t count, float low, float high)
+{
+	std::uniform_real_distribution<float> distribution(low, high);
+	std::vector<float> pixels(3 * count);
+	for (float & value : pixels)
+	{
+		value = distribution(random);
+	}
+	return pixels;
+}
+
+LUT3Df gradedLUT3D(int size)
+{
+	LUT3Df lut = LUT3Df::identityOfSize(size);
+	float * planes[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+	for (std::size_t i = 0; i < lut.getPointCount(); i++)
+	{
+		const float r = planes[0][i];
+		const float g = planes[1][i];
+		const float b = planes[2][i];
+		planes[0][i] = std::pow(0.9f * r + 0.1f * g, 0.8f);
+		planes[1][i] = 0.05f * r + 0.9f * g + 0.05f * b;
+		planes[2][i] = std::pow(0.1f * g + 0.9f * b, 1.2f);
+	}
+	return lut;
+}
+
+void writeJSON(const char * path, const std::vector<Result> & results)
+{
+	std::FILE * file = std::fopen(path, "w");
+	if (file == nullptr)
+	{
+		std::fprintf(stderr, "Unable to open %s for writing\n", path);
+		return;
+	}
+	std::fprintf(file, "{\n  \"library\": \"CppLUT\",\n  \"simd\": \"%s\",\n  \"threads\": %u,\n  \"results\": [\n",
+	             levelName(LUTSIMD::supportedLevel()), LUTHelper::concurrency());
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const Result & result = results[i];
+		std::fprintf(file, "    { \"name\": \"%s\", \"unit\": \"%s\", \"items_per_run\": %zu, "
+		             "\"ns_per_item\": %.4f, \"ns_per_item_min\": %.4f, \"items_per_second\": %.1f }%s\n",
+		             result.name.c_str(), result.unit, result.itemsPerRun, result.medianNanoseconds,
+		             result.minimumNanoseconds, 1e9 / result.medianNanoseconds, (i + 1 < results.size()) ? "," : "");
+	}
+	std::fprintf(file, "  ]\n}\n");
+	std::fclose(file);
+}
+
+}
+
+int main(int argc, char ** argv)
+{
+	Options options = { nullptr, nullptr, 7, 0.05, false };
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			options.jsonPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			options.filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--quick") == 0)
+		{
+			options.samples = 3;
+			options.minimumSampleSeconds = 0.01;
+		}
+		else if (std::strcmp(argv[i], "--check") == 0)
+		{
+			options.checkOnly = true;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--json path] [--filter text] [--quick] [--check]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	auto selected = [&](const std::string & name)
+	{
+		return options.filter == nullptr || name.find(options.filter) != std::string::npos;
+	};
+
+	// accuracy checks for the claims the library documents
+	int failedChecks = 0;
+	auto checkWithin = [&](const std::string & name, double bound, const std::function<double()> & measure)
+	{
+		if (selected(name) && !check(name, bound, measure))
+		{
+			failedChecks++;
+		}
+	};
+
+	// a 33^3 cube behind a fitted shaper should beat a plain 65^3 cube several
+	// times over on scene-linear input
+	const LUTShaper3Df::Transform sceneLinear = [](const LUTColor & color)
+	{
+		return LUTColor::colorWithRGB(std::log2(color.getR() + 1) / 6, std::log2(color.getG() + 1) / 6,
+		                              std::log2(color.getB() + 1) / 6);
+	};
+	const LUTShaper3Df uniformSceneLinear = LUTShaper3Df::withShaperAndTransform(LUT1Df::identityOfSize(2, 0, 64), 65,
+	                                                                             sceneLinear);
+	checkWithin("LUTShaper3Df::fitToTransform(log2, 0-64, 33)", uniformSceneLinear.maxErrorAgainst(sceneLinear) / 5, [&]()
+	{
+		return LUTShaper3Df::fitToTransform(sceneLinear, 0, 64, 33).maxErrorAgainst(sceneLinear);
+	});
+
+	// a NaN lattice output must surface in the error rather than be skipped
+	checkWithin("LUTShaper3Df::maxErrorAgainst[NaN lattice point]", 0, [&]()
+	{
+		LUT3Df cube = LUT3Df::identityOfSize(9);
+		cube.redPlane()[100] = std::numeric_limits<float>::quiet_NaN();
+		const LUTShaper3Df shaped = LUTShaper3Df::withShaperAndCube(LUT1Df::identityOfSize(2), cube);
+		return std::isnan(shaped.maxErrorAgainst([](const LUTColor & color) { return color; })) ? 0.0 : 1.0;
+	});
+
+	// inverting a gamma cube converges at every lattice point, and the inverse
+	// undoes the forward cube between lattice points to within interpolation
+	// error
+	LUT3Df gammaCube = LUT3Df::identityOfSize(33);
+	for (float * plane : { gammaCube.redPlane(), gammaCube.greenPlane(), gammaCube.bluePlane() })
+	{
+		for (std::size_t i = 0; i < gammaCube.getPointCount(); i++)
+		{
+			plane[i] = std::pow(plane[i], 1 / 2.2f);
+		}
+	}
+	const LUT3DInversef gammaInverse = LUT3DInversef::ofLUT3D(gammaCube);
+	checkWithin("LUT3DInversef::ofLUT3D(gamma, 33).maximumError", 1e-5, [&]()
+	{
+		return (gammaInverse.getUnconvergedPointCount() == 0) ? gammaInverse.getMaximumError() : 1.0;
+	});
+	auto roundTripError = [](const LUT3Df & forward, const LUT3Df & inverse)
+	{
+		std::mt19937 random(20161017);
+		const std::size_t count = 1 << 16;
+		const std::vector<float> pixels = randomPixels(random, count, 0, 1);
+		std::vector<float> inverted(pixels.size());
+		std::vector<float> restored(pixels.size());
+		inverse.apply(pixels.data(), inverted.data(), count);
+		forward.apply(inverted.data(), restored.data(), count);
+		double error = 0;
+		for (std::size_t i = 0; i < pixels.size(); i++)
+		{
+			error = std::max(error, (double)std::fabs(restored[i] - pixels[i]));
+		}
+		return error;
+	};
+	checkWithin("LUT3DInversef::ofLUT3D(identity, 33) round trip", 1e-6, [&]()
+	{
+		const LUT3Df identity = LUT3Df::identityOfSize(33);
+		return roundTripError(identity, LUT3DInversef::ofLUT3D(identity).getCube());
+	});
+	checkWithin("LUT3DInversef::ofLUT3D(gamma, 33) round trip", 1e-2, [&]()
+	{
+		return roundTripError(gammaCube, gammaInverse.getCube());
+	});
+	// NaN lattice outputs count as unconverged and stay out of the mean
+	checkWithin("LUT3DInversef::ofLUT3D(gamma, 33)[NaN].meanError", 1e-4, [&]()
+	{
+		LUT3Df damaged = gammaCube;
+		damaged.redPlane()[5000] = std::numeric_limits<float>::quiet_NaN();
+		damaged.greenPlane()[5001] = std::numeric_limits<float>::quiet_NaN();
+		return LUT3DInversef::ofLUT3D(damaged).getMeanError();
+	});
+
+	if (options.checkOnly)
+	{
+		return (failedChecks > 0) ? 1 : 0;
+	}
+
+	std::vector<Result> results;
+	auto bench = [&](const std::string & name, const char * unit, std::size_t itemsPerRun, const std::function<void()> & run)
+	{
+		if (selected(name))
+		{
+			results.push_back(measure(options, name, unit, itemsPerRun, run));
+		}
+	};
+
+	std::mt19937 random(20161017);
+	const std::size_t colorCount = 4096;
+	const std::vector<LUTColor> colors = randomColors(random, colorCount);
+	std::vector<LUTColor> scratch = colors;
+
+	bench("LUTColor::applySlopeOffsetPower", "op", colorCount, [&]()
+	{
+		scratch = colors;
+		for (LUTColor & color : scratch)
+		{
+			color.applySlopeOffsetPower(1.1, 0.01, 0.9, 1.0, 0.0, 1.1, 0.95, -0.01, 1.0);
+		}
+		sink = scratch[colorCount / 2].getR();
+	});
+	bench("LUTColor::changeSaturation", "op", colorCount, [&]()
+	{
+		scratch = colors;
+		for (LUTColor & color : scratch)
+		{
+			color.changeSaturation(1.2, 0.2126, 0.7152, 0.0722);
+		}
+		sink = scratch[colorCount / 2].getG();
+	});
+	bench("LUTColor::distanceToColor", "op", colorCount, [&]()
+	{
+		double total = 0;
+		for (std::size_t i = 1; i < colorCount; i++)
+		{
+			total += colors[i].distanceToColor(colors[i - 1]);
+		}
+		sink = total;
+	});
+	bench("LUTColor::lerpTo", "op", colorCount, [&]()
+	{
+		scratch = colors;
+		for (std::size_t i = 1; i < colorCount; i++)
+		{
+			scratch[i].lerpTo(colors[i - 1], 0.25);
+		}
+		sink = scratch[colorCount / 2].getB();
+	});
+
+	std::vector<double> values(colorCount);
+	for (std::size_t i = 0; i < colorCount; i++)
+	{
+		values[i] = colors[i].getR();
+	}
+	std::vector<double> remapped(colorCount);
+	std::vector<double> scratchY(colorCount);
+	bench("LUTHelper::remap", "op", colorCount, [&]()
+	{
+		double total = 0;
+		for (double value : values)
+		{
+			total += LUTHelper::remap<double>(value, 0, 1, -0.1, 1.1);
+		}
+		sink = total;
+	});
+	bench("LUTHelper::remap[array]", "op", colorCount, [&]()
+	{
+		LUTHelper::remap<double>(values.data(), remapped.data(), colorCount, 0, 1, -0.1, 1.1);
+		sink = remapped[colorCount / 2];
+	});
+	std::vector<double> temperatures(colorCount);
+	for (std::size_t i = 0; i < colorCount; i++)
+	{
+		temperatures[i] = 1667 + (25000 - 1667) * values[i];
+	}
+	bench("LUTColorSpaceWhitePoint::fromColorTemperature", "op", colorCount, [&]()
+	{
+		double total = 0;
+		for (double temperature : temperatures)
+		{
+			total += LUTColorSpaceWhitePoint::fromColorTemperature(temperature).getWhiteChromaticityX();
+		}
+		sink = total;
+	});
+	bench("LUTColorSpaceWhitePoint::chromaticitiesFromColorTemperatures", "op", colorCount, [&]()
+	{
+		LUTColorSpaceWhitePoint::chromaticitiesFromColorTemperatures(temperatures.data(), colorCount,
+		                                                             remapped.data(), scratchY.data());
+		sink = remapped[colorCount / 2] + scratchY[colorCount / 2];
+	});
+	const std::vector<LUTColorSpace> & colorSpaces = LUTColorSpace::knownColorSpaces();
+	bench("LUTColorSpace::knownWithName().npm()", "op", colorSpaces.size(), [&]()
+	{
+		double total = 0;
+		for (const LUTColorSpace & colorSpace : colorSpaces)
+		{
+			total += LUTColorSpace::knownWithName(colorSpace.getName())->npm()(1, 1);
+		}
+		sink = total;
+	});
+	bench("LUTHelper::indicesDoubleVector(65536)", "op", 65536, [&]()
+	{
+		sink = LUTHelper::indicesDoubleVector(0, 1, 65536)[1000];
+	});
+
+	std::vector<float> planes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		planes[c].resize(colorCount);
+	}
+	bench("LUTColorBatch::applySlopeOffsetPower[planar float]", "op", colorCount, [&]()
+	{
+		for (std::size_t i = 0; i < colorCount; i++)
+		{
+			planes[0][i] = (float)colors[i].getR();
+			planes[1][i] = (float)colors[i].getG();
+			planes[2][i] = (float)colors[i].getB();
+		}
+		LUTColorBatch::applySlopeOffsetPower(LUTColorSpan<float>::planar(planes[0].data(), planes[1].data(),
+		                                     planes[2].data(), colorCount),
+		                                     1.1, 0.01, 0.9, 1.0, 0.0, 1.1, 0.95, -0.01, 1.0);
+		sink = planes[0][colorCount / 2];
+	});
+
+	// whole-image applies, at every SIMD level the CPU supports
+	const std::size_t pixelCount = 1 << 20;
+	const std::vector<float> pixels = randomPixels(random, pixelCount, 0, 1);
+	std::vector<float> output(pixels.size());
+	const LUT3Df lut33 = gradedLUT3D(33);
+	const LUT3Df lut65 = gradedLUT3D(65);
+	const LUT3Dh lut33h = LUT3Dh::withLUT(lut33);
+	LUT1Df curve = LUT1Df::withSize(4096);
+	for (int i = 0; i < curve.getSize(); i++)
+	{
+		curve.redCurve()[i] = curve.greenCurve()[i] = curve.blueCurve()[i] = (float)std::pow(curve.identityValueAtIndex(i), 1 / 2.4);
+	}
+
+	const LUTSIMD::Level supported = LUTSIMD::supportedLevel();
+	for (int level = LUTSIMD::Scalar; level <= supported; level++)
+	{
+		LUTSIMD::setLevelLimit((LUTSIMD::Level)level);
+		const std::string suffix = std::string("[") + levelName((LUTSIMD::Level)level) + "]";
+		bench("LUT3Df(33).apply.tetrahedral" + suffix, "pixel", pixelCount, [&]()
+		{
+			lut33.apply(pixels.data(), output.data(), pixelCount, LUT3DInterpolation::Tetrahedral);
+			sink = output[7];
+		});
+		bench("LUT3Df(33).apply.trilinear" + suffix, "pixel", pixelCount, [&]()
+		{
+			lut33.apply(pixels.data(), output.data(), pixelCount, LUT3DInterpolation::Trilinear);
+			sink = output[7];
+		});
+		bench("LUT3Df(65).apply.tetrahedral" + suffix, "pixel", pixelCount, [&]()
+		{
+			lut65.apply(pixels.data(), output.data(), pixelCount, LUT3DInterpolation::Tetrahedral);
+			sink = output[7];
+		});
+		bench("LUT3Dh(33).apply.tetrahedral" + suffix, "pixel", pixelCount, [&]()
+		{
+			lut33h.apply(pixels.data(), output.data(), pixelCount, LUT3DInterpolation::Tetrahedral);
+			sink = output[7];
+		});
+		bench("LUT1Df(4096).apply" + suffix, "pixel", pixelCount, [&]()
+		{
+			curve.apply(pixels.data(), output.data(), pixelCount);
+			sink = output[7];
+		});
+	}
+	LUTSIMD::setLevelLimit(supported);
+
+	const LUT1DIntegerTable table = LUT1DIntegerTable::withLUT(curve, 10);
+	std::vector<std::uint16_t> codes(pixels.size());
+	for (std::size_t i = 0; i < codes.size(); i++)
+	{
+		codes[i] = (std::uint16_t)(pixels[i] * 1023);
+	}
+	bench("LUT1DIntegerTable(10).apply", "pixel", pixelCount, [&]()
+	{
+		table.apply(codes.data(), output.data(), pixelCount);
+		sink = output[7];
+	});
+
+	const LUTShaper3Df shaped = LUTShaper3Df::withShaperAndCube(curve, lut33);
+	bench("LUTShaper3Df(4096, 33).apply", "pixel", pixelCount, [&]()
+	{
+		shaped.apply(pixels.data(), output.data(), pixelCount);
+		sink = output[7];
+	});
+	bench("LUT3DInversef::ofLUT3D(33)", "point", lut33.getPointCount(), [&]()
+	{
+		sink = LUT3DInversef::ofLUT3D(lut33).getMaximumError();
+	});
+	bench("LUT3Df(33).resampledToSize(65)[tetrahedral]", "point", lut65.getPointCount(), [&]()
+	{
+		sink = lut33.resampledToSize(65, LUT3DResampling::Tetrahedral).redPlane()[7];
+	});
+	bench("LUT3Df(33).resampledToSize(65)[cubic]", "point", lut65.getPointCount(), [&]()
+	{
+		sink = lut33.resampledToSize(65, LUT3DResampling::Cubic).redPlane()[7];
+	});
+	bench("LUT3Df(65).resampledToSize(33)[trilinear]", "point", lut33.getPointCount(), [&]()
+	{
+		sink = lut65.resampledToSize(33, LUT3DResampling::Trilinear).redPlane()[7];
+	});
+
+	LUTBakeGraph grade = LUTBakeGraph::withSize(33);
+	const std::size_t gradeCDL = grade.appendSlopeOffsetPower(1.1, 0.01, 0.9, 1, 0, 1, 0.95, 0.02, 1.1);
+	const std::size_t gradeSaturation = grade.appendSaturation(1.2, 0.2126, 0.7152, 0.0722);
+	grade.appendLUT3D(lut33);
+	grade.bakeLUT3D<float>();
+	double slope = 1;
+	bench("LUTBakeGraph(33).setSlopeOffsetPower+bake", "point", lut33.getPointCount(), [&]()
+	{
+		slope = (slope > 1.5) ? 1 : slope + 0.01;
+		grade.setSlopeOffsetPower(gradeCDL, slope, 0.01, 0.9, 1, 0, 1, 0.95, 0.02, 1.1);
+		sink = grade.bakeLUT3D<float>().redPlane()[7];
+	});
+	double saturation = 1;
+	bench("LUTBakeGraph(33).setSaturation+bake", "point", lut33.getPointCount(), [&]()
+	{
+		saturation = (saturation > 1.5) ? 1 : saturation + 0.01;
+		grade.setSaturation(gradeSaturation, saturation, 0.2126, 0.7152, 0.0722);
+		sink = grade.bakeLUT3D<float>().redPlane()[7];
+	});
+
+	const LUTColorIndex latticeIndex = LUTColorIndex::withLUT3D(lut65);
+	const std::size_t queryCount = pixelCount / 16;
+	std::vector<std::size_t> nearestIndices(queryCount);
+	bench("LUTColorIndex(65^3).nearest", "query", queryCount, [&]()
+	{
+		latticeIndex.nearest(pixels.data(), queryCount, nearestIndices.data());
+		sink = (double)nearestIndices[7];
+	});
+
+	const std::size_t valueCount = 3 * pixelCount;
+	for (const LUTColorTransferFunction & exact : { LUTColorTransferFunction::logCTransferFunction(),
+	                                                LUTColorTransferFunction::pqTransferFunction() })
+	{
+		const LUTColorTransferFunction fast = exact.withFastEvaluation();
+		bench("LUTColorTransferFunction(" + exact.getName() + ").toLinear", "value", valueCount, [&]()
+		{
+			exact.toLinear(pixels.data(), output.data(), valueCount);
+			sink = output[7];
+		});
+		bench("LUTColorTransferFunction(" + exact.getName() + ").toLinear[fast]", "value", valueCount, [&]()
+		{
+			fast.toLinear(pixels.data(), output.data(), valueCount);
+			sink = output[7];
+		});
+		bench("LUTColorTransferFunction(" + exact.getName() + ").fromLinear", "value", valueCount, [&]()
+		{
+			exact.fromLinear(pixels.data(), output.data(), valueCount);
+			sink = output[7];
+		});
+		bench("LUTColorTransferFunction(" + exact.getName() + ").fromLinear[fast]", "value", valueCount, [&]()
+		{
+			fast.fromLinear(pixels.data(), output.data(), valueCount);
+			sink = output[7];
+		});
+	}
+
+	if (options.jsonPath != nullptr)
+	{
+		writeJSON(options.jsonPath, results);
+	}
+	return (failedChecks > 0) ? 1 : 0;
+}
@@ -2,9 +2,14 @@
 
 #define CPPLUT_SUGGESTED_MAX_LUT1D_SIZE 65536
 #define CPPLUT_SUGGESTED_MAX_LUT3D_SIZE 64
+#define CPPLUT_MAX_LUT3D_SIZE 256
+#define CPPLUT_MAX_LUT1D_SIZE 65536
 
 #define CPPLUT_MAX_CICOLORCUBE_SIZE 64
 #define CPPLUT_MAX_VVLUT1DFILTER_SIZE 65536
+
+#define CPPLUT_CACHE_LINE_SIZE 64
+#define CPPLUT_CONCURRENT_TILE_POINTS 4096
 /*
 #include "LUTHelper.h"
 #include "LUT.h"
@@ -0,0 +1,76 @@
+#include "LUT1D.h"
+#include "LUTHelper.h"
+
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+template <typename T>
+BasicLUT1D<T>::BasicLUT1D(int size, double inputLowerBound, double inputUpperBound):
+                          size(size),
+                          // one element of slack lets vector loads run past the last entry
+                          planeStride(alignedElementCount<T>((std::size_t)size + 1)),
+                          inputLowerBound(inputLowerBound),
+                          inputUpperBound(inputUpperBound),
+                          curves(3 * planeStride)
+{}
+
+template <typename T>
+BasicLUT1D<T> BasicLUT1D<T>::withSize(int size, double inputLowerBound, double inputUpperBound)
+{
+	if (size < 2 || size > CPPLUT_MAX_LUT1D_SIZE)
+	{
+		throw std::domain_error("Invalid LUT1D Size: size " + std::to_string(size) + " must be in the range 2 to "
+		                        + std::to_string(CPPLUT_MAX_LUT1D_SIZE));
+	}
+	if (!(inputLowerBound < inputUpperBound))
+	{
+		throw std::domain_error("Invalid LUT1D Bounds: input lower bound must be less than input upper bound");
+	}
+	return BasicLUT1D(size, inputLowerBound, inputUpperBound);
+}
+
+template <typename T>
+BasicLUT1D<T> BasicLUT1D<T>::identityOfSize(int size, double inputLowerBound, double inputUpperBound)
+{
+	BasicLUT1D lut = withSize(size, inputLowerBound, inputUpperBound);
+
+	std::vector<double> indices = LUTHelper::indicesDoubleVector(0, 1, size);
+	T * red = lut.redCurve();
+	T * green = lut.greenCurve();
+	T * blue = lut.blueCurve();
+	for (int i = 0; i < size; i++)
+	{
+		red[i] = green[i] = blue[i] = (T)(inputLowerBound + indices[i] * (inputUpperBound - inputLowerBound));
+	}
+	return lut;
+}
+
+template <typename T>
+typename BasicLUT1D<T>::Color BasicLUT1D<T>::colorAtIndex(int index) const
+{
+	return Color::colorWithRGB(redCurve()[index], greenCurve()[index], blueCurve()[index]);
+}
+
+template <typename T>
+void BasicLUT1D<T>::setColorAtIndex(int index, const Color & color)
+{
+	redCurve()[index] = color.getR();
+	greenCurve()[index] = color.getG();
+	blueCurve()[index] = color.getB();
+}
+
+template <typename T>
+double BasicLUT1D<T>::identityValueAtIndex(int index) const
+{
+	return inputLowerBound + index * (inputUpperBound - inputLowerBound) / (size - 1);
+}
+
+namespace CppLUT
+{
+template class BasicLUT1D<float>;
+template class BasicLUT1D<double>;
+template class BasicLUT1D<LUTHalf>;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUTAlignedBuffer.h"
+#include "LUTColor.h"
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A 1D look up table: an independent curve for each channel,
+ *             sampled on a uniform grid over the input range.
+ * @discussion The curves are stored as a structure of arrays: the red, green
+ *             and blue curves each live in their own contiguous plane of a
+ *             single cache-line aligned allocation. Because the grid is
+ *             uniform, the entry for an input value is found by scaling it,
+ *             with no search.
+ *
+ * @tparam     T     The curve value type: `float`, `double` or `LUTHalf`
+ */
+template <typename T>
+class BasicLUT1D
+{
+public:
+	/** @brief      The type of each curve value */
+	typedef T ValueType;
+
+	/** @brief      The color type handed out for single entries */
+	typedef BasicLUTColor<T> Color;
+
+private:
+	/** @brief      The number of entries in each curve */
+	int size;
+
+	/** @brief      The number of elements between the start of each curve */
+	std::size_t planeStride;
+
+	/** @brief      The input value mapped by the first entry */
+	double inputLowerBound;
+
+	/** @brief      The input value mapped by the last entry */
+	double inputUpperBound;
+
+	/** @brief      The red, green and blue curves, in that order */
+	LUTAlignedBuffer<T> curves;
+
+	/**
+	 * @brief      Private constructor for a LUT1D. All entries are 0.
+	 *
+	 * @param[in]  size             The number of entries in each curve
+	 * @param[in]  inputLowerBound  The input value mapped by the first entry
+	 * @param[in]  inputUpperBound  The input value mapped by the last entry
+	 */
+	BasicLUT1D(int size, double inputLowerBound, double inputUpperBound);
+
+public:
+	/**
+	 * @brief      Creates a `LUT1D` with every entry set to 0
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT1D_SIZE`
+	 * @throws     std::domain_error  If inputLowerBound is not less than
+	 *                                inputUpperBound
+	 *
+	 * @param[in]  size             The number of entries in each curve
+	 * @param[in]  inputLowerBound  The input value mapped by the first entry
+	 * @param[in]  inputUpperBound  The input value mapped by the last entry
+	 *
+	 * @return     A `LUT1D`
+	 */
+	static BasicLUT1D withSize(int size, double inputLowerBound = 0, double inputUpperBound = 1);
+
+	/**
+	 * @brief      Creates a `LUT1D` that maps every input to itself
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT1D_SIZE`
+	 * @throws     std::domain_error  If inputLowerBound is not less than
+	 *                                inputUpperBound
+	 *
+	 * @param[in]  size             The number of entries in each curve
+	 * @param[in]  inputLowerBound  The input value mapped by the first entry
+	 * @param[in]  inputUpperBound  The input value mapped by the last entry
+	 *
+	 * @return     An identity `LUT1D`
+	 */
+	static BasicLUT1D identityOfSize(int size, double inputLowerBound = 0, double inputUpperBound = 1);
+
+	/**
+	 * @brief      Creates a copy of a LUT with a different curve value type
+	 *
+	 * @param[in]  lut   The LUT to convert
+	 *
+	 * @tparam     U     The curve value type of `lut`
+	 *
+	 * @return     A converted copy of `lut`
+	 */
+	template <typename U>
+	static BasicLUT1D withLUT(const BasicLUT1D<U> & lut)
+	{
+		typedef typename LUTColorValueTraits<U>::ComputeType From;
+		BasicLUT1D result(lut.getSize(), lut.getInputLowerBound(), lut.getInputUpperBound());
+		const U * from[3] = { lut.redCurve(), lut.greenCurve(), lut.blueCurve() };
+		T * to[3] = { result.redCurve(), result.greenCurve(), result.blueCurve() };
+		for (int c = 0; c < 3; c++)
+		{
+			for (int i = 0; i < lut.getSize(); i++)
+			{
+				to[c][i] = (T)(From)from[c][i];
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * @brief      Gets the number of entries in each curve
+	 *
+	 * @return     The curve length
+	 */
+	int getSize() const { return size; }
+
+	double getInputLowerBound() const { return inputLowerBound; }
+	double getInputUpperBound() const { return inputUpperBound; }
+
+	/**
+	 * @brief      The contiguous red curve, `getSize()` long and aligned to
+	 *             `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * redCurve() { return curves.data(); }
+	const T * redCurve() const { return curves.data(); }
+
+	/**
+	 * @brief      The contiguous green curve, `getSize()` long and aligned to
+	 *             `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * greenCurve() { return curves.data() + planeStride; }
+	const T * greenCurve() const { return curves.data() + planeStride; }
+
+	/**
+	 * @brief      The contiguous blue curve, `getSize()` long and aligned to
+	 *             `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * blueCurve() { return curves.data() + 2 * planeStride; }
+	const T * blueCurve() const { return curves.data() + 2 * planeStride; }
+
+	/**
+	 * @brief      Reads the entry of each curve at an index. The index is not
+	 *             bounds checked.
+	 *
+	 * @param[in]  index  The index
+	 *
+	 * @return     The red, green and blue entries as a color
+	 */
+	Color colorAtIndex(int index) const;
+
+	/**
+	 * @brief      Writes the entry of each curve at an index. The index is not
+	 *             bounds checked.
+	 *
+	 * @param[in]  index  The index
+	 * @param[in]  color  The red, green and blue entries
+	 */
+	void setColorAtIndex(int index, const Color & color);
+
+	/**
+	 * @brief      The input value that maps exactly onto an index
+	 *
+	 * @param[in]  index  The index
+	 *
+	 * @return     The identity value of the index
+	 */
+	double identityValueAtIndex(int index) const;
+
+	/**
+	 * @brief      Look up a single color, interpolating linearly between
+	 *             entries. Inputs outside the input bounds are clamped to the
+	 *             first or last entry.
+	 *
+	 * @param[in]  color  The input color
+	 *
+	 * @return     The interpolated output color
+	 */
+	Color colorAtColor(const Color & color) const;
+
+	/**
+	 * @brief      Applies the LUT to a span of interleaved RGB pixels.
+	 * @discussion Uses AVX-512 or AVX2 gather kernels when the CPU supports
+	 *             them, and a scalar loop otherwise. Inputs outside the input
+	 *             bounds (including NaN) are clamped to the ends of the
+	 *             curves. `input` and `output` may point to the same buffer.
+	 *             Channels after the third in each pixel are left untouched
+	 *             in `output`.
+	 *
+	 * @param[in]  input        The first input pixel
+	 * @param[out] output       The first output pixel
+	 * @param[in]  pixelCount   The number of pixels to process
+	 * @param[in]  pixelStride  The number of floats from one pixel to the
+	 *                          next, 3 for RGB and 4 for RGBA
+	 */
+	void apply(const float * input, float * output, std::size_t pixelCount, std::size_t pixelStride = 3) const;
+
+	/**
+	 * @brief      Applies the LUT to separate red, green and blue planes
+	 *
+	 * @param[in]  input   The red, green and blue input planes
+	 * @param[out] output  The red, green and blue output planes, which may be
+	 *                     the input planes
+	 * @param[in]  count   The number of values in each plane
+	 */
+	void applyToPlanes(const float * const input[3], float * const output[3], std::size_t count) const;
+};
+
+extern template class BasicLUT1D<float>;
+extern template class BasicLUT1D<double>;
+extern template class BasicLUT1D<LUTHalf>;
+
+/** @brief      A 1D LUT with double precision curves */
+typedef BasicLUT1D<LUTColorValue> LUT1D;
+
+/** @brief      A 1D LUT with single precision curves */
+typedef BasicLUT1D<float> LUT1Df;
+
+/** @brief      A 1D LUT with half precision curves */
+typedef BasicLUT1D<LUTHalf> LUT1Dh;
+
+}
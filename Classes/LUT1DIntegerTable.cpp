@@ -0,0 +1,112 @@
+#include "LUT1DIntegerTable.h"
+
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+inline std::uint32_t swapBytes(std::uint32_t word)
+{
+	return (word >> 24) | ((word >> 8) & 0xFF00) | ((word << 8) & 0xFF0000) | (word << 24);
+}
+
+template <typename I>
+void applyIntegers(const LUT1DIntegerTable & table, const I * input, float * output, std::size_t pixelCount,
+                   std::size_t inputStride, std::size_t outputStride)
+{
+	const float * red = table.redTable();
+	const float * green = table.greenTable();
+	const float * blue = table.blueTable();
+	const unsigned maxCode = (unsigned)table.getEntryCount() - 1;
+	for (std::size_t p = 0; p < pixelCount; p++, input += inputStride, output += outputStride)
+	{
+		const unsigned r = input[0];
+		const unsigned g = input[1];
+		const unsigned b = input[2];
+		output[0] = red[r < maxCode ? r : maxCode];
+		output[1] = green[g < maxCode ? g : maxCode];
+		output[2] = blue[b < maxCode ? b : maxCode];
+	}
+}
+
+}
+
+LUT1DIntegerTable::LUT1DIntegerTable(int bitdepth):
+                                     bitdepth(bitdepth),
+                                     entryCount((std::size_t)1 << bitdepth),
+                                     tables(3 * entryCount)
+{}
+
+template <typename T>
+LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<T> & lut, int bitdepth)
+{
+	if (bitdepth < 1 || bitdepth > 16)
+	{
+		throw std::domain_error("Invalid Bitdepth: bitdepth " + std::to_string(bitdepth) + " must be in the range 1 to 16");
+	}
+	LUT1DIntegerTable table(bitdepth);
+
+	const std::size_t count = table.entryCount;
+	const double maxCode = (double)(count - 1);
+	std::vector<float> codes(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		codes[i] = (float)(i / maxCode);
+	}
+	const float * input[3] = { codes.data(), codes.data(), codes.data() };
+	float * output[3] = { table.tables.data(), table.tables.data() + count, table.tables.data() + 2 * count };
+	lut.applyToPlanes(input, output, count);
+	return table;
+}
+
+LUTColorf LUT1DIntegerTable::colorAtIntegers(unsigned r, unsigned g, unsigned b) const
+{
+	const unsigned maxCode = (unsigned)entryCount - 1;
+	return LUTColorf::colorWithRGB(redTable()[r < maxCode ? r : maxCode],
+	                               greenTable()[g < maxCode ? g : maxCode],
+	                               blueTable()[b < maxCode ? b : maxCode]);
+}
+
+void LUT1DIntegerTable::apply(const std::uint16_t * input, float * output, std::size_t pixelCount,
+                              std::size_t inputStride, std::size_t outputStride) const
+{
+	applyIntegers(*this, input, output, pixelCount, inputStride, outputStride);
+}
+
+void LUT1DIntegerTable::apply(const std::uint8_t * input, float * output, std::size_t pixelCount,
+                              std::size_t inputStride, std::size_t outputStride) const
+{
+	applyIntegers(*this, input, output, pixelCount, inputStride, outputStride);
+}
+
+void LUT1DIntegerTable::applyPackedDPX10(const std::uint32_t * input, float * output, std::size_t pixelCount,
+                                         std::size_t outputStride, bool byteSwapped) const
+{
+	if (bitdepth != 10)
+	{
+		throw std::domain_error("Invalid Bitdepth: packed 10-bit input needs a 10-bit table, not "
+		                        + std::to_string(bitdepth) + "-bit");
+	}
+	// every 10-bit field is a valid index, so no clamping is needed
+	const float * red = redTable();
+	const float * green = greenTable();
+	const float * blue = blueTable();
+	for (std::size_t p = 0; p < pixelCount; p++, output += outputStride)
+	{
+		const std::uint32_t word = byteSwapped ? swapBytes(input[p]) : input[p];
+		output[0] = red[(word >> 22) & 0x3FF];
+		output[1] = green[(word >> 12) & 0x3FF];
+		output[2] = blue[(word >> 2) & 0x3FF];
+	}
+}
+
+namespace CppLUT
+{
+template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<float> &, int);
+template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<double> &, int);
+template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<LUTHalf> &, int);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUTAlignedBuffer.h"
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint8_t std::uint16_t std::uint32_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A LUT1D expanded to one entry per integer code of a bit depth.
+ * @discussion Integer pixels index the tables directly, so applying the LUT
+ *             is three loads per pixel with no conversion to floating point
+ *             and no interpolation. Code `i` holds the LUT's value at
+ *             `i / (2^bitdepth - 1)`, the same mapping as
+ *             `LUTColor::colorFromIntegersWithBitdepth`. Codes above
+ *             `2^bitdepth - 1` are clamped to the last entry.
+ */
+class LUT1DIntegerTable
+{
+private:
+	/** @brief      The bit depth of the integer input */
+	int bitdepth;
+
+	/** @brief      The number of entries in each table, 2^bitdepth */
+	std::size_t entryCount;
+
+	/** @brief      The red, green and blue tables, in that order */
+	LUTAlignedBuffer<float> tables;
+
+	/**
+	 * @brief      Private constructor for a LUT1DIntegerTable. All entries
+	 *             are 0.
+	 *
+	 * @param[in]  bitdepth  The bit depth of the integer input
+	 */
+	explicit LUT1DIntegerTable(int bitdepth);
+
+public:
+	/**
+	 * @brief      Expands a LUT1D to one entry per code of a bit depth
+	 *
+	 * @throws     std::domain_error  If bitdepth is not in the range 1 to 16
+	 *
+	 * @param[in]  lut       The LUT to expand
+	 * @param[in]  bitdepth  The bit depth of the integer input
+	 *
+	 * @tparam     T         The curve value type of `lut`
+	 *
+	 * @return     The expanded table
+	 */
+	template <typename T>
+	static LUT1DIntegerTable withLUT(const BasicLUT1D<T> & lut, int bitdepth);
+
+	int getBitdepth() const { return bitdepth; }
+	std::size_t getEntryCount() const { return entryCount; }
+
+	const float * redTable() const { return tables.data(); }
+	const float * greenTable() const { return tables.data() + entryCount; }
+	const float * blueTable() const { return tables.data() + 2 * entryCount; }
+
+	/**
+	 * @brief      Looks up a single integer color
+	 *
+	 * @param[in]  r     The red code
+	 * @param[in]  g     The green code
+	 * @param[in]  b     The blue code
+	 *
+	 * @return     The output color
+	 */
+	LUTColorf colorAtIntegers(unsigned r, unsigned g, unsigned b) const;
+
+	/**
+	 * @brief      Applies the table to interleaved 16-bit integer pixels, such
+	 *             as 10, 12 or 16-bit samples stored one per 16-bit word.
+	 *
+	 * @param[in]  input         The first input pixel
+	 * @param[out] output        The first output pixel
+	 * @param[in]  pixelCount    The number of pixels to process
+	 * @param[in]  inputStride   The number of words from one input pixel to
+	 *                           the next
+	 * @param[in]  outputStride  The number of floats from one output pixel to
+	 *                           the next
+	 */
+	void apply(const std::uint16_t * input, float * output, std::size_t pixelCount,
+	           std::size_t inputStride = 3, std::size_t outputStride = 3) const;
+
+	/**
+	 * @brief      Applies the table to interleaved 8-bit integer pixels
+	 *
+	 * @param[in]  input         The first input pixel
+	 * @param[out] output        The first output pixel
+	 * @param[in]  pixelCount    The number of pixels to process
+	 * @param[in]  inputStride   The number of bytes from one input pixel to
+	 *                           the next
+	 * @param[in]  outputStride  The number of floats from one output pixel to
+	 *                           the next
+	 */
+	void apply(const std::uint8_t * input, float * output, std::size_t pixelCount,
+	           std::size_t inputStride = 3, std::size_t outputStride = 3) const;
+
+	/**
+	 * @brief      Applies the table to 10-bit RGB pixels packed one per 32-bit
+	 *             word, DPX packing method A.
+	 * @discussion Each word holds red in bits 22-31, green in bits 12-21 and
+	 *             blue in bits 2-11; the low two bits are padding.
+	 *
+	 * @throws     std::domain_error  If the table's bit depth is not 10
+	 *
+	 * @param[in]  input         The first packed pixel
+	 * @param[out] output        The first output pixel
+	 * @param[in]  pixelCount    The number of pixels to process
+	 * @param[in]  outputStride  The number of floats from one output pixel to
+	 *                           the next
+	 * @param[in]  byteSwapped   Whether the words are in the opposite byte
+	 *                           order to the host, as big-endian DPX data is
+	 *                           on x86
+	 */
+	void applyPackedDPX10(const std::uint32_t * input, float * output, std::size_t pixelCount,
+	                      std::size_t outputStride = 3, bool byteSwapped = false) const;
+};
+
+extern template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<float> &, int);
+extern template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<double> &, int);
+extern template LUT1DIntegerTable LUT1DIntegerTable::withLUT(const BasicLUT1D<LUTHalf> &, int);
+
+}
@@ -0,0 +1,229 @@
+#include "LUT1D.h"
+#include "LUTSIMD.h"
+#include "LUTSIMDGather.h"
+
+using namespace CppLUT;
+using namespace CppLUT::LUTSIMD;
+
+namespace
+{
+
+/**
+ * @brief      Everything a kernel needs to turn an input value into a curve
+ *             index and to address the curves.
+ */
+template <typename T>
+struct CurveAccess
+{
+	const T * curves[3];
+	/** @brief      Multiplier taking an input value to a curve coordinate */
+	double scale;
+	/** @brief      Offset taking an input value to a curve coordinate */
+	double offset;
+	/** @brief      The highest curve coordinate, size - 1 */
+	double maxCoordinate;
+	/** @brief      The highest base index of an interpolation segment, size - 2 */
+	int maxBase;
+};
+
+template <typename T>
+CurveAccess<T> curveAccess(const BasicLUT1D<T> & lut)
+{
+	CurveAccess<T> access;
+	access.curves[0] = lut.redCurve();
+	access.curves[1] = lut.greenCurve();
+	access.curves[2] = lut.blueCurve();
+	access.scale = (lut.getSize() - 1) / (lut.getInputUpperBound() - lut.getInputLowerBound());
+	access.offset = -lut.getInputLowerBound() * access.scale;
+	access.maxCoordinate = lut.getSize() - 1;
+	access.maxBase = lut.getSize() - 2;
+	return access;
+}
+
+/**
+ * @brief      The three channels a kernel reads and writes. Interleaved pixels
+ *             are three channels offset by one with the pixel stride, planes
+ *             are three separate channels with a stride of one.
+ */
+struct Channels
+{
+	const float * input[3];
+	float * output[3];
+	std::size_t stride;
+};
+
+template <typename T, typename C>
+inline C lookupScalar(const CurveAccess<T> & access, const T * curve, C value)
+{
+	const C maxCoordinate = (C)access.maxCoordinate;
+	C coordinate = value * (C)access.scale + (C)access.offset;
+	coordinate = (coordinate > 0) ? coordinate : 0;
+	coordinate = (coordinate < maxCoordinate) ? coordinate : maxCoordinate;
+	int base = (int)coordinate;
+	base = (base < access.maxBase) ? base : access.maxBase;
+	const C fraction = coordinate - base;
+	return (C)curve[base] + fraction * ((C)curve[base + 1] - (C)curve[base]);
+}
+
+template <typename T>
+void applyScalar(const CurveAccess<T> & access, const Channels & channels, std::size_t begin, std::size_t end)
+{
+	for (std::size_t p = begin; p < end; p++)
+	{
+		const std::size_t offset = p * channels.stride;
+		for (int c = 0; c < 3; c++)
+		{
+			channels.output[c][offset] = lookupScalar(access, access.curves[c], channels.input[c][offset]);
+		}
+	}
+}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+template <typename T>
+CPPLUT_TARGET_AVX2 inline __m256 lookupAVX2(const CurveAccess<T> & access, const T * curve, __m256 value)
+{
+	__m256 coordinate = _mm256_fmadd_ps(value, _mm256_set1_ps((float)access.scale), _mm256_set1_ps((float)access.offset));
+	// max_ps returns its second operand when the first is NaN
+	coordinate = _mm256_max_ps(coordinate, _mm256_setzero_ps());
+	coordinate = _mm256_min_ps(coordinate, _mm256_set1_ps((float)access.maxCoordinate));
+	__m256i base = _mm256_min_epi32(_mm256_cvttps_epi32(coordinate), _mm256_set1_epi32(access.maxBase));
+	__m256 fraction = _mm256_sub_ps(coordinate, _mm256_cvtepi32_ps(base));
+	__m256 low = gatherAVX2(curve, base);
+	__m256 high = gatherAVX2(curve, _mm256_add_epi32(base, _mm256_set1_epi32(1)));
+	return _mm256_fmadd_ps(fraction, _mm256_sub_ps(high, low), low);
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX2 std::size_t applyAVX2(const CurveAccess<T> & access, const Channels & channels, std::size_t pixelCount)
+{
+	const std::size_t stride = channels.stride;
+	const __m256i laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+	                                               _mm256_set1_epi32((int)stride));
+	std::size_t p = 0;
+	for (; p + 8 <= pixelCount; p += 8)
+	{
+		const std::size_t offset = p * stride;
+		for (int c = 0; c < 3; c++)
+		{
+			const float * in = channels.input[c] + offset;
+			float * out = channels.output[c] + offset;
+			if (stride == 1)
+			{
+				_mm256_storeu_ps(out, lookupAVX2(access, access.curves[c], _mm256_loadu_ps(in)));
+			}
+			else
+			{
+				alignas(32) float lanes[8];
+				_mm256_store_ps(lanes, lookupAVX2(access, access.curves[c], _mm256_i32gather_ps(in, laneOffsets, 4)));
+				for (int lane = 0; lane < 8; lane++)
+				{
+					out[lane * stride] = lanes[lane];
+				}
+			}
+		}
+	}
+	return p;
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX512 inline __m512 lookupAVX512(const CurveAccess<T> & access, const T * curve, __m512 value)
+{
+	__m512 coordinate = _mm512_fmadd_ps(value, _mm512_set1_ps((float)access.scale), _mm512_set1_ps((float)access.offset));
+	coordinate = _mm512_max_ps(coordinate, _mm512_setzero_ps());
+	coordinate = _mm512_min_ps(coordinate, _mm512_set1_ps((float)access.maxCoordinate));
+	__m512i base = _mm512_min_epi32(_mm512_cvttps_epi32(coordinate), _mm512_set1_epi32(access.maxBase));
+	__m512 fraction = _mm512_sub_ps(coordinate, _mm512_cvtepi32_ps(base));
+	__m512 low = gatherAVX512(curve, base);
+	__m512 high = gatherAVX512(curve, _mm512_add_epi32(base, _mm512_set1_epi32(1)));
+	return _mm512_fmadd_ps(fraction, _mm512_sub_ps(high, low), low);
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX512 std::size_t applyAVX512(const CurveAccess<T> & access, const Channels & channels, std::size_t pixelCount)
+{
+	const std::size_t stride = channels.stride;
+	const __m512i laneOffsets = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+	                                               _mm512_set1_epi32((int)stride));
+	std::size_t p = 0;
+	for (; p + 16 <= pixelCount; p += 16)
+	{
+		const std::size_t offset = p * stride;
+		for (int c = 0; c < 3; c++)
+		{
+			const float * in = channels.input[c] + offset;
+			float * out = channels.output[c] + offset;
+			if (stride == 1)
+			{
+				_mm512_storeu_ps(out, lookupAVX512(access, access.curves[c], _mm512_loadu_ps(in)));
+			}
+			else
+			{
+				_mm512_i32scatter_ps(out, laneOffsets, lookupAVX512(access, access.curves[c],
+				                     _mm512_i32gather_ps(laneOffsets, in, 4)), 4);
+			}
+		}
+	}
+	return p;
+}
+
+#endif
+
+template <typename T>
+void applyDispatch(const CurveAccess<T> & access, const Channels & channels, std::size_t pixelCount)
+{
+	std::size_t done = 0;
+#if defined(CPPLUT_X86_DISPATCH)
+	switch (LUTSIMD::activeLevel())
+	{
+		case LUTSIMD::AVX512:
+			done = applyAVX512(access, channels, pixelCount);
+			break;
+		case LUTSIMD::AVX2:
+			done = applyAVX2(access, channels, pixelCount);
+			break;
+		default:
+			break;
+	}
+#endif
+	applyScalar(access, channels, done, pixelCount);
+}
+
+}
+
+template <typename T>
+void BasicLUT1D<T>::apply(const float * input, float * output, std::size_t pixelCount, std::size_t pixelStride) const
+{
+	Channels channels = { { input, input + 1, input + 2 }, { output, output + 1, output + 2 }, pixelStride };
+	applyDispatch(curveAccess(*this), channels, pixelCount);
+}
+
+template <typename T>
+void BasicLUT1D<T>::applyToPlanes(const float * const input[3], float * const output[3], std::size_t count) const
+{
+	Channels channels = { { input[0], input[1], input[2] }, { output[0], output[1], output[2] }, 1 };
+	applyDispatch(curveAccess(*this), channels, count);
+}
+
+template <typename T>
+typename BasicLUT1D<T>::Color BasicLUT1D<T>::colorAtColor(const Color & color) const
+{
+	typedef typename Color::ComputeType C;
+	CurveAccess<T> access = curveAccess(*this);
+	return Color::colorWithRGB((T)lookupScalar(access, access.curves[0], (C)color.getR()),
+	                           (T)lookupScalar(access, access.curves[1], (C)color.getG()),
+	                           (T)lookupScalar(access, access.curves[2], (C)color.getB()));
+}
+
+namespace CppLUT
+{
+template void BasicLUT1D<float>::apply(const float *, float *, std::size_t, std::size_t) const;
+template void BasicLUT1D<double>::apply(const float *, float *, std::size_t, std::size_t) const;
+template void BasicLUT1D<LUTHalf>::apply(const float *, float *, std::size_t, std::size_t) const;
+template void BasicLUT1D<float>::applyToPlanes(const float * const [3], float * const [3], std::size_t) const;
+template void BasicLUT1D<double>::applyToPlanes(const float * const [3], float * const [3], std::size_t) const;
+template void BasicLUT1D<LUTHalf>::applyToPlanes(const float * const [3], float * const [3], std::size_t) const;
+template LUT1Df::Color BasicLUT1D<float>::colorAtColor(const LUTColorf &) const;
+template LUT1D::Color BasicLUT1D<double>::colorAtColor(const LUTColor &) const;
+template LUT1Dh::Color BasicLUT1D<LUTHalf>::colorAtColor(const LUTColorh &) const;
+}
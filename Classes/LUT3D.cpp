@@ -0,0 +1,91 @@
+#include "LUT3D.h"
+#include "LUTHelper.h"
+
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+
+using namespace CppLUT;
+
+template <typename T>
+BasicLUT3D<T>::BasicLUT3D(int size, double inputLowerBound, double inputUpperBound):
+                          size(size),
+                          // one element of slack lets vector loads run past the last point
+                          planeStride(alignedElementCount<T>((std::size_t)size * size * size + 1)),
+                          inputLowerBound(inputLowerBound),
+                          inputUpperBound(inputUpperBound),
+                          lattice(3 * planeStride)
+{}
+
+template <typename T>
+BasicLUT3D<T> BasicLUT3D<T>::withSize(int size, double inputLowerBound, double inputUpperBound)
+{
+	if (size < 2 || size > CPPLUT_MAX_LUT3D_SIZE)
+	{
+		throw std::domain_error("Invalid LUT3D Size: size " + std::to_string(size) + " must be in the range 2 to "
+		                        + std::to_string(CPPLUT_MAX_LUT3D_SIZE));
+	}
+	if (!(inputLowerBound < inputUpperBound))
+	{
+		throw std::domain_error("Invalid LUT3D Bounds: input lower bound must be less than input upper bound");
+	}
+	return BasicLUT3D(size, inputLowerBound, inputUpperBound);
+}
+
+template <typename T>
+BasicLUT3D<T> BasicLUT3D<T>::identityOfSize(int size, double inputLowerBound, double inputUpperBound)
+{
+	BasicLUT3D lut = withSize(size, inputLowerBound, inputUpperBound);
+
+	std::vector<double> indices = LUTHelper::indicesDoubleVector(0, 1, size);
+	for (double & value : indices)
+	{
+		value = inputLowerBound + value * (inputUpperBound - inputLowerBound);
+	}
+
+	T * red = lut.redPlane();
+	T * green = lut.greenPlane();
+	T * blue = lut.bluePlane();
+	std::size_t index = 0;
+	for (int b = 0; b < size; b++)
+	{
+		for (int g = 0; g < size; g++)
+		{
+			for (int r = 0; r < size; r++, index++)
+			{
+				red[index] = (T)indices[r];
+				green[index] = (T)indices[g];
+				blue[index] = (T)indices[b];
+			}
+		}
+	}
+	return lut;
+}
+
+template <typename T>
+typename BasicLUT3D<T>::Color BasicLUT3D<T>::colorAtPoint(int r, int g, int b) const
+{
+	std::size_t index = indexOfPoint(r, g, b);
+	return Color::colorWithRGB(redPlane()[index], greenPlane()[index], bluePlane()[index]);
+}
+
+template <typename T>
+void BasicLUT3D<T>::setColorAtPoint(int r, int g, int b, const Color & color)
+{
+	(*this)(r, g, b) = color;
+}
+
+template <typename T>
+typename BasicLUT3D<T>::Color BasicLUT3D<T>::identityColorAtPoint(int r, int g, int b) const
+{
+	double step = (inputUpperBound - inputLowerBound) / (size - 1);
+	return Color::colorWithRGB((T)(inputLowerBound + r * step),
+	                           (T)(inputLowerBound + g * step),
+	                           (T)(inputLowerBound + b * step));
+}
+
+namespace CppLUT
+{
+template class BasicLUT3D<float>;
+template class BasicLUT3D<double>;
+template class BasicLUT3D<LUTHalf>;
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUTAlignedBuffer.h"
+#include "LUTColor.h"
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      The method used to interpolate between lattice points
+ */
+enum class LUT3DInterpolation
+{
+	/** Blends the eight lattice points surrounding the input */
+	Trilinear,
+	/** Blends the four lattice points of the tetrahedron containing the input */
+	Tetrahedral
+};
+
+/**
+ * @brief      The method used to resample a lattice to a different size
+ */
+enum class LUT3DResampling
+{
+	/** Blends the eight lattice points surrounding each new point */
+	Trilinear,
+	/** Blends the four lattice points of the tetrahedron containing each new point */
+	Tetrahedral,
+	/** Catmull-Rom splines through four lattice points along each axis */
+	Cubic
+};
+
+/**
+ * @brief      A 3D look up table.
+ * @discussion The lattice is stored as a structure of arrays: the red, green
+ *             and blue channels each live in their own contiguous plane of a
+ *             single cache-line aligned allocation. Points are ordered with
+ *             red varying fastest, the same order used by .cube files, so the
+ *             point at (r, g, b) is at `r + size * (g + size * b)` in every
+ *             plane.
+ *
+ * @tparam     T     The lattice value type: `float`, `double` or `LUTHalf`.
+ *                   Single and half precision lattices take a half or a
+ *                   quarter of the memory and are applied without converting
+ *                   to double.
+ */
+template <typename T>
+class BasicLUT3D
+{
+public:
+	/** @brief      The type of each lattice value */
+	typedef T ValueType;
+
+	/** @brief      The color type handed out for single points */
+	typedef BasicLUTColor<T> Color;
+
+	/**
+	 * @brief      A view of a single lattice point that reads and writes
+	 *             through to the planes of a `BasicLUT3D`.
+	 */
+	class PointReference
+	{
+	private:
+		BasicLUT3D & lut;
+		std::size_t index;
+
+	public:
+		PointReference(BasicLUT3D & lut, std::size_t index): lut(lut), index(index) {}
+
+		T getR() const { return lut.redPlane()[index]; }
+		T getG() const { return lut.greenPlane()[index]; }
+		T getB() const { return lut.bluePlane()[index]; }
+
+		/**
+		 * @brief      Reads the lattice point as a `LUTColor`
+		 */
+		operator Color() const { return Color::colorWithRGB(getR(), getG(), getB()); }
+
+		/**
+		 * @brief      Writes a `LUTColor` to the lattice point
+		 *
+		 * @param[in]  color  The color to store
+		 *
+		 * @return     This reference
+		 */
+		PointReference & operator=(const Color & color)
+		{
+			lut.redPlane()[index] = color.getR();
+			lut.greenPlane()[index] = color.getG();
+			lut.bluePlane()[index] = color.getB();
+			return *this;
+		}
+	};
+
+private:
+	/** @brief      The number of points along each edge of the cube */
+	int size;
+
+	/** @brief      The number of elements between the start of each plane */
+	std::size_t planeStride;
+
+	/** @brief      The lowest input value mapped by the lattice */
+	double inputLowerBound;
+
+	/** @brief      The highest input value mapped by the lattice */
+	double inputUpperBound;
+
+	/** @brief      The red, green and blue planes, in that order */
+	LUTAlignedBuffer<T> lattice;
+
+	/**
+	 * @brief      Private constructor for a LUT3D. All points are black.
+	 *
+	 * @param[in]  size             The number of points along each edge
+	 * @param[in]  inputLowerBound  The lowest input value mapped by the lattice
+	 * @param[in]  inputUpperBound  The highest input value mapped by the lattice
+	 */
+	BasicLUT3D(int size, double inputLowerBound, double inputUpperBound);
+
+public:
+	/**
+	 * @brief      Creates a `LUT3D` with every lattice point set to black
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`
+	 * @throws     std::domain_error  If inputLowerBound is not less than
+	 *                                inputUpperBound
+	 *
+	 * @param[in]  size             The number of points along each edge
+	 * @param[in]  inputLowerBound  The lowest input value mapped by the lattice
+	 * @param[in]  inputUpperBound  The highest input value mapped by the lattice
+	 *
+	 * @return     A `LUT3D`
+	 */
+	static BasicLUT3D withSize(int size, double inputLowerBound = 0, double inputUpperBound = 1);
+
+	/**
+	 * @brief      Creates a `LUT3D` that maps every input to itself
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`
+	 * @throws     std::domain_error  If inputLowerBound is not less than
+	 *                                inputUpperBound
+	 *
+	 * @param[in]  size             The number of points along each edge
+	 * @param[in]  inputLowerBound  The lowest input value mapped by the lattice
+	 * @param[in]  inputUpperBound  The highest input value mapped by the lattice
+	 *
+	 * @return     An identity `LUT3D`
+	 */
+	static BasicLUT3D identityOfSize(int size, double inputLowerBound = 0, double inputUpperBound = 1);
+
+	/**
+	 * @brief      Creates a copy of a LUT with a different lattice value type,
+	 *             e.g. a half precision copy of a double precision LUT
+	 *
+	 * @param[in]  lut   The LUT to convert
+	 *
+	 * @tparam     U     The lattice value type of `lut`
+	 *
+	 * @return     A converted copy of `lut`
+	 */
+	template <typename U>
+	static BasicLUT3D withLUT(const BasicLUT3D<U> & lut)
+	{
+		typedef typename LUTColorValueTraits<U>::ComputeType From;
+		BasicLUT3D result(lut.getSize(), lut.getInputLowerBound(), lut.getInputUpperBound());
+		const U * from[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+		T * to[3] = { result.redPlane(), result.greenPlane(), result.bluePlane() };
+		const std::size_t count = lut.getPointCount();
+		for (int c = 0; c < 3; c++)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				to[c][i] = (T)(From)from[c][i];
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * @brief      Gets the number of points along each edge of the cube.
+	 *
+	 * @return     The edge length of the lattice.
+	 */
+	int getSize() const { return size; }
+
+	/**
+	 * @brief      Gets the total number of lattice points, `size` cubed.
+	 *
+	 * @return     The number of points in each plane.
+	 */
+	std::size_t getPointCount() const { return (std::size_t)size * size * size; }
+
+	double getInputLowerBound() const { return inputLowerBound; }
+	double getInputUpperBound() const { return inputUpperBound; }
+
+	/**
+	 * @brief      Determine the plane index of a lattice point
+	 *
+	 * @param[in]  r     The red lattice coordinate
+	 * @param[in]  g     The green lattice coordinate
+	 * @param[in]  b     The blue lattice coordinate
+	 *
+	 * @return     The index of the point in each plane
+	 */
+	std::size_t indexOfPoint(int r, int g, int b) const
+	{
+		return (std::size_t)r + (std::size_t)size * ((std::size_t)g + (std::size_t)size * b);
+	}
+
+	/**
+	 * @brief      The contiguous plane of red values, `getPointCount()` long
+	 *             and aligned to `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * redPlane() { return lattice.data(); }
+	const T * redPlane() const { return lattice.data(); }
+
+	/**
+	 * @brief      The contiguous plane of green values, `getPointCount()` long
+	 *             and aligned to `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * greenPlane() { return lattice.data() + planeStride; }
+	const T * greenPlane() const { return lattice.data() + planeStride; }
+
+	/**
+	 * @brief      The contiguous plane of blue values, `getPointCount()` long
+	 *             and aligned to `CPPLUT_CACHE_LINE_SIZE`.
+	 */
+	T * bluePlane() { return lattice.data() + 2 * planeStride; }
+	const T * bluePlane() const { return lattice.data() + 2 * planeStride; }
+
+	/**
+	 * @brief      Reads a lattice point. Coordinates are not bounds checked.
+	 *
+	 * @param[in]  r     The red lattice coordinate
+	 * @param[in]  g     The green lattice coordinate
+	 * @param[in]  b     The blue lattice coordinate
+	 *
+	 * @return     The color stored at the point
+	 */
+	Color colorAtPoint(int r, int g, int b) const;
+
+	/**
+	 * @brief      Writes a lattice point. Coordinates are not bounds checked.
+	 *
+	 * @param[in]  r      The red lattice coordinate
+	 * @param[in]  g      The green lattice coordinate
+	 * @param[in]  b      The blue lattice coordinate
+	 * @param[in]  color  The color to store at the point
+	 */
+	void setColorAtPoint(int r, int g, int b, const Color & color);
+
+	/**
+	 * @brief      The input color that maps exactly onto a lattice point
+	 *
+	 * @param[in]  r     The red lattice coordinate
+	 * @param[in]  g     The green lattice coordinate
+	 * @param[in]  b     The blue lattice coordinate
+	 *
+	 * @return     The identity color of the point
+	 */
+	Color identityColorAtPoint(int r, int g, int b) const;
+
+	/**
+	 * @brief      Look up a single color, interpolating between lattice points.
+	 *             Inputs outside the input bounds are clamped to the nearest
+	 *             edge of the lattice.
+	 *
+	 * @param[in]  color          The input color
+	 * @param[in]  interpolation  The interpolation method
+	 *
+	 * @return     The interpolated output color
+	 */
+	Color colorAtColor(const Color & color,
+	                   LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral) const;
+
+	/**
+	 * @brief      Applies the LUT to a span of interleaved RGB pixels.
+	 * @discussion Uses AVX-512 or AVX2 gather kernels when the CPU supports
+	 *             them, and a scalar loop otherwise. Inputs outside the input
+	 *             bounds (including NaN) are clamped to the edge of the
+	 *             lattice rather than raising an error. `input` and `output`
+	 *             may point to the same buffer. Channels after the third in
+	 *             each pixel are left untouched in `output`.
+	 *
+	 * @param[in]  input          The first input pixel
+	 * @param[out] output         The first output pixel
+	 * @param[in]  pixelCount     The number of pixels to process
+	 * @param[in]  interpolation  The interpolation method
+	 * @param[in]  pixelStride    The number of floats from one pixel to the
+	 *                            next, 3 for RGB and 4 for RGBA
+	 */
+	void apply(const float * input, float * output, std::size_t pixelCount,
+	           LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral,
+	           std::size_t pixelStride = 3) const;
+
+	/**
+	 * @brief      Creates a copy of the LUT with a different lattice size, e.g.
+	 *             to fit a device that caps the cube size.
+	 * @discussion Trilinear and cubic resampling are separable and run as one
+	 *             pass per axis; tetrahedral resampling evaluates every new
+	 *             point. Either way the work is split over
+	 *             `LUTHelper::concurrency()` threads. Cubic resampling passes
+	 *             through every lattice point and reproduces linear ramps,
+	 *             extrapolating one point linearly beyond each edge; it can
+	 *             overshoot the lattice's range near sharp transitions. The
+	 *             input bounds are kept.
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`
+	 *
+	 * @param[in]  size    The edge length of the new lattice
+	 * @param[in]  method  The resampling method
+	 *
+	 * @return     The resampled LUT
+	 */
+	BasicLUT3D resampledToSize(int size, LUT3DResampling method = LUT3DResampling::Tetrahedral) const;
+
+	PointReference operator()(int r, int g, int b) { return PointReference(*this, indexOfPoint(r, g, b)); }
+	Color operator()(int r, int g, int b) const { return colorAtPoint(r, g, b); }
+};
+
+extern template class BasicLUT3D<float>;
+extern template class BasicLUT3D<double>;
+extern template class BasicLUT3D<LUTHalf>;
+
+/** @brief      A 3D LUT with a double precision lattice */
+typedef BasicLUT3D<LUTColorValue> LUT3D;
+
+/** @brief      A 3D LUT with a single precision lattice */
+typedef BasicLUT3D<float> LUT3Df;
+
+/** @brief      A 3D LUT with a half precision lattice */
+typedef BasicLUT3D<LUTHalf> LUT3Dh;
+
+}
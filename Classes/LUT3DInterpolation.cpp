@@ -0,0 +1,477 @@
+#include "LUT3D.h"
+#include "LUTSIMD.h"
+#include "LUTSIMDGather.h"
+
+using namespace CppLUT;
+using namespace CppLUT::LUTSIMD;
+
+namespace
+{
+
+/**
+ * @brief      Everything a kernel needs to turn an input value into a
+ *             lattice coordinate and to address the planes.
+ */
+template <typename T>
+struct LatticeAccess
+{
+	const T * red;
+	const T * green;
+	const T * blue;
+	/** @brief      Multiplier taking an input value to a lattice coordinate */
+	double scale;
+	/** @brief      Offset taking an input value to a lattice coordinate */
+	double offset;
+	/** @brief      The highest lattice coordinate, size - 1 */
+	double maxCoordinate;
+	/** @brief      The highest base index of an interpolation cell, size - 2 */
+	int maxBase;
+	/** @brief      The plane offset of one step along green */
+	int strideG;
+	/** @brief      The plane offset of one step along blue */
+	int strideB;
+};
+
+template <typename T>
+LatticeAccess<T> latticeAccess(const T * red, const T * green, const T * blue, int size,
+                               double inputLowerBound, double inputUpperBound)
+{
+	LatticeAccess<T> access;
+	access.red = red;
+	access.green = green;
+	access.blue = blue;
+	access.scale = (size - 1) / (inputUpperBound - inputLowerBound);
+	access.offset = -inputLowerBound * access.scale;
+	access.maxCoordinate = size - 1;
+	access.maxBase = size - 2;
+	access.strideG = size;
+	access.strideB = size * size;
+	return access;
+}
+
+/**
+ * @brief      Splits an input value into the base index of its interpolation
+ *             cell and the fractional position inside it. Out of range and
+ *             NaN inputs land on the nearest edge.
+ */
+template <typename T, typename C>
+inline void locate(const LatticeAccess<T> & access, C value, int & base, C & fraction)
+{
+	const C maxCoordinate = (C)access.maxCoordinate;
+	C coordinate = value * (C)access.scale + (C)access.offset;
+	coordinate = (coordinate > 0) ? coordinate : 0;
+	coordinate = (coordinate < maxCoordinate) ? coordinate : maxCoordinate;
+	base = (int)coordinate;
+	base = (base < access.maxBase) ? base : access.maxBase;
+	fraction = coordinate - base;
+}
+
+template <typename T, typename C>
+inline void trilinearScalar(const LatticeAccess<T> & access, const C * in, C * out)
+{
+	int ir, ig, ib;
+	C fr, fg, fb;
+	locate(access, in[0], ir, fr);
+	locate(access, in[1], ig, fg);
+	locate(access, in[2], ib, fb);
+
+	const int sG = access.strideG;
+	const int sB = access.strideB;
+	const int i000 = ir + ig * sG + ib * sB;
+	const T * planes[3] = { access.red, access.green, access.blue };
+	for (int c = 0; c < 3; c++)
+	{
+		const T * p = planes[c] + i000;
+		C c00 = (C)p[0] + fr * ((C)p[1] - (C)p[0]);
+		C c10 = (C)p[sG] + fr * ((C)p[sG + 1] - (C)p[sG]);
+		C c01 = (C)p[sB] + fr * ((C)p[sB + 1] - (C)p[sB]);
+		C c11 = (C)p[sB + sG] + fr * ((C)p[sB + sG + 1] - (C)p[sB + sG]);
+		C c0 = c00 + fg * (c10 - c00);
+		C c1 = c01 + fg * (c11 - c01);
+		out[c] = c0 + fb * (c1 - c0);
+	}
+}
+
+/**
+ * @brief      Tetrahedral interpolation written as a walk from the (0,0,0)
+ *             corner to the (1,1,1) corner of the cell, first along the axis
+ *             with the largest fraction, then the middle, then the smallest.
+ *             The vector kernels select the same axes with masks.
+ */
+template <typename T, typename C>
+inline void tetrahedralScalar(const LatticeAccess<T> & access, const C * in, C * out)
+{
+	int ir, ig, ib;
+	C fr, fg, fb;
+	locate(access, in[0], ir, fr);
+	locate(access, in[1], ig, fg);
+	locate(access, in[2], ib, fb);
+
+	const int sG = access.strideG;
+	const int sB = access.strideB;
+	const bool rgt = fr > fg;
+	const bool gbt = fg > fb;
+	const bool rbt = fr > fb;
+
+	C wMax, wMin;
+	int offsetMax, offsetMin;
+	if (rgt && rbt) { wMax = fr; offsetMax = 1; }
+	else if (!rgt && gbt) { wMax = fg; offsetMax = sG; }
+	else { wMax = fb; offsetMax = sB; }
+	if (!rgt && !rbt) { wMin = fr; offsetMin = 1; }
+	else if (rgt && !gbt) { wMin = fg; offsetMin = sG; }
+	else { wMin = fb; offsetMin = sB; }
+	const C wMid = fr + fg + fb - wMax - wMin;
+
+	const int i000 = ir + ig * sG + ib * sB;
+	const int iA = i000 + offsetMax;
+	const int iB = i000 + 1 + sG + sB - offsetMin;
+	const int i111 = i000 + 1 + sG + sB;
+	const T * planes[3] = { access.red, access.green, access.blue };
+	for (int c = 0; c < 3; c++)
+	{
+		const T * p = planes[c];
+		C c000 = (C)p[i000];
+		C cA = (C)p[iA];
+		C cB = (C)p[iB];
+		C c111 = (C)p[i111];
+		out[c] = c000 + wMax * (cA - c000) + wMid * (cB - cA) + wMin * (c111 - cB);
+	}
+}
+
+template <typename T, bool Tetrahedral>
+void applyScalar(const LatticeAccess<T> & access, const float * input, float * output,
+                 std::size_t pixelCount, std::size_t pixelStride)
+{
+	for (std::size_t p = 0; p < pixelCount; p++)
+	{
+		float pixel[3];
+		if (Tetrahedral)
+		{
+			tetrahedralScalar(access, input + p * pixelStride, pixel);
+		}
+		else
+		{
+			trilinearScalar(access, input + p * pixelStride, pixel);
+		}
+		float * out = output + p * pixelStride;
+		out[0] = pixel[0];
+		out[1] = pixel[1];
+		out[2] = pixel[2];
+	}
+}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+template <typename T>
+CPPLUT_TARGET_AVX2 inline void locateAVX2(const LatticeAccess<T> & access, __m256 value, __m256i & base, __m256 & fraction)
+{
+	__m256 coordinate = _mm256_fmadd_ps(value, _mm256_set1_ps((float)access.scale), _mm256_set1_ps((float)access.offset));
+	// max_ps returns its second operand when the first is NaN
+	coordinate = _mm256_max_ps(coordinate, _mm256_setzero_ps());
+	coordinate = _mm256_min_ps(coordinate, _mm256_set1_ps((float)access.maxCoordinate));
+	base = _mm256_min_epi32(_mm256_cvttps_epi32(coordinate), _mm256_set1_epi32(access.maxBase));
+	fraction = _mm256_sub_ps(coordinate, _mm256_cvtepi32_ps(base));
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX2 inline __m256 lerpCornersAVX2(const T * plane, __m256i i000, int sG, int sB,
+                                                 __m256 fr, __m256 fg, __m256 fb)
+{
+	const __m256i one = _mm256_set1_epi32(1);
+	__m256i i010 = _mm256_add_epi32(i000, _mm256_set1_epi32(sG));
+	__m256i i001 = _mm256_add_epi32(i000, _mm256_set1_epi32(sB));
+	__m256i i011 = _mm256_add_epi32(i010, _mm256_set1_epi32(sB));
+
+	__m256 c000 = gatherAVX2(plane, i000);
+	__m256 c100 = gatherAVX2(plane, _mm256_add_epi32(i000, one));
+	__m256 c010 = gatherAVX2(plane, i010);
+	__m256 c110 = gatherAVX2(plane, _mm256_add_epi32(i010, one));
+	__m256 c001 = gatherAVX2(plane, i001);
+	__m256 c101 = gatherAVX2(plane, _mm256_add_epi32(i001, one));
+	__m256 c011 = gatherAVX2(plane, i011);
+	__m256 c111 = gatherAVX2(plane, _mm256_add_epi32(i011, one));
+
+	__m256 c00 = _mm256_fmadd_ps(fr, _mm256_sub_ps(c100, c000), c000);
+	__m256 c10 = _mm256_fmadd_ps(fr, _mm256_sub_ps(c110, c010), c010);
+	__m256 c01 = _mm256_fmadd_ps(fr, _mm256_sub_ps(c101, c001), c001);
+	__m256 c11 = _mm256_fmadd_ps(fr, _mm256_sub_ps(c111, c011), c011);
+	__m256 c0 = _mm256_fmadd_ps(fg, _mm256_sub_ps(c10, c00), c00);
+	__m256 c1 = _mm256_fmadd_ps(fg, _mm256_sub_ps(c11, c01), c01);
+	return _mm256_fmadd_ps(fb, _mm256_sub_ps(c1, c0), c0);
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX2 inline __m256 walkTetrahedronAVX2(const T * plane, __m256i i000, __m256i iA, __m256i iB, __m256i i111,
+                                                     __m256 wMax, __m256 wMid, __m256 wMin)
+{
+	__m256 c000 = gatherAVX2(plane, i000);
+	__m256 cA = gatherAVX2(plane, iA);
+	__m256 cB = gatherAVX2(plane, iB);
+	__m256 c111 = gatherAVX2(plane, i111);
+	__m256 result = _mm256_fmadd_ps(wMax, _mm256_sub_ps(cA, c000), c000);
+	result = _mm256_fmadd_ps(wMid, _mm256_sub_ps(cB, cA), result);
+	return _mm256_fmadd_ps(wMin, _mm256_sub_ps(c111, cB), result);
+}
+
+template <typename T, bool Tetrahedral>
+CPPLUT_TARGET_AVX2 void applyAVX2(const LatticeAccess<T> & access, const float * input, float * output,
+                                  std::size_t pixelCount, std::size_t pixelStride)
+{
+	const int sG = access.strideG;
+	const int sB = access.strideB;
+	const __m256i laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+	                                               _mm256_set1_epi32((int)pixelStride));
+	std::size_t p = 0;
+	for (; p + 8 <= pixelCount; p += 8)
+	{
+		const float * in = input + p * pixelStride;
+		__m256 r = _mm256_i32gather_ps(in, laneOffsets, 4);
+		__m256 g = _mm256_i32gather_ps(in + 1, laneOffsets, 4);
+		__m256 b = _mm256_i32gather_ps(in + 2, laneOffsets, 4);
+
+		__m256i ir, ig, ib;
+		__m256 fr, fg, fb;
+		locateAVX2(access, r, ir, fr);
+		locateAVX2(access, g, ig, fg);
+		locateAVX2(access, b, ib, fb);
+		__m256i i000 = _mm256_add_epi32(ir, _mm256_add_epi32(_mm256_mullo_epi32(ig, _mm256_set1_epi32(sG)),
+		                                                     _mm256_mullo_epi32(ib, _mm256_set1_epi32(sB))));
+
+		__m256 result[3];
+		if (Tetrahedral)
+		{
+			__m256 rgt = _mm256_cmp_ps(fr, fg, _CMP_GT_OQ);
+			__m256 gbt = _mm256_cmp_ps(fg, fb, _CMP_GT_OQ);
+			__m256 rbt = _mm256_cmp_ps(fr, fb, _CMP_GT_OQ);
+			__m256 maxIsR = _mm256_and_ps(rgt, rbt);
+			__m256 maxIsG = _mm256_andnot_ps(rgt, gbt);
+			__m256 minIsR = _mm256_andnot_ps(rgt, _mm256_andnot_ps(rbt, _mm256_castsi256_ps(_mm256_set1_epi32(-1))));
+			__m256 minIsG = _mm256_andnot_ps(gbt, rgt);
+
+			__m256 wMax = _mm256_blendv_ps(_mm256_blendv_ps(fb, fg, maxIsG), fr, maxIsR);
+			__m256 wMin = _mm256_blendv_ps(_mm256_blendv_ps(fb, fg, minIsG), fr, minIsR);
+			__m256 wMid = _mm256_sub_ps(_mm256_add_ps(fr, _mm256_add_ps(fg, fb)), _mm256_add_ps(wMax, wMin));
+
+			const __m256i stepR = _mm256_set1_epi32(1);
+			const __m256i stepG = _mm256_set1_epi32(sG);
+			const __m256i stepB = _mm256_set1_epi32(sB);
+			__m256i offsetMax = _mm256_blendv_epi8(_mm256_blendv_epi8(stepB, stepG, _mm256_castps_si256(maxIsG)),
+			                                       stepR, _mm256_castps_si256(maxIsR));
+			__m256i offsetMin = _mm256_blendv_epi8(_mm256_blendv_epi8(stepB, stepG, _mm256_castps_si256(minIsG)),
+			                                       stepR, _mm256_castps_si256(minIsR));
+			__m256i i111 = _mm256_add_epi32(i000, _mm256_set1_epi32(1 + sG + sB));
+			__m256i iA = _mm256_add_epi32(i000, offsetMax);
+			__m256i iB = _mm256_sub_epi32(i111, offsetMin);
+
+			result[0] = walkTetrahedronAVX2(access.red, i000, iA, iB, i111, wMax, wMid, wMin);
+			result[1] = walkTetrahedronAVX2(access.green, i000, iA, iB, i111, wMax, wMid, wMin);
+			result[2] = walkTetrahedronAVX2(access.blue, i000, iA, iB, i111, wMax, wMid, wMin);
+		}
+		else
+		{
+			result[0] = lerpCornersAVX2(access.red, i000, sG, sB, fr, fg, fb);
+			result[1] = lerpCornersAVX2(access.green, i000, sG, sB, fr, fg, fb);
+			result[2] = lerpCornersAVX2(access.blue, i000, sG, sB, fr, fg, fb);
+		}
+
+		alignas(32) float lanes[3][8];
+		_mm256_store_ps(lanes[0], result[0]);
+		_mm256_store_ps(lanes[1], result[1]);
+		_mm256_store_ps(lanes[2], result[2]);
+		float * out = output + p * pixelStride;
+		for (int lane = 0; lane < 8; lane++, out += pixelStride)
+		{
+			out[0] = lanes[0][lane];
+			out[1] = lanes[1][lane];
+			out[2] = lanes[2][lane];
+		}
+	}
+	applyScalar<T, Tetrahedral>(access, input + p * pixelStride, output + p * pixelStride, pixelCount - p, pixelStride);
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX512 inline void locateAVX512(const LatticeAccess<T> & access, __m512 value, __m512i & base, __m512 & fraction)
+{
+	__m512 coordinate = _mm512_fmadd_ps(value, _mm512_set1_ps((float)access.scale), _mm512_set1_ps((float)access.offset));
+	coordinate = _mm512_max_ps(coordinate, _mm512_setzero_ps());
+	coordinate = _mm512_min_ps(coordinate, _mm512_set1_ps((float)access.maxCoordinate));
+	base = _mm512_min_epi32(_mm512_cvttps_epi32(coordinate), _mm512_set1_epi32(access.maxBase));
+	fraction = _mm512_sub_ps(coordinate, _mm512_cvtepi32_ps(base));
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX512 inline __m512 lerpCornersAVX512(const T * plane, __m512i i000, int sG, int sB,
+                                                     __m512 fr, __m512 fg, __m512 fb)
+{
+	const __m512i one = _mm512_set1_epi32(1);
+	__m512i i010 = _mm512_add_epi32(i000, _mm512_set1_epi32(sG));
+	__m512i i001 = _mm512_add_epi32(i000, _mm512_set1_epi32(sB));
+	__m512i i011 = _mm512_add_epi32(i010, _mm512_set1_epi32(sB));
+
+	__m512 c000 = gatherAVX512(plane, i000);
+	__m512 c100 = gatherAVX512(plane, _mm512_add_epi32(i000, one));
+	__m512 c010 = gatherAVX512(plane, i010);
+	__m512 c110 = gatherAVX512(plane, _mm512_add_epi32(i010, one));
+	__m512 c001 = gatherAVX512(plane, i001);
+	__m512 c101 = gatherAVX512(plane, _mm512_add_epi32(i001, one));
+	__m512 c011 = gatherAVX512(plane, i011);
+	__m512 c111 = gatherAVX512(plane, _mm512_add_epi32(i011, one));
+
+	__m512 c00 = _mm512_fmadd_ps(fr, _mm512_sub_ps(c100, c000), c000);
+	__m512 c10 = _mm512_fmadd_ps(fr, _mm512_sub_ps(c110, c010), c010);
+	__m512 c01 = _mm512_fmadd_ps(fr, _mm512_sub_ps(c101, c001), c001);
+	__m512 c11 = _mm512_fmadd_ps(fr, _mm512_sub_ps(c111, c011), c011);
+	__m512 c0 = _mm512_fmadd_ps(fg, _mm512_sub_ps(c10, c00), c00);
+	__m512 c1 = _mm512_fmadd_ps(fg, _mm512_sub_ps(c11, c01), c01);
+	return _mm512_fmadd_ps(fb, _mm512_sub_ps(c1, c0), c0);
+}
+
+template <typename T>
+CPPLUT_TARGET_AVX512 inline __m512 walkTetrahedronAVX512(const T * plane, __m512i i000, __m512i iA, __m512i iB, __m512i i111,
+                                                         __m512 wMax, __m512 wMid, __m512 wMin)
+{
+	__m512 c000 = gatherAVX512(plane, i000);
+	__m512 cA = gatherAVX512(plane, iA);
+	__m512 cB = gatherAVX512(plane, iB);
+	__m512 c111 = gatherAVX512(plane, i111);
+	__m512 result = _mm512_fmadd_ps(wMax, _mm512_sub_ps(cA, c000), c000);
+	result = _mm512_fmadd_ps(wMid, _mm512_sub_ps(cB, cA), result);
+	return _mm512_fmadd_ps(wMin, _mm512_sub_ps(c111, cB), result);
+}
+
+template <typename T, bool Tetrahedral>
+CPPLUT_TARGET_AVX512 void applyAVX512(const LatticeAccess<T> & access, const float * input, float * output,
+                                      std::size_t pixelCount, std::size_t pixelStride)
+{
+	const int sG = access.strideG;
+	const int sB = access.strideB;
+	const __m512i laneOffsets = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+	                                               _mm512_set1_epi32((int)pixelStride));
+	std::size_t p = 0;
+	for (; p + 16 <= pixelCount; p += 16)
+	{
+		const float * in = input + p * pixelStride;
+		__m512 r = _mm512_i32gather_ps(laneOffsets, in, 4);
+		__m512 g = _mm512_i32gather_ps(laneOffsets, in + 1, 4);
+		__m512 b = _mm512_i32gather_ps(laneOffsets, in + 2, 4);
+
+		__m512i ir, ig, ib;
+		__m512 fr, fg, fb;
+		locateAVX512(access, r, ir, fr);
+		locateAVX512(access, g, ig, fg);
+		locateAVX512(access, b, ib, fb);
+		__m512i i000 = _mm512_add_epi32(ir, _mm512_add_epi32(_mm512_mullo_epi32(ig, _mm512_set1_epi32(sG)),
+		                                                     _mm512_mullo_epi32(ib, _mm512_set1_epi32(sB))));
+
+		__m512 result[3];
+		if (Tetrahedral)
+		{
+			__mmask16 rgt = _mm512_cmp_ps_mask(fr, fg, _CMP_GT_OQ);
+			__mmask16 gbt = _mm512_cmp_ps_mask(fg, fb, _CMP_GT_OQ);
+			__mmask16 rbt = _mm512_cmp_ps_mask(fr, fb, _CMP_GT_OQ);
+			__mmask16 maxIsR = rgt & rbt;
+			__mmask16 maxIsG = ~rgt & gbt;
+			__mmask16 minIsR = ~rgt & ~rbt;
+			__mmask16 minIsG = rgt & ~gbt;
+
+			__m512 wMax = _mm512_mask_blend_ps(maxIsR, _mm512_mask_blend_ps(maxIsG, fb, fg), fr);
+			__m512 wMin = _mm512_mask_blend_ps(minIsR, _mm512_mask_blend_ps(minIsG, fb, fg), fr);
+			__m512 wMid = _mm512_sub_ps(_mm512_add_ps(fr, _mm512_add_ps(fg, fb)), _mm512_add_ps(wMax, wMin));
+
+			const __m512i stepR = _mm512_set1_epi32(1);
+			const __m512i stepG = _mm512_set1_epi32(sG);
+			const __m512i stepB = _mm512_set1_epi32(sB);
+			__m512i offsetMax = _mm512_mask_blend_epi32(maxIsR, _mm512_mask_blend_epi32(maxIsG, stepB, stepG), stepR);
+			__m512i offsetMin = _mm512_mask_blend_epi32(minIsR, _mm512_mask_blend_epi32(minIsG, stepB, stepG), stepR);
+			__m512i i111 = _mm512_add_epi32(i000, _mm512_set1_epi32(1 + sG + sB));
+			__m512i iA = _mm512_add_epi32(i000, offsetMax);
+			__m512i iB = _mm512_sub_epi32(i111, offsetMin);
+
+			result[0] = walkTetrahedronAVX512(access.red, i000, iA, iB, i111, wMax, wMid, wMin);
+			result[1] = walkTetrahedronAVX512(access.green, i000, iA, iB, i111, wMax, wMid, wMin);
+			result[2] = walkTetrahedronAVX512(access.blue, i000, iA, iB, i111, wMax, wMid, wMin);
+		}
+		else
+		{
+			result[0] = lerpCornersAVX512(access.red, i000, sG, sB, fr, fg, fb);
+			result[1] = lerpCornersAVX512(access.green, i000, sG, sB, fr, fg, fb);
+			result[2] = lerpCornersAVX512(access.blue, i000, sG, sB, fr, fg, fb);
+		}
+
+		float * out = output + p * pixelStride;
+		_mm512_i32scatter_ps(out, laneOffsets, result[0], 4);
+		_mm512_i32scatter_ps(out + 1, laneOffsets, result[1], 4);
+		_mm512_i32scatter_ps(out + 2, laneOffsets, result[2], 4);
+	}
+	applyScalar<T, Tetrahedral>(access, input + p * pixelStride, output + p * pixelStride, pixelCount - p, pixelStride);
+}
+
+#endif
+
+template <typename T, bool Tetrahedral>
+void applyDispatch(const LatticeAccess<T> & access, const float * input, float * output,
+                   std::size_t pixelCount, std::size_t pixelStride)
+{
+#if defined(CPPLUT_X86_DISPATCH)
+	switch (LUTSIMD::activeLevel())
+	{
+		case LUTSIMD::AVX512:
+			applyAVX512<T, Tetrahedral>(access, input, output, pixelCount, pixelStride);
+			return;
+		case LUTSIMD::AVX2:
+			applyAVX2<T, Tetrahedral>(access, input, output, pixelCount, pixelStride);
+			return;
+		default:
+			break;
+	}
+#endif
+	applyScalar<T, Tetrahedral>(access, input, output, pixelCount, pixelStride);
+}
+
+}
+
+template <typename T>
+void BasicLUT3D<T>::apply(const float * input, float * output, std::size_t pixelCount,
+                          LUT3DInterpolation interpolation, std::size_t pixelStride) const
+{
+	LatticeAccess<T> access = latticeAccess(redPlane(), greenPlane(), bluePlane(), size,
+	                                        inputLowerBound, inputUpperBound);
+	if (interpolation == LUT3DInterpolation::Tetrahedral)
+	{
+		applyDispatch<T, true>(access, input, output, pixelCount, pixelStride);
+	}
+	else
+	{
+		applyDispatch<T, false>(access, input, output, pixelCount, pixelStride);
+	}
+}
+
+template <typename T>
+typename BasicLUT3D<T>::Color BasicLUT3D<T>::colorAtColor(const Color & color, LUT3DInterpolation interpolation) const
+{
+	typedef typename Color::ComputeType C;
+	const C input[3] = { color.getR(), color.getG(), color.getB() };
+	C output[3];
+	LatticeAccess<T> access = latticeAccess(redPlane(), greenPlane(), bluePlane(), size,
+	                                        inputLowerBound, inputUpperBound);
+	if (interpolation == LUT3DInterpolation::Tetrahedral)
+	{
+		tetrahedralScalar(access, input, output);
+	}
+	else
+	{
+		trilinearScalar(access, input, output);
+	}
+	return Color::colorWithRGB((T)output[0], (T)output[1], (T)output[2]);
+}
+
+namespace CppLUT
+{
+template void BasicLUT3D<float>::apply(const float *, float *, std::size_t, LUT3DInterpolation, std::size_t) const;
+template void BasicLUT3D<double>::apply(const float *, float *, std::size_t, LUT3DInterpolation, std::size_t) const;
+template void BasicLUT3D<LUTHalf>::apply(const float *, float *, std::size_t, LUT3DInterpolation, std::size_t) const;
+template LUTColorf BasicLUT3D<float>::colorAtColor(const LUTColorf &, LUT3DInterpolation) const;
+template LUTColor BasicLUT3D<double>::colorAtColor(const LUTColor &, LUT3DInterpolation) const;
+template LUTColorh BasicLUT3D<LUTHalf>::colorAtColor(const LUTColorh &, LUT3DInterpolation) const;
+}
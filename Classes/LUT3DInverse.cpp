@@ -0,0 +1,463 @@
+#include "LUT3DInverse.h"
+#include "LUTHelper.h"
+#include "LUTMatrix3.h"
+
+#include <cmath> // std::fabs std::floor std::isfinite
+#include <limits> // std::numeric_limits
+#include <mutex> // std::mutex std::lock_guard
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+/** @brief      The most times a Newton step is halved before the point is left where it is */
+const int maximumStepHalvings = 8;
+
+/**
+ * @brief      Evaluates a forward LUT3D in double precision together with its
+ *             Jacobian. Both interpolation methods are linear inside a
+ *             lattice cell (or tetrahedron), so the Jacobian is exact there.
+ */
+template <typename T>
+class ForwardModel
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+
+	const T * planes[3];
+	int size;
+	double inputLowerBound;
+	double inputUpperBound;
+	/** @brief      Lattice coordinates per unit of input */
+	double scale;
+	std::size_t strides[3];
+	LUT3DInterpolation interpolation;
+
+	double value(int c, std::size_t index) const { return (double)(C)planes[c][index]; }
+
+	/** @brief      Splits an input into a cell base and fraction, clamped to the lattice */
+	void locate(double input, int & base, double & fraction) const
+	{
+		double coordinate = (input - inputLowerBound) * scale;
+		coordinate = (coordinate > 0) ? coordinate : 0;
+		coordinate = (coordinate < size - 1) ? coordinate : size - 1;
+		base = (int)coordinate;
+		base = (base < size - 2) ? base : size - 2;
+		fraction = coordinate - base;
+	}
+
+public:
+	ForwardModel(const BasicLUT3D<T> & lut, LUT3DInterpolation interpolation):
+		size(lut.getSize()),
+		inputLowerBound(lut.getInputLowerBound()),
+		inputUpperBound(lut.getInputUpperBound()),
+		scale((lut.getSize() - 1) / (lut.getInputUpperBound() - lut.getInputLowerBound())),
+		interpolation(interpolation)
+	{
+		planes[0] = lut.redPlane();
+		planes[1] = lut.greenPlane();
+		planes[2] = lut.bluePlane();
+		strides[0] = 1;
+		strides[1] = (std::size_t)size;
+		strides[2] = (std::size_t)size * size;
+	}
+
+	double clampInput(double input) const
+	{
+		return (input > inputLowerBound) ? ((input < inputUpperBound) ? input : inputUpperBound) : inputLowerBound;
+	}
+
+	/**
+	 * @brief      The output for an input, and the row-major derivative of
+	 *             each output channel (rows) by each input channel (columns)
+	 */
+	void evaluate(const double input[3], double output[3], double jacobian[9]) const
+	{
+		int base[3];
+		double f[3];
+		for (int c = 0; c < 3; c++)
+		{
+			locate(input[c], base[c], f[c]);
+		}
+		const std::size_t i000 = base[0] * strides[0] + base[1] * strides[1] + base[2] * strides[2];
+
+		if (interpolation == LUT3DInterpolation::Trilinear)
+		{
+			const std::size_t sG = strides[1];
+			const std::size_t sB = strides[2];
+			for (int c = 0; c < 3; c++)
+			{
+				const double p000 = value(c, i000), p100 = value(c, i000 + 1);
+				const double p010 = value(c, i000 + sG), p110 = value(c, i000 + sG + 1);
+				const double p001 = value(c, i000 + sB), p101 = value(c, i000 + sB + 1);
+				const double p011 = value(c, i000 + sB + sG), p111 = value(c, i000 + sB + sG + 1);
+				const double c00 = p000 + f[0] * (p100 - p000);
+				const double c10 = p010 + f[0] * (p110 - p010);
+				const double c01 = p001 + f[0] * (p101 - p001);
+				const double c11 = p011 + f[0] * (p111 - p011);
+				const double c0 = c00 + f[1] * (c10 - c00);
+				const double c1 = c01 + f[1] * (c11 - c01);
+				output[c] = c0 + f[2] * (c1 - c0);
+
+				const double d0 = (p100 - p000) + f[1] * ((p110 - p010) - (p100 - p000));
+				const double d1 = (p101 - p001) + f[1] * ((p111 - p011) - (p101 - p001));
+				jacobian[c * 3 + 0] = (d0 + f[2] * (d1 - d0)) * scale;
+				jacobian[c * 3 + 1] = ((c10 - c00) + f[2] * ((c11 - c01) - (c10 - c00))) * scale;
+				jacobian[c * 3 + 2] = (c1 - c0) * scale;
+			}
+			return;
+		}
+
+		// the same choice of tetrahedron as the LUT3D kernels: walk from the
+		// (0,0,0) corner along the axes in decreasing order of their fraction
+		const bool rgt = f[0] > f[1];
+		const bool gbt = f[1] > f[2];
+		const bool rbt = f[0] > f[2];
+		int axisMax, axisMin;
+		if (rgt && rbt) { axisMax = 0; }
+		else if (!rgt && gbt) { axisMax = 1; }
+		else { axisMax = 2; }
+		if (!rgt && !rbt) { axisMin = 0; }
+		else if (rgt && !gbt) { axisMin = 1; }
+		else { axisMin = 2; }
+		const int axisMid = 3 - axisMax - axisMin;
+
+		const std::size_t iA = i000 + strides[axisMax];
+		const std::size_t iB = iA + strides[axisMid];
+		const std::size_t i111 = iB + strides[axisMin];
+		for (int c = 0; c < 3; c++)
+		{
+			const double c000 = value(c, i000);
+			const double cA = value(c, iA);
+			const double cB = value(c, iB);
+			const double c111 = value(c, i111);
+			output[c] = c000 + f[axisMax] * (cA - c000) + f[axisMid] * (cB - cA) + f[axisMin] * (c111 - cB);
+			jacobian[c * 3 + axisMax] = (cA - c000) * scale;
+			jacobian[c * 3 + axisMid] = (cB - cA) * scale;
+			jacobian[c * 3 + axisMin] = (c111 - cB) * scale;
+		}
+	}
+};
+
+/**
+ * @brief      Solves `jacobian * step = -residual`. Near singular Jacobians,
+ *             e.g. where the forward LUT clips, are solved in the least
+ *             squares sense with Levenberg-Marquardt damping instead.
+ */
+void newtonStep(const double jacobian[9], const double residual[3], double step[3])
+{
+	const LUTMatrix3 j = LUTMatrix3::withRows(jacobian[0], jacobian[1], jacobian[2],
+	                                          jacobian[3], jacobian[4], jacobian[5],
+	                                          jacobian[6], jacobian[7], jacobian[8]);
+	double scale = 0;
+	for (int i = 0; i < 9; i++)
+	{
+		scale = (std::fabs(jacobian[i]) > scale) ? std::fabs(jacobian[i]) : scale;
+	}
+	const double negative[3] = { -residual[0], -residual[1], -residual[2] };
+	if (std::fabs(j.determinant()) > 1e-9 * scale * scale * scale)
+	{
+		j.inverse().apply(negative, step);
+		return;
+	}
+
+	// (J^T J + lambda I) step = J^T (-residual)
+	double normal[9];
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			normal[r * 3 + c] = jacobian[r] * jacobian[c] + jacobian[3 + r] * jacobian[3 + c] + jacobian[6 + r] * jacobian[6 + c];
+		}
+	}
+	const double lambda = 1e-3 * (normal[0] + normal[4] + normal[8]) + 1e-12;
+	const LUTMatrix3 damped = LUTMatrix3::withRows(normal[0] + lambda, normal[1], normal[2],
+	                                               normal[3], normal[4] + lambda, normal[5],
+	                                               normal[6], normal[7], normal[8] + lambda);
+	double gradient[3];
+	for (int c = 0; c < 3; c++)
+	{
+		gradient[c] = jacobian[c] * negative[0] + jacobian[3 + c] * negative[1] + jacobian[6 + c] * negative[2];
+	}
+	damped.inverse().apply(gradient, step);
+}
+
+double squaredNorm(const double v[3])
+{
+	return v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+}
+
+double largestMagnitude(const double v[3])
+{
+	double largest = std::fabs(v[0]);
+	largest = (std::fabs(v[1]) > largest) ? std::fabs(v[1]) : largest;
+	return (std::fabs(v[2]) > largest) ? std::fabs(v[2]) : largest;
+}
+
+/**
+ * @brief      Refines `input` until the forward output is within `tolerance`
+ *             of `target`, and returns the remaining per-channel error
+ */
+template <typename T>
+double solve(const ForwardModel<T> & model, const double target[3], double input[3],
+             double tolerance, int maximumIterations)
+{
+	double output[3], jacobian[9], residual[3];
+	model.evaluate(input, output, jacobian);
+	for (int c = 0; c < 3; c++)
+	{
+		residual[c] = output[c] - target[c];
+	}
+	double error = largestMagnitude(residual);
+	double norm = squaredNorm(residual);
+
+	for (int iteration = 0; iteration < maximumIterations && error > tolerance; iteration++)
+	{
+		double step[3];
+		newtonStep(jacobian, residual, step);
+
+		// backtrack until the step reduces the residual
+		bool improved = false;
+		double fraction = 1;
+		for (int halving = 0; halving <= maximumStepHalvings && !improved; halving++, fraction *= 0.5)
+		{
+			double candidate[3], candidateOutput[3], candidateJacobian[9], candidateResidual[3];
+			for (int c = 0; c < 3; c++)
+			{
+				candidate[c] = model.clampInput(input[c] + fraction * step[c]);
+			}
+			model.evaluate(candidate, candidateOutput, candidateJacobian);
+			for (int c = 0; c < 3; c++)
+			{
+				candidateResidual[c] = candidateOutput[c] - target[c];
+			}
+			const double candidateNorm = squaredNorm(candidateResidual);
+			if (candidateNorm < norm)
+			{
+				improved = true;
+				norm = candidateNorm;
+				error = largestMagnitude(candidateResidual);
+				for (int c = 0; c < 3; c++)
+				{
+					input[c] = candidate[c];
+					residual[c] = candidateResidual[c];
+				}
+				for (int i = 0; i < 9; i++)
+				{
+					jacobian[i] = candidateJacobian[i];
+				}
+			}
+		}
+		if (!improved)
+		{
+			// the closest reachable input, e.g. for a target outside the forward gamut
+			break;
+		}
+	}
+	return error;
+}
+
+/**
+ * @brief      Seeds every inverse lattice point with the input of the forward
+ *             lattice point whose output lands nearest to it, then spreads
+ *             seeds into the inverse points no forward output reached.
+ *
+ * @return     Three planes of inputs in the inverse lattice order
+ */
+template <typename T>
+std::vector<double> scatterSeeds(const BasicLUT3D<T> & lut, int size)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	const std::size_t pointCount = (std::size_t)size * size * size;
+	const double lower = lut.getInputLowerBound();
+	const double upper = lut.getInputUpperBound();
+	const double inverseScale = (size - 1) / (upper - lower);
+	const double inverseStep = (upper - lower) / (size - 1);
+	const double forwardStep = (upper - lower) / (lut.getSize() - 1);
+
+	std::vector<double> seeds(3 * pointCount);
+	std::vector<double> distances(pointCount, std::numeric_limits<double>::infinity());
+	const T * forward[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+	const int forwardSize = lut.getSize();
+	for (int b = 0; b < forwardSize; b++)
+	{
+		for (int g = 0; g < forwardSize; g++)
+		{
+			for (int r = 0; r < forwardSize; r++)
+			{
+				const std::size_t forwardIndex = lut.indexOfPoint(r, g, b);
+				std::size_t node = 0;
+				std::size_t nodeStride = 1;
+				double distance = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					const double output = (double)(C)forward[c][forwardIndex];
+					double coordinate = std::floor((output - lower) * inverseScale + 0.5);
+					coordinate = (coordinate > 0) ? ((coordinate < size - 1) ? coordinate : size - 1) : 0;
+					const double difference = output - (lower + coordinate * inverseStep);
+					distance += difference * difference;
+					node += (std::size_t)coordinate * nodeStride;
+					nodeStride *= size;
+				}
+				if (distance < distances[node])
+				{
+					distances[node] = distance;
+					seeds[node] = lower + r * forwardStep;
+					seeds[pointCount + node] = lower + g * forwardStep;
+					seeds[2 * pointCount + node] = lower + b * forwardStep;
+				}
+			}
+		}
+	}
+
+	// grow the seeded region one lattice step per pass, reading only points
+	// seeded in earlier passes so the result does not depend on threading
+	std::vector<unsigned char> seeded(pointCount);
+	std::size_t unseededCount = 0;
+	for (std::size_t i = 0; i < pointCount; i++)
+	{
+		seeded[i] = distances[i] != std::numeric_limits<double>::infinity();
+		unseededCount += !seeded[i];
+	}
+	std::vector<unsigned char> nextSeeded(seeded);
+	const std::size_t strides[3] = { 1, (std::size_t)size, (std::size_t)size * size };
+	while (unseededCount > 0)
+	{
+		LUTHelper::LUT3DConcurrentRangeLoop(size, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+			{
+				if (seeded[i])
+				{
+					continue;
+				}
+				const std::size_t coordinates[3] = { i % size, (i / size) % size, i / strides[2] };
+				for (int axis = 0; axis < 3 && !nextSeeded[i]; axis++)
+				{
+					for (int direction = -1; direction <= 1 && !nextSeeded[i]; direction += 2)
+					{
+						if ((direction < 0 && coordinates[axis] == 0) || (direction > 0 && coordinates[axis] == (std::size_t)size - 1))
+						{
+							continue;
+						}
+						const std::size_t neighbour = (direction < 0) ? i - strides[axis] : i + strides[axis];
+						if (seeded[neighbour])
+						{
+							for (int c = 0; c < 3; c++)
+							{
+								seeds[c * pointCount + i] = seeds[c * pointCount + neighbour];
+							}
+							nextSeeded[i] = 1;
+						}
+					}
+				}
+			}
+		});
+		const std::size_t previousUnseededCount = unseededCount;
+		unseededCount = 0;
+		for (std::size_t i = 0; i < pointCount; i++)
+		{
+			seeded[i] = nextSeeded[i];
+			unseededCount += !seeded[i];
+		}
+		// the lattice is connected, so a pass only stalls when nothing was seeded at all
+		if (unseededCount == previousUnseededCount)
+		{
+			throw std::domain_error("Invalid LUT3D: no lattice output is a number, so there is nothing to invert");
+		}
+	}
+	return seeds;
+}
+
+}
+
+template <typename T>
+BasicLUT3DInverse<T>::BasicLUT3DInverse(const BasicLUT3D<T> & cube, double maximumError, double meanError,
+                                        std::size_t unconvergedPointCount):
+                                        cube(cube),
+                                        maximumError(maximumError),
+                                        meanError(meanError),
+                                        unconvergedPointCount(unconvergedPointCount)
+{}
+
+template <typename T>
+BasicLUT3DInverse<T> BasicLUT3DInverse<T>::ofLUT3D(const BasicLUT3D<T> & lut, int size, double tolerance,
+                                                   int maximumIterations, LUT3DInterpolation interpolation)
+{
+	if (size == 0)
+	{
+		size = lut.getSize();
+	}
+	if (!(tolerance > 0))
+	{
+		throw std::domain_error("Invalid Tolerance: tolerance must be greater than 0");
+	}
+	if (maximumIterations < 1)
+	{
+		throw std::domain_error("Invalid Iteration Count: maximum iterations " + std::to_string(maximumIterations)
+		                        + " must be at least 1");
+	}
+	BasicLUT3D<T> cube = BasicLUT3D<T>::withSize(size, lut.getInputLowerBound(), lut.getInputUpperBound());
+
+	const std::size_t pointCount = cube.getPointCount();
+	const std::vector<double> seeds = scatterSeeds(lut, size);
+	const ForwardModel<T> model(lut, interpolation);
+	const double lower = lut.getInputLowerBound();
+	const double step = (lut.getInputUpperBound() - lower) / (size - 1);
+	T * planes[3] = { cube.redPlane(), cube.greenPlane(), cube.bluePlane() };
+
+	std::mutex reportMutex;
+	double maximumError = 0;
+	double errorSum = 0;
+	std::size_t finitePointCount = 0;
+	std::size_t unconvergedPointCount = 0;
+	LUTHelper::LUT3DConcurrentRangeLoop(size, [&](std::size_t begin, std::size_t end)
+	{
+		double blockMaximum = 0;
+		double blockSum = 0;
+		std::size_t blockFinite = 0;
+		std::size_t blockUnconverged = 0;
+		for (std::size_t i = begin; i < end; i++)
+		{
+			const double target[3] = { lower + (double)(i % size) * step,
+			                           lower + (double)((i / size) % size) * step,
+			                           lower + (double)(i / ((std::size_t)size * size)) * step };
+			double input[3] = { seeds[i], seeds[pointCount + i], seeds[2 * pointCount + i] };
+			const double error = solve(model, target, input, tolerance, maximumIterations);
+			for (int c = 0; c < 3; c++)
+			{
+				planes[c][i] = (T)input[c];
+			}
+			// a point whose error is NaN or infinite counts as unconverged but
+			// stays out of the statistics
+			if (!std::isfinite(error))
+			{
+				blockUnconverged++;
+				continue;
+			}
+			blockMaximum = (error > blockMaximum) ? error : blockMaximum;
+			blockSum += error;
+			blockFinite++;
+			blockUnconverged += error > tolerance;
+		}
+		std::lock_guard<std::mutex> lock(reportMutex);
+		maximumError = (blockMaximum > maximumError) ? blockMaximum : maximumError;
+		errorSum += blockSum;
+		finitePointCount += blockFinite;
+		unconvergedPointCount += blockUnconverged;
+	});
+
+	const double meanError = (finitePointCount > 0) ? errorSum / finitePointCount
+	                                                : std::numeric_limits<double>::quiet_NaN();
+	return BasicLUT3DInverse(cube, maximumError, meanError, unconvergedPointCount);
+}
+
+namespace CppLUT
+{
+template class BasicLUT3DInverse<float>;
+template class BasicLUT3DInverse<double>;
+template class BasicLUT3DInverse<LUTHalf>;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT3D.h"
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      An approximate inverse of a LUT3D, with a report of how well it
+ *             round trips.
+ * @discussion Each lattice point of the inverse cube holds the input that the
+ *             forward LUT maps onto that point's identity color. The inputs
+ *             are found in two steps:
+ *
+ *             1. Every forward lattice point is scattered onto the nearest
+ *                point of the inverse lattice by its output color, and the
+ *                points no forward output lands on take the seed of a
+ *                neighbour. This replaces a search of every forward point
+ *                for every inverse point.
+ *             2. Each seed is refined with damped Newton iterations on the
+ *                forward LUT's interpolation, whose Jacobian is exact inside
+ *                a lattice cell. Inputs are kept within the forward LUT's
+ *                input bounds, so targets outside its output gamut converge
+ *                on the closest input the LUT can reach.
+ *
+ *             Step 2 runs over blocks of lattice points spread over
+ *             `LUTHelper::concurrency()` threads.
+ *
+ * @tparam     T     The lattice value type: `float`, `double` or `LUTHalf`
+ */
+template <typename T>
+class BasicLUT3DInverse
+{
+	/** @brief      The inverse cube */
+	BasicLUT3D<T> cube;
+
+	/** @brief      The largest per-channel difference between a target and the forward LUT's output for its input */
+	double maximumError;
+
+	/** @brief      The mean of those differences over the points where they are finite */
+	double meanError;
+
+	/** @brief      The number of lattice points whose error is above the tolerance or not finite */
+	std::size_t unconvergedPointCount;
+
+	/**
+	 * @brief      Private constructor for a LUT3DInverse
+	 */
+	BasicLUT3DInverse(const BasicLUT3D<T> & cube, double maximumError, double meanError,
+	                  std::size_t unconvergedPointCount);
+
+public:
+	/**
+	 * @brief      Inverts a LUT3D whose output covers the same range as its
+	 *             input, such as a show LUT or a gamut conversion
+	 *
+	 * @throws     std::domain_error  If size is not 0 or in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`, tolerance is not
+	 *                                positive or maximumIterations is less
+	 *                                than 1
+	 * @throws     std::domain_error  If every output of `lut` is NaN
+	 *
+	 * @param[in]  lut                The LUT to invert
+	 * @param[in]  size               The edge length of the inverse cube, 0 for
+	 *                                the size of `lut`
+	 * @param[in]  tolerance          Iterations stop once every channel of the
+	 *                                forward output is within this distance of
+	 *                                the target
+	 * @param[in]  maximumIterations  The most Newton iterations spent on each
+	 *                                lattice point
+	 * @param[in]  interpolation      The interpolation the forward LUT is
+	 *                                inverted under
+	 *
+	 * @return     The inverse and its error report
+	 */
+	static BasicLUT3DInverse ofLUT3D(const BasicLUT3D<T> & lut, int size = 0, double tolerance = 1e-5,
+	                                 int maximumIterations = 16,
+	                                 LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      The inverse cube, with the input bounds of the forward LUT
+	 */
+	const BasicLUT3D<T> & getCube() const { return cube; }
+
+	/**
+	 * @brief      The largest per-channel difference between a lattice point's
+	 *             identity color and the forward LUT's output for the input
+	 *             stored at that point, measured before the input is rounded
+	 *             to `T`. Points whose error is not finite are left out.
+	 */
+	double getMaximumError() const { return maximumError; }
+
+	/**
+	 * @brief      The mean of the finite per-point errors measured for
+	 *             `getMaximumError`, or NaN if no point has a finite error
+	 */
+	double getMeanError() const { return meanError; }
+
+	/**
+	 * @brief      The number of lattice points whose error is above the
+	 *             tolerance or not finite, usually targets outside the
+	 *             forward LUT's gamut
+	 */
+	std::size_t getUnconvergedPointCount() const { return unconvergedPointCount; }
+};
+
+extern template class BasicLUT3DInverse<float>;
+extern template class BasicLUT3DInverse<double>;
+extern template class BasicLUT3DInverse<LUTHalf>;
+
+/** @brief      An inverse with a double precision cube */
+typedef BasicLUT3DInverse<LUTColorValue> LUT3DInverse;
+
+/** @brief      An inverse with a single precision cube */
+typedef BasicLUT3DInverse<float> LUT3DInversef;
+
+/** @brief      An inverse with a half precision cube */
+typedef BasicLUT3DInverse<LUTHalf> LUT3DInverseh;
+
+}
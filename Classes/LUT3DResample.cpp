@@ -0,0 +1,246 @@
+#include "LUT3D.h"
+#include "LUTHelper.h"
+
+#include <cmath> // std::floor
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+/**
+ * @brief      Where a new lattice point falls along one axis of the old
+ *             lattice, as the old points around it and their weights
+ */
+struct AxisSample
+{
+	/** @brief      The old point at or below the new point, at most size - 2 */
+	int base;
+	/** @brief      The fractional position of the new point past `base` */
+	double fraction;
+	/** @brief      Four old points, all inside the lattice */
+	int taps[4];
+	/** @brief      The weights of `taps` */
+	double weights[4];
+};
+
+/**
+ * @brief      Locates every point of a new axis on an old axis, from the
+ *             same lattice positions `identityOfSize` uses. Cubic taps past
+ *             either end are linear extrapolations of the last two points,
+ *             folded into the weights of those points.
+ */
+std::vector<AxisSample> axisSamples(int oldSize, int newSize, bool cubic)
+{
+	const std::vector<double> positions = LUTHelper::indicesDoubleVector(0, 1, newSize);
+	std::vector<AxisSample> samples(newSize);
+	for (int i = 0; i < newSize; i++)
+	{
+		const double coordinate = positions[i] * (oldSize - 1);
+		int base = (int)std::floor(coordinate);
+		base = (base < 0) ? 0 : ((base > oldSize - 2) ? oldSize - 2 : base);
+		const double t = coordinate - base;
+		AxisSample & sample = samples[i];
+		sample.base = base;
+		sample.fraction = t;
+		sample.taps[0] = base;
+		sample.taps[1] = base;
+		sample.taps[2] = base + 1;
+		sample.taps[3] = base + 1;
+		if (!cubic)
+		{
+			sample.weights[0] = 0;
+			sample.weights[1] = 1 - t;
+			sample.weights[2] = t;
+			sample.weights[3] = 0;
+			continue;
+		}
+
+		// Catmull-Rom
+		const double t2 = t * t;
+		const double t3 = t2 * t;
+		double before = 0.5 * (-t3 + 2 * t2 - t);
+		double after = 0.5 * (t3 - t2);
+		sample.weights[1] = 0.5 * (3 * t3 - 5 * t2 + 2);
+		sample.weights[2] = 0.5 * (-3 * t3 + 4 * t2 + t);
+		if (base > 0)
+		{
+			sample.taps[0] = base - 1;
+		}
+		else
+		{
+			// v(-1) = 2 v(0) - v(1)
+			sample.weights[1] += 2 * before;
+			sample.weights[2] -= before;
+			before = 0;
+		}
+		if (base + 2 < oldSize)
+		{
+			sample.taps[3] = base + 2;
+		}
+		else
+		{
+			// v(size) = 2 v(size - 1) - v(size - 2)
+			sample.weights[2] += 2 * after;
+			sample.weights[1] -= after;
+			after = 0;
+		}
+		sample.weights[0] = before;
+		sample.weights[3] = after;
+	}
+	return samples;
+}
+
+/**
+ * @brief      Resamples one plane along one axis. `dimensions` are the red,
+ *             green and blue extents of `input`; `output` has the same
+ *             extents except `samples.size()` along `axis`.
+ */
+void resampleAxis(const double * input, double * output, const int dimensions[3], int axis,
+                  const std::vector<AxisSample> & samples)
+{
+	int outputDimensions[3] = { dimensions[0], dimensions[1], dimensions[2] };
+	outputDimensions[axis] = (int)samples.size();
+	const std::size_t inputStrides[3] = { 1, (std::size_t)dimensions[0], (std::size_t)dimensions[0] * dimensions[1] };
+	const std::size_t outputRow = (std::size_t)outputDimensions[0];
+	const std::size_t outputSlice = outputRow * outputDimensions[1];
+
+	// one tile per slice along blue
+	LUTHelper::concurrentTileLoop(outputDimensions[2], [&](int b)
+	{
+		for (int g = 0; g < outputDimensions[1]; g++)
+		{
+			double * out = output + b * outputSlice + g * outputRow;
+			if (axis == 0)
+			{
+				const double * in = input + g * inputStrides[1] + b * inputStrides[2];
+				for (int r = 0; r < outputDimensions[0]; r++)
+				{
+					const AxisSample & s = samples[r];
+					out[r] = s.weights[0] * in[s.taps[0]] + s.weights[1] * in[s.taps[1]]
+					       + s.weights[2] * in[s.taps[2]] + s.weights[3] * in[s.taps[3]];
+				}
+				continue;
+			}
+
+			// along green or blue every red point of a row shares its weights,
+			// so the row is a blend of four whole input rows
+			const AxisSample & s = samples[(axis == 1) ? g : b];
+			const std::size_t fixed = (axis == 1) ? b * inputStrides[2] : g * inputStrides[1];
+			const double * rows[4];
+			for (int k = 0; k < 4; k++)
+			{
+				rows[k] = input + fixed + s.taps[k] * inputStrides[axis];
+			}
+			const double w0 = s.weights[0], w1 = s.weights[1], w2 = s.weights[2], w3 = s.weights[3];
+			for (int r = 0; r < outputDimensions[0]; r++)
+			{
+				out[r] = w0 * rows[0][r] + w1 * rows[1][r] + w2 * rows[2][r] + w3 * rows[3][r];
+			}
+		}
+	});
+}
+
+}
+
+template <typename T>
+BasicLUT3D<T> BasicLUT3D<T>::resampledToSize(int newSize, LUT3DResampling method) const
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	BasicLUT3D result = withSize(newSize, inputLowerBound, inputUpperBound);
+	const std::vector<AxisSample> samples = axisSamples(size, newSize, method == LUT3DResampling::Cubic);
+	const T * const oldPlanes[3] = { redPlane(), greenPlane(), bluePlane() };
+	T * const newPlanes[3] = { result.redPlane(), result.greenPlane(), result.bluePlane() };
+
+	if (method == LUT3DResampling::Tetrahedral)
+	{
+		const std::size_t sG = (std::size_t)size;
+		const std::size_t sB = (std::size_t)size * size;
+		const std::size_t axisStrides[3] = { 1, sG, sB };
+		LUTHelper::LUT3DConcurrentRangeLoop(newSize, [&](std::size_t begin, std::size_t end)
+		{
+			const std::size_t newRow = (std::size_t)newSize;
+			const std::size_t newSlice = newRow * newSize;
+			int r = (int)(begin % newRow);
+			int g = (int)((begin / newRow) % newRow);
+			int b = (int)(begin / newSlice);
+			for (std::size_t i = begin; i < end; i++)
+			{
+				const AxisSample * axes[3] = { &samples[r], &samples[g], &samples[b] };
+				const double f[3] = { axes[0]->fraction, axes[1]->fraction, axes[2]->fraction };
+				if (++r == newSize)
+				{
+					r = 0;
+					if (++g == newSize)
+					{
+						g = 0;
+						b++;
+					}
+				}
+
+				// the same choice of tetrahedron as the LUT3D kernels
+				const bool rgt = f[0] > f[1];
+				const bool gbt = f[1] > f[2];
+				const bool rbt = f[0] > f[2];
+				int axisMax, axisMin;
+				if (rgt && rbt) { axisMax = 0; }
+				else if (!rgt && gbt) { axisMax = 1; }
+				else { axisMax = 2; }
+				if (!rgt && !rbt) { axisMin = 0; }
+				else if (rgt && !gbt) { axisMin = 1; }
+				else { axisMin = 2; }
+				const int axisMid = 3 - axisMax - axisMin;
+
+				const std::size_t i000 = axes[0]->base + axes[1]->base * sG + axes[2]->base * sB;
+				const std::size_t iA = i000 + axisStrides[axisMax];
+				const std::size_t iB = iA + axisStrides[axisMid];
+				const std::size_t i111 = iB + axisStrides[axisMin];
+				for (int c = 0; c < 3; c++)
+				{
+					const T * p = oldPlanes[c];
+					const double c000 = (double)(C)p[i000];
+					const double cA = (double)(C)p[iA];
+					const double cB = (double)(C)p[iB];
+					const double c111 = (double)(C)p[i111];
+					newPlanes[c][i] = (T)(c000 + f[axisMax] * (cA - c000) + f[axisMid] * (cB - cA) + f[axisMin] * (c111 - cB));
+				}
+			}
+		});
+		return result;
+	}
+
+	// trilinear and cubic weights are products of per-axis weights, so the
+	// lattice is resampled along red, then green, then blue
+	const std::size_t oldCount = getPointCount();
+	const std::size_t newCount = result.getPointCount();
+	std::vector<double> source(oldCount);
+	std::vector<double> alongRed((std::size_t)newSize * size * size);
+	std::vector<double> alongGreen((std::size_t)newSize * newSize * size);
+	std::vector<double> alongBlue(newCount);
+	for (int c = 0; c < 3; c++)
+	{
+		for (std::size_t i = 0; i < oldCount; i++)
+		{
+			source[i] = (double)(C)oldPlanes[c][i];
+		}
+		const int oldDimensions[3] = { size, size, size };
+		const int redDimensions[3] = { newSize, size, size };
+		const int greenDimensions[3] = { newSize, newSize, size };
+		resampleAxis(source.data(), alongRed.data(), oldDimensions, 0, samples);
+		resampleAxis(alongRed.data(), alongGreen.data(), redDimensions, 1, samples);
+		resampleAxis(alongGreen.data(), alongBlue.data(), greenDimensions, 2, samples);
+		for (std::size_t i = 0; i < newCount; i++)
+		{
+			newPlanes[c][i] = (T)alongBlue[i];
+		}
+	}
+	return result;
+}
+
+namespace CppLUT
+{
+template LUT3Df BasicLUT3D<float>::resampledToSize(int, LUT3DResampling) const;
+template LUT3D BasicLUT3D<double>::resampledToSize(int, LUT3DResampling) const;
+template LUT3Dh BasicLUT3D<LUTHalf>::resampledToSize(int, LUT3DResampling) const;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CppLUT.h"
+
+#include <cstddef> // std::size_t
+#include <cstdlib> // std::free
+#include <cstring> // std::memcpy std::memset
+#include <new> // std::bad_alloc
+#include <utility> // std::swap
+
+#if defined(_WIN32)
+#include <malloc.h> // _aligned_malloc _aligned_free
+#endif
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A fixed size, zero initialised block of memory aligned to
+ *             `CPPLUT_CACHE_LINE_SIZE` bytes.
+ *
+ * @tparam     T     The element type. Must be trivially copyable.
+ */
+template <typename T>
+class LUTAlignedBuffer
+{
+private:
+	/** @brief      The first element of the buffer */
+	T * elements;
+
+	/** @brief      The number of elements in the buffer */
+	std::size_t count;
+
+	static T * allocate(std::size_t count)
+	{
+		if (count == 0)
+		{
+			return nullptr;
+		}
+		void * memory = nullptr;
+		std::size_t bytes = count * sizeof(T);
+#if defined(_WIN32)
+		memory = _aligned_malloc(bytes, CPPLUT_CACHE_LINE_SIZE);
+#else
+		if (posix_memalign(&memory, CPPLUT_CACHE_LINE_SIZE, bytes) != 0)
+		{
+			memory = nullptr;
+		}
+#endif
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		std::memset(memory, 0, bytes);
+		return static_cast<T *>(memory);
+	}
+
+	static void deallocate(T * memory)
+	{
+#if defined(_WIN32)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+public:
+	/**
+	 * @brief      Creates an empty buffer
+	 */
+	LUTAlignedBuffer(): elements(nullptr), count(0) {}
+
+	/**
+	 * @brief      Creates a zeroed buffer holding `count` elements
+	 *
+	 * @param[in]  count  The number of elements
+	 */
+	explicit LUTAlignedBuffer(std::size_t count): elements(allocate(count)), count(count) {}
+
+	LUTAlignedBuffer(const LUTAlignedBuffer & other): elements(allocate(other.count)), count(other.count)
+	{
+		if (count != 0)
+		{
+			std::memcpy(elements, other.elements, count * sizeof(T));
+		}
+	}
+
+	LUTAlignedBuffer(LUTAlignedBuffer && other): elements(other.elements), count(other.count)
+	{
+		other.elements = nullptr;
+		other.count = 0;
+	}
+
+	LUTAlignedBuffer & operator=(LUTAlignedBuffer other)
+	{
+		std::swap(elements, other.elements);
+		std::swap(count, other.count);
+		return *this;
+	}
+
+	~LUTAlignedBuffer() { deallocate(elements); }
+
+	T * data() { return elements; }
+	const T * data() const { return elements; }
+	std::size_t size() const { return count; }
+
+	T & operator[](std::size_t index) { return elements[index]; }
+	const T & operator[](std::size_t index) const { return elements[index]; }
+};
+
+/**
+ * @brief      Rounds an element count up so that the following element
+ *             starts on a cache line boundary
+ *
+ * @param[in]  count  The number of elements
+ *
+ * @tparam     T      The element type
+ *
+ * @return     The padded number of elements
+ */
+template <typename T>
+inline std::size_t alignedElementCount(std::size_t count)
+{
+	const std::size_t perLine = CPPLUT_CACHE_LINE_SIZE / sizeof(T);
+	return ((count + perLine - 1) / perLine) * perLine;
+}
+
+}
@@ -0,0 +1,153 @@
+#include "LUTBakeChain.h"
+#include "LUTBakeStage.h"
+#include "LUTHelper.h"
+
+#include <algorithm> // std::min
+
+using namespace CppLUT;
+
+const std::size_t LUTBakeStage::blockPixels;
+
+LUTBakeChain & LUTBakeChain::appendLUT1D(const LUT1Df & lut)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT1DStage<float>>(lut));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendLUT1D(const LUT1D & lut)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT1DStage<double>>(lut));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendLUT1D(const LUT1Dh & lut)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT1DStage<LUTHalf>>(lut));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendLUT3D(const LUT3Df & lut, LUT3DInterpolation interpolation)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT3DStage<float>>(lut, interpolation));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendLUT3D(const LUT3D & lut, LUT3DInterpolation interpolation)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT3DStage<double>>(lut, interpolation));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendLUT3D(const LUT3Dh & lut, LUT3DInterpolation interpolation)
+{
+	stages.push_back(std::make_shared<LUTBakeLUT3DStage<LUTHalf>>(lut, interpolation));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendMatrix(const LUTMatrix3 & matrix)
+{
+	if (!stages.empty() && stages.back()->matrix() != nullptr)
+	{
+		// replaced rather than modified, other chains may share the stage
+		stages.back() = std::make_shared<LUTBakeMatrixStage>(matrix * *stages.back()->matrix());
+		return *this;
+	}
+	stages.push_back(std::make_shared<LUTBakeMatrixStage>(matrix));
+	return *this;
+}
+
+LUTBakeChain & LUTBakeChain::appendColorSpaceConversion(const LUTColorSpace & sourceColorSpace,
+                                                        const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                                        const LUTColorSpace & destinationColorSpace,
+                                                        const LUTColorSpaceWhitePoint & destinationWhitePoint,
+                                                        bool useBradfordMatrix)
+{
+	return appendMatrix(LUTColorSpace::transformationMatrix(sourceColorSpace, sourceWhitePoint,
+	                                                        destinationColorSpace, destinationWhitePoint,
+	                                                        useBradfordMatrix));
+}
+
+void LUTBakeChain::apply(const float * input, float * output, std::size_t pixelCount, std::size_t pixelStride) const
+{
+	for (std::size_t p = 0; p < pixelCount; p += LUTBakeStage::blockPixels)
+	{
+		const std::size_t count = std::min(LUTBakeStage::blockPixels, pixelCount - p);
+		const float * in = input + p * pixelStride;
+		float * block = output + p * pixelStride;
+		if (block != in)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				block[i * pixelStride] = in[i * pixelStride];
+				block[i * pixelStride + 1] = in[i * pixelStride + 1];
+				block[i * pixelStride + 2] = in[i * pixelStride + 2];
+			}
+		}
+		for (const std::shared_ptr<const LUTBakeStage> & stage : stages)
+		{
+			stage->apply(block, count, pixelStride);
+		}
+	}
+}
+
+template <typename T>
+BasicLUT3D<T> LUTBakeChain::bakeLUT3D(int size, double inputLowerBound, double inputUpperBound) const
+{
+	BasicLUT3D<T> lut = BasicLUT3D<T>::withSize(size, inputLowerBound, inputUpperBound);
+
+	// the leading separable stages only ever see the lattice axis values
+	const double step = (inputUpperBound - inputLowerBound) / (size - 1);
+	std::vector<float> axes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		axes[c].resize(size);
+		for (int i = 0; i < size; i++)
+		{
+			axes[c][i] = (float)(inputLowerBound + i * step);
+		}
+	}
+	std::size_t firstLatticeStage = 0;
+	float * const planes[3] = { axes[0].data(), axes[1].data(), axes[2].data() };
+	while (firstLatticeStage < stages.size() && stages[firstLatticeStage]->isSeparable())
+	{
+		stages[firstLatticeStage]->applyToPlanes(planes, size);
+		firstLatticeStage++;
+	}
+
+	T * red = lut.redPlane();
+	T * green = lut.greenPlane();
+	T * blue = lut.bluePlane();
+	LUTHelper::LUT3DConcurrentRangeLoop(size, [&](std::size_t begin, std::size_t end)
+	{
+		std::vector<float> pixels(3 * LUTBakeStage::blockPixels);
+		for (std::size_t blockBegin = begin; blockBegin < end; blockBegin += LUTBakeStage::blockPixels)
+		{
+			const std::size_t count = std::min(LUTBakeStage::blockPixels, end - blockBegin);
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const std::size_t index = blockBegin + i;
+				pixels[3 * i] = axes[0][index % size];
+				pixels[3 * i + 1] = axes[1][(index / size) % size];
+				pixels[3 * i + 2] = axes[2][index / ((std::size_t)size * size)];
+			}
+			for (std::size_t s = firstLatticeStage; s < stages.size(); s++)
+			{
+				stages[s]->apply(pixels.data(), count, 3);
+			}
+			for (std::size_t i = 0; i < count; i++)
+			{
+				red[blockBegin + i] = (T)pixels[3 * i];
+				green[blockBegin + i] = (T)pixels[3 * i + 1];
+				blue[blockBegin + i] = (T)pixels[3 * i + 2];
+			}
+		}
+	});
+	return lut;
+}
+
+namespace CppLUT
+{
+template LUT3Df LUTBakeChain::bakeLUT3D<float>(int, double, double) const;
+template LUT3D LUTBakeChain::bakeLUT3D<double>(int, double, double) const;
+template LUT3Dh LUTBakeChain::bakeLUT3D<LUTHalf>(int, double, double) const;
+}
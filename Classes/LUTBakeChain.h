@@ -0,0 +1,134 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+#include "LUTColorSpace.h"
+#include "LUTMatrix3.h"
+
+#include <cstddef> // std::size_t
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+
+namespace CppLUT
+{
+
+struct LUTBakeStage;
+
+/**
+ * @brief      An ordered chain of LUT1Ds, LUT3Ds and color space conversions
+ *             that can be applied directly or baked into a single LUT3D.
+ * @discussion Appending a matrix straight after another matrix multiplies
+ *             the two into one stage. When baking, the run of LUT1D stages
+ *             at the start of the chain only depends on one channel at a
+ *             time, so it is evaluated once per lattice axis rather than
+ *             once per lattice point; the remaining stages run over blocks
+ *             of lattice points spread over `LUTHelper::concurrency()`
+ *             threads. Stages hold their own copies of the LUTs they are
+ *             given. Every stage evaluates in single precision, as the
+ *             LUT kernels do, whatever the value type of the baked cube.
+ */
+class LUTBakeChain
+{
+public:
+	/**
+	 * @brief      Appends a LUT1D applied to each channel
+	 *
+	 * @param[in]  lut   The LUT
+	 *
+	 * @return     This chain
+	 */
+	LUTBakeChain & appendLUT1D(const LUT1Df & lut);
+	LUTBakeChain & appendLUT1D(const LUT1D & lut);
+	LUTBakeChain & appendLUT1D(const LUT1Dh & lut);
+
+	/**
+	 * @brief      Appends a LUT3D
+	 *
+	 * @param[in]  lut            The LUT
+	 * @param[in]  interpolation  The interpolation method used to apply it
+	 *
+	 * @return     This chain
+	 */
+	LUTBakeChain & appendLUT3D(const LUT3Df & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+	LUTBakeChain & appendLUT3D(const LUT3D & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+	LUTBakeChain & appendLUT3D(const LUT3Dh & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      Appends a 3x3 matrix applied to every color
+	 *
+	 * @param[in]  matrix  The matrix
+	 *
+	 * @return     This chain
+	 */
+	LUTBakeChain & appendMatrix(const LUTMatrix3 & matrix);
+
+	/**
+	 * @brief      Appends a conversion of linear color from one color space
+	 *             to another, using `LUTColorSpace::transformationMatrix`
+	 *
+	 * @param[in]  sourceColorSpace       The source color space
+	 * @param[in]  sourceWhitePoint       The source white point
+	 * @param[in]  destinationColorSpace  The destination color space
+	 * @param[in]  destinationWhitePoint  The destination white point
+	 * @param[in]  useBradfordMatrix      Adapt between the white points with the
+	 *                                    Bradford transform
+	 *
+	 * @return     This chain
+	 */
+	LUTBakeChain & appendColorSpaceConversion(const LUTColorSpace & sourceColorSpace,
+	                                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                          const LUTColorSpace & destinationColorSpace,
+	                                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
+	                                          bool useBradfordMatrix);
+
+	/**
+	 * @brief      The number of stages, after adjacent matrices are merged
+	 */
+	std::size_t getStageCount() const { return stages.size(); }
+
+	/**
+	 * @brief      Runs every stage over a span of interleaved RGB pixels.
+	 *             `input` and `output` may point to the same buffer.
+	 *
+	 * @param[in]  input        The first input pixel
+	 * @param[out] output       The first output pixel
+	 * @param[in]  pixelCount   The number of pixels to process
+	 * @param[in]  pixelStride  The number of floats from one pixel to the
+	 *                          next, 3 for RGB and 4 for RGBA
+	 */
+	void apply(const float * input, float * output, std::size_t pixelCount, std::size_t pixelStride = 3) const;
+
+	/**
+	 * @brief      Bakes the whole chain into a single LUT3D
+	 * @discussion The stages run on float values; `T` only sets how the
+	 *             results are stored, so a double cube holds float-accurate
+	 *             values.
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`
+	 *
+	 * @param[in]  size             The edge length of the baked cube
+	 * @param[in]  inputLowerBound  The input value of the first lattice point
+	 * @param[in]  inputUpperBound  The input value of the last lattice point
+	 *
+	 * @tparam     T                The lattice value type of the baked cube
+	 *
+	 * @return     The baked LUT
+	 */
+	template <typename T = LUTColorValue>
+	BasicLUT3D<T> bakeLUT3D(int size, double inputLowerBound = 0, double inputUpperBound = 1) const;
+
+private:
+	/**
+	 * @brief      The stages in the order they are applied. Stages are
+	 *             immutable once appended, so copies of a chain share them.
+	 */
+	std::vector<std::shared_ptr<const LUTBakeStage>> stages;
+};
+
+extern template LUT3Df LUTBakeChain::bakeLUT3D<float>(int, double, double) const;
+extern template LUT3D LUTBakeChain::bakeLUT3D<double>(int, double, double) const;
+extern template LUT3Dh LUTBakeChain::bakeLUT3D<LUTHalf>(int, double, double) const;
+
+}
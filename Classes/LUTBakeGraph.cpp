@@ -0,0 +1,240 @@
+#include "LUTBakeGraph.h"
+#include "LUTBakeStage.h"
+#include "LUTColorOps.h"
+#include "LUTHelper.h"
+
+#include <algorithm> // std::min std::copy
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+
+using namespace CppLUT;
+
+LUTBakeGraph::LUTBakeGraph(int size, double inputLowerBound, double inputUpperBound):
+                           size(size),
+                           inputLowerBound(inputLowerBound),
+                           inputUpperBound(inputUpperBound),
+                           axisNodeCount(0),
+                           upToDateCount(0)
+{}
+
+LUTBakeGraph LUTBakeGraph::withSize(int size, double inputLowerBound, double inputUpperBound)
+{
+	if (size < 2 || size > CPPLUT_MAX_LUT3D_SIZE)
+	{
+		throw std::domain_error("Invalid LUT3D Size: size " + std::to_string(size) + " must be in the range 2 to "
+		                        + std::to_string(CPPLUT_MAX_LUT3D_SIZE));
+	}
+	if (!(inputLowerBound < inputUpperBound))
+	{
+		throw std::domain_error("Invalid LUT3D Bounds: input lower bound must be less than input upper bound");
+	}
+	return LUTBakeGraph(size, inputLowerBound, inputUpperBound);
+}
+
+std::size_t LUTBakeGraph::append(const std::shared_ptr<const LUTBakeStage> & node)
+{
+	if (axisNodeCount == nodes.size() && node->isSeparable())
+	{
+		axisNodeCount++;
+	}
+	nodes.push_back(node);
+	outputs.emplace_back();
+	return nodes.size() - 1;
+}
+
+void LUTBakeGraph::replace(std::size_t index, const std::shared_ptr<const LUTBakeStage> & node)
+{
+	if (index >= nodes.size())
+	{
+		throw std::domain_error("Invalid Node: node " + std::to_string(index) + " is not in a graph of "
+		                        + std::to_string(nodes.size()) + " nodes");
+	}
+	if (nodes[index]->kind() != node->kind())
+	{
+		throw std::domain_error("Invalid Node: node " + std::to_string(index) + " is a "
+		                        + LUTBakeStage::nameOfKind(nodes[index]->kind()) + " node, not a "
+		                        + LUTBakeStage::nameOfKind(node->kind()) + " node");
+	}
+	nodes[index] = node;
+	upToDateCount = std::min(upToDateCount, index);
+}
+
+std::size_t LUTBakeGraph::appendLUT1D(const LUT1Df & lut)
+{
+	return append(std::make_shared<LUTBakeLUT1DStage<float>>(lut));
+}
+
+std::size_t LUTBakeGraph::appendLUT1D(const LUT1D & lut)
+{
+	return append(std::make_shared<LUTBakeLUT1DStage<double>>(lut));
+}
+
+std::size_t LUTBakeGraph::appendLUT1D(const LUT1Dh & lut)
+{
+	return append(std::make_shared<LUTBakeLUT1DStage<LUTHalf>>(lut));
+}
+
+std::size_t LUTBakeGraph::appendLUT3D(const LUT3Df & lut, LUT3DInterpolation interpolation)
+{
+	return append(std::make_shared<LUTBakeLUT3DStage<float>>(lut, interpolation));
+}
+
+std::size_t LUTBakeGraph::appendLUT3D(const LUT3D & lut, LUT3DInterpolation interpolation)
+{
+	return append(std::make_shared<LUTBakeLUT3DStage<double>>(lut, interpolation));
+}
+
+std::size_t LUTBakeGraph::appendLUT3D(const LUT3Dh & lut, LUT3DInterpolation interpolation)
+{
+	return append(std::make_shared<LUTBakeLUT3DStage<LUTHalf>>(lut, interpolation));
+}
+
+std::size_t LUTBakeGraph::appendMatrix(const LUTMatrix3 & matrix)
+{
+	return append(std::make_shared<LUTBakeMatrixStage>(matrix));
+}
+
+std::size_t LUTBakeGraph::appendColorSpaceConversion(const LUTColorSpace & sourceColorSpace,
+                                                     const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                                     const LUTColorSpace & destinationColorSpace,
+                                                     const LUTColorSpaceWhitePoint & destinationWhitePoint,
+                                                     bool useBradfordMatrix)
+{
+	return appendMatrix(LUTColorSpace::transformationMatrix(sourceColorSpace, sourceWhitePoint,
+	                                                        destinationColorSpace, destinationWhitePoint,
+	                                                        useBradfordMatrix));
+}
+
+std::size_t LUTBakeGraph::appendSlopeOffsetPower(double redSlope, double redOffset, double redPower,
+                                                 double greenSlope, double greenOffset, double greenPower,
+                                                 double blueSlope, double blueOffset, double bluePower)
+{
+	return append(std::make_shared<LUTBakeSlopeOffsetPowerStage>(
+		LUTColorOps::applySlopeOffsetPower<float>(redSlope, redOffset, redPower,
+		                                          greenSlope, greenOffset, greenPower,
+		                                          blueSlope, blueOffset, bluePower)));
+}
+
+std::size_t LUTBakeGraph::appendSaturation(double saturation, double lumaR, double lumaG, double lumaB)
+{
+	return append(std::make_shared<LUTBakeSaturationStage>(LUTColorOps::changeSaturation<float>(saturation, lumaR, lumaG, lumaB)));
+}
+
+void LUTBakeGraph::setMatrix(std::size_t node, const LUTMatrix3 & matrix)
+{
+	replace(node, std::make_shared<LUTBakeMatrixStage>(matrix));
+}
+
+void LUTBakeGraph::setSlopeOffsetPower(std::size_t node,
+                                       double redSlope, double redOffset, double redPower,
+                                       double greenSlope, double greenOffset, double greenPower,
+                                       double blueSlope, double blueOffset, double bluePower)
+{
+	replace(node, std::make_shared<LUTBakeSlopeOffsetPowerStage>(
+		LUTColorOps::applySlopeOffsetPower<float>(redSlope, redOffset, redPower,
+		                                          greenSlope, greenOffset, greenPower,
+		                                          blueSlope, blueOffset, bluePower)));
+}
+
+void LUTBakeGraph::setSaturation(std::size_t node, double saturation, double lumaR, double lumaG, double lumaB)
+{
+	replace(node, std::make_shared<LUTBakeSaturationStage>(LUTColorOps::changeSaturation<float>(saturation, lumaR, lumaG, lumaB)));
+}
+
+void LUTBakeGraph::update()
+{
+	const std::size_t pointCount = (std::size_t)size * size * size;
+	const std::size_t axisSize = (std::size_t)size;
+
+	// the lattice axis values, as the input of the first node
+	std::vector<float> identity(3 * axisSize);
+	const std::vector<double> indices = LUTHelper::indicesDoubleVector(0, 1, size);
+	for (std::size_t i = 0; i < axisSize; i++)
+	{
+		identity[i] = identity[axisSize + i] = identity[2 * axisSize + i]
+			= (float)(inputLowerBound + indices[i] * (inputUpperBound - inputLowerBound));
+	}
+
+	for (std::size_t n = upToDateCount; n < nodes.size(); n++)
+	{
+		const LUTBakeStage & node = *nodes[n];
+		const std::vector<float> & input = (n == 0) ? identity : outputs[n - 1];
+		std::vector<float> & output = outputs[n];
+		if (n < axisNodeCount)
+		{
+			output = input;
+			float * const planes[3] = { &output[0], &output[axisSize], &output[2 * axisSize] };
+			node.applyToPlanes(planes, axisSize);
+			continue;
+		}
+
+		const bool inputIsAxes = n <= axisNodeCount;
+		output.resize(3 * pointCount);
+		LUTHelper::LUT3DConcurrentRangeLoop(size, [&](std::size_t begin, std::size_t end)
+		{
+			float * const planes[3] = { &output[begin], &output[pointCount + begin], &output[2 * pointCount + begin] };
+			if (inputIsAxes)
+			{
+				for (std::size_t i = begin; i < end; i++)
+				{
+					planes[0][i - begin] = input[i % axisSize];
+					planes[1][i - begin] = input[axisSize + (i / axisSize) % axisSize];
+					planes[2][i - begin] = input[2 * axisSize + i / (axisSize * axisSize)];
+				}
+			}
+			else
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					std::copy(&input[c * pointCount + begin], &input[c * pointCount + end], planes[c]);
+				}
+			}
+			node.applyToPlanes(planes, end - begin);
+		});
+	}
+	upToDateCount = nodes.size();
+}
+
+template <typename T>
+BasicLUT3D<T> LUTBakeGraph::bakeLUT3D()
+{
+	if (nodes.empty())
+	{
+		return BasicLUT3D<T>::identityOfSize(size, inputLowerBound, inputUpperBound);
+	}
+	update();
+
+	BasicLUT3D<T> lut = BasicLUT3D<T>::withSize(size, inputLowerBound, inputUpperBound);
+
+	const std::size_t pointCount = lut.getPointCount();
+	const std::size_t axisSize = (std::size_t)size;
+	const std::vector<float> & result = outputs.back();
+	const bool resultIsAxes = nodes.size() <= axisNodeCount;
+	T * const planes[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+	LUTHelper::LUT3DConcurrentRangeLoop(size, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; i++)
+		{
+			if (resultIsAxes)
+			{
+				planes[0][i] = (T)result[i % axisSize];
+				planes[1][i] = (T)result[axisSize + (i / axisSize) % axisSize];
+				planes[2][i] = (T)result[2 * axisSize + i / (axisSize * axisSize)];
+			}
+			else
+			{
+				planes[0][i] = (T)result[i];
+				planes[1][i] = (T)result[pointCount + i];
+				planes[2][i] = (T)result[2 * pointCount + i];
+			}
+		}
+	});
+	return lut;
+}
+
+namespace CppLUT
+{
+template LUT3Df LUTBakeGraph::bakeLUT3D<float>();
+template LUT3D LUTBakeGraph::bakeLUT3D<double>();
+template LUT3Dh LUTBakeGraph::bakeLUT3D<LUTHalf>();
+}
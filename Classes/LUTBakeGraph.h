@@ -0,0 +1,219 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+#include "LUTColorSpace.h"
+#include "LUTMatrix3.h"
+
+#include <cstddef> // std::size_t
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+
+namespace CppLUT
+{
+
+struct LUTBakeStage;
+
+/**
+ * @brief      A chain of grading nodes baked into a LUT3D of a fixed size,
+ *             where changing one node's parameters only re-bakes the nodes
+ *             after it.
+ * @discussion Every node keeps the lattice it produced on the last bake.
+ *             Changing a node marks it and every later node out of date;
+ *             the next bake resumes from the output of the last node still
+ *             up to date. Nodes at the start of the graph that map each
+ *             channel on its own (LUT1Ds and slope, offset, power) only ever
+ *             see the lattice axis values, so they are evaluated and cached
+ *             per axis rather than per lattice point. The remaining nodes
+ *             run over ranges of lattice points spread over
+ *             `LUTHelper::concurrency()` threads.
+ *
+ *             Nodes are addressed by the index their append method returns.
+ *             A graph is not safe to use from several threads at once, since
+ *             baking updates its caches.
+ */
+class LUTBakeGraph
+{
+public:
+	/**
+	 * @brief      Creates an empty graph that bakes cubes of one size
+	 *
+	 * @throws     std::domain_error  If size is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE` or the bounds
+	 *                                are inverted
+	 *
+	 * @param[in]  size             The edge length of the baked cube
+	 * @param[in]  inputLowerBound  The input value of the first lattice point
+	 * @param[in]  inputUpperBound  The input value of the last lattice point
+	 *
+	 * @return     The graph
+	 */
+	static LUTBakeGraph withSize(int size, double inputLowerBound = 0, double inputUpperBound = 1);
+
+	/**
+	 * @brief      Appends a LUT1D applied to each channel
+	 *
+	 * @param[in]  lut   The LUT
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendLUT1D(const LUT1Df & lut);
+	std::size_t appendLUT1D(const LUT1D & lut);
+	std::size_t appendLUT1D(const LUT1Dh & lut);
+
+	/**
+	 * @brief      Appends a LUT3D
+	 *
+	 * @param[in]  lut            The LUT
+	 * @param[in]  interpolation  The interpolation method used to apply it
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendLUT3D(const LUT3Df & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+	std::size_t appendLUT3D(const LUT3D & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+	std::size_t appendLUT3D(const LUT3Dh & lut, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      Appends a 3x3 matrix applied to every color
+	 *
+	 * @param[in]  matrix  The matrix
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendMatrix(const LUTMatrix3 & matrix);
+
+	/**
+	 * @brief      Appends a conversion of linear color from one color space
+	 *             to another, as a matrix node
+	 *
+	 * @see        LUTBakeChain::appendColorSpaceConversion
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendColorSpaceConversion(const LUTColorSpace & sourceColorSpace,
+	                                       const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                       const LUTColorSpace & destinationColorSpace,
+	                                       const LUTColorSpaceWhitePoint & destinationWhitePoint,
+	                                       bool useBradfordMatrix);
+
+	/**
+	 * @brief      Appends an ASC CDL slope, offset and power
+	 *
+	 * @see        LUTColor::applySlopeOffsetPower
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendSlopeOffsetPower(double redSlope, double redOffset, double redPower,
+	                                   double greenSlope, double greenOffset, double greenPower,
+	                                   double blueSlope, double blueOffset, double bluePower);
+
+	/**
+	 * @brief      Appends a saturation change around a weighted luma
+	 *
+	 * @see        LUTColor::changeSaturation
+	 *
+	 * @return     The index of the new node
+	 */
+	std::size_t appendSaturation(double saturation, double lumaR, double lumaG, double lumaB);
+
+	/**
+	 * @brief      Replaces the matrix of a matrix node
+	 *
+	 * @throws     std::domain_error  If `node` is not a matrix node
+	 *
+	 * @param[in]  node    The index of the node
+	 * @param[in]  matrix  The new matrix
+	 */
+	void setMatrix(std::size_t node, const LUTMatrix3 & matrix);
+
+	/**
+	 * @brief      Replaces the parameters of a slope, offset and power node
+	 *
+	 * @throws     std::domain_error  If `node` is not a slope, offset and
+	 *                                power node
+	 *
+	 * @see        LUTColor::applySlopeOffsetPower
+	 */
+	void setSlopeOffsetPower(std::size_t node,
+	                         double redSlope, double redOffset, double redPower,
+	                         double greenSlope, double greenOffset, double greenPower,
+	                         double blueSlope, double blueOffset, double bluePower);
+
+	/**
+	 * @brief      Replaces the parameters of a saturation node
+	 *
+	 * @throws     std::domain_error  If `node` is not a saturation node
+	 *
+	 * @see        LUTColor::changeSaturation
+	 */
+	void setSaturation(std::size_t node, double saturation, double lumaR, double lumaG, double lumaB);
+
+	/**
+	 * @brief      The number of nodes
+	 */
+	std::size_t getNodeCount() const { return nodes.size(); }
+
+	/**
+	 * @brief      The number of nodes the next bake will evaluate
+	 */
+	std::size_t getOutdatedNodeCount() const { return nodes.size() - upToDateCount; }
+
+	/**
+	 * @brief      Bakes the graph into a LUT3D, evaluating only the nodes
+	 *             changed or appended since the last bake
+	 *
+	 * @tparam     T     The lattice value type of the baked cube
+	 *
+	 * @return     The baked LUT
+	 */
+	template <typename T = LUTColorValue>
+	BasicLUT3D<T> bakeLUT3D();
+
+private:
+	LUTBakeGraph(int size, double inputLowerBound, double inputUpperBound);
+
+	/** @brief      Stores a new node and returns its index */
+	std::size_t append(const std::shared_ptr<const LUTBakeStage> & node);
+
+	/** @brief      Swaps in a changed node of the same kind and marks it out of date */
+	void replace(std::size_t index, const std::shared_ptr<const LUTBakeStage> & node);
+
+	/** @brief      Brings every node's cache up to date */
+	void update();
+
+	/** @brief      The edge length of the baked cube */
+	int size;
+
+	/** @brief      The input value of the first lattice point */
+	double inputLowerBound;
+
+	/** @brief      The input value of the last lattice point */
+	double inputUpperBound;
+
+	/**
+	 * @brief      The nodes in the order they are applied, as the same
+	 *             stages `LUTBakeChain` uses. Stages are immutable; setting new
+	 *             parameters replaces the node.
+	 */
+	std::vector<std::shared_ptr<const LUTBakeStage>> nodes;
+
+	/**
+	 * @brief      The output of each node as red, green and blue planes, each
+	 *             `size` values long for the leading per-axis nodes and
+	 *             `size ^ 3` values long for the rest
+	 */
+	std::vector<std::vector<float>> outputs;
+
+	/** @brief      The number of leading nodes evaluated per axis */
+	std::size_t axisNodeCount;
+
+	/** @brief      The number of leading nodes whose output is up to date */
+	std::size_t upToDateCount;
+};
+
+extern template LUT3Df LUTBakeGraph::bakeLUT3D<float>();
+extern template LUT3D LUTBakeGraph::bakeLUT3D<double>();
+extern template LUT3Dh LUTBakeGraph::bakeLUT3D<LUTHalf>();
+
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+#include "LUTColorOps.h"
+#include "LUTMatrix3.h"
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      One step of a `LUTBakeChain` or `LUTBakeGraph`, shared by both.
+ * @discussion Stages are immutable and evaluate in single precision.
+ *             Separable stages map each channel on its own, so they can run
+ *             on the lattice axes alone.
+ */
+struct LUTBakeStage
+{
+	enum class Kind
+	{
+		LUT1D,
+		LUT3D,
+		Matrix,
+		SlopeOffsetPower,
+		Saturation
+	};
+
+	/** @brief      The number of pixels passed through the stages at a time */
+	static const std::size_t blockPixels = 1024;
+
+	virtual ~LUTBakeStage() {}
+
+	virtual Kind kind() const = 0;
+
+	/** @brief      Maps a span of interleaved pixels, in place */
+	virtual void apply(float * pixels, std::size_t pixelCount, std::size_t pixelStride) const = 0;
+
+	/** @brief      Maps `count` colors held in three planes, in place */
+	virtual void applyToPlanes(float * const planes[3], std::size_t count) const = 0;
+
+	virtual bool isSeparable() const { return false; }
+
+	/** @brief      The stage's matrix, or nullptr if it is not a matrix stage */
+	virtual const LUTMatrix3 * matrix() const { return nullptr; }
+
+	/** @brief      Describes a kind of stage, for error messages */
+	static const char * nameOfKind(Kind kind)
+	{
+		switch (kind)
+		{
+			case Kind::LUT1D: return "LUT1D";
+			case Kind::LUT3D: return "LUT3D";
+			case Kind::Matrix: return "matrix";
+			case Kind::SlopeOffsetPower: return "slope, offset and power";
+			case Kind::Saturation: return "saturation";
+		}
+		return "unknown";
+	}
+};
+
+template <typename T>
+struct LUTBakeLUT1DStage: LUTBakeStage
+{
+	BasicLUT1D<T> lut;
+
+	explicit LUTBakeLUT1DStage(const BasicLUT1D<T> & lut): lut(lut) {}
+
+	Kind kind() const override { return Kind::LUT1D; }
+
+	void apply(float * pixels, std::size_t pixelCount, std::size_t pixelStride) const override
+	{
+		lut.apply(pixels, pixels, pixelCount, pixelStride);
+	}
+
+	void applyToPlanes(float * const planes[3], std::size_t count) const override
+	{
+		const float * const input[3] = { planes[0], planes[1], planes[2] };
+		lut.applyToPlanes(input, planes, count);
+	}
+
+	bool isSeparable() const override { return true; }
+};
+
+template <typename T>
+struct LUTBakeLUT3DStage: LUTBakeStage
+{
+	BasicLUT3D<T> lut;
+	LUT3DInterpolation interpolation;
+
+	LUTBakeLUT3DStage(const BasicLUT3D<T> & lut, LUT3DInterpolation interpolation): lut(lut), interpolation(interpolation) {}
+
+	Kind kind() const override { return Kind::LUT3D; }
+
+	void apply(float * pixels, std::size_t pixelCount, std::size_t pixelStride) const override
+	{
+		lut.apply(pixels, pixels, pixelCount, interpolation, pixelStride);
+	}
+
+	void applyToPlanes(float * const planes[3], std::size_t count) const override
+	{
+		float pixels[3 * blockPixels];
+		for (std::size_t blockBegin = 0; blockBegin < count; blockBegin += blockPixels)
+		{
+			const std::size_t blockCount = (count - blockBegin < blockPixels) ? count - blockBegin : blockPixels;
+			for (std::size_t i = 0; i < blockCount; i++)
+			{
+				pixels[3 * i] = planes[0][blockBegin + i];
+				pixels[3 * i + 1] = planes[1][blockBegin + i];
+				pixels[3 * i + 2] = planes[2][blockBegin + i];
+			}
+			lut.apply(pixels, pixels, blockCount, interpolation);
+			for (std::size_t i = 0; i < blockCount; i++)
+			{
+				planes[0][blockBegin + i] = pixels[3 * i];
+				planes[1][blockBegin + i] = pixels[3 * i + 1];
+				planes[2][blockBegin + i] = pixels[3 * i + 2];
+			}
+		}
+	}
+};
+
+struct LUTBakeMatrixStage: LUTBakeStage
+{
+	LUTMatrix3 m;
+
+	explicit LUTBakeMatrixStage(const LUTMatrix3 & m): m(m) {}
+
+	Kind kind() const override { return Kind::Matrix; }
+
+	void apply(float * pixels, std::size_t pixelCount, std::size_t pixelStride) const override
+	{
+		for (std::size_t p = 0; p < pixelCount; p++, pixels += pixelStride)
+		{
+			applyToColor(pixels[0], pixels[1], pixels[2]);
+		}
+	}
+
+	void applyToPlanes(float * const planes[3], std::size_t count) const override
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			applyToColor(planes[0][i], planes[1][i], planes[2][i]);
+		}
+	}
+
+	const LUTMatrix3 * matrix() const override { return &m; }
+
+private:
+	void applyToColor(float & r, float & g, float & b) const
+	{
+		const double in[3] = { r, g, b };
+		double out[3];
+		m.apply(in, out);
+		r = (float)out[0];
+		g = (float)out[1];
+		b = (float)out[2];
+	}
+};
+
+/**
+ * @brief      A stage running one `LUTColorOps` operation
+ *
+ * @tparam     Op        The operation on float channels
+ * @tparam     OpKind    The kind reported for the stage
+ * @tparam     Separable Whether the operation maps each channel on its own
+ */
+template <typename Op, LUTBakeStage::Kind OpKind, bool Separable>
+struct LUTBakeOpStage: LUTBakeStage
+{
+	Op op;
+
+	explicit LUTBakeOpStage(const Op & op): op(op) {}
+
+	Kind kind() const override { return OpKind; }
+
+	void apply(float * pixels, std::size_t pixelCount, std::size_t pixelStride) const override
+	{
+		for (std::size_t p = 0; p < pixelCount; p++, pixels += pixelStride)
+		{
+			op(pixels[0], pixels[1], pixels[2]);
+		}
+	}
+
+	void applyToPlanes(float * const planes[3], std::size_t count) const override
+	{
+		LUTColorOps::applyToPlanes(op, planes[0], planes[1], planes[2], count);
+	}
+
+	bool isSeparable() const override { return Separable; }
+};
+
+typedef LUTBakeOpStage<LUTColorOps::SlopeOffsetPowerOp<float>, LUTBakeStage::Kind::SlopeOffsetPower, true> LUTBakeSlopeOffsetPowerStage;
+typedef LUTBakeOpStage<LUTColorOps::SaturationOp<float>, LUTBakeStage::Kind::Saturation, false> LUTBakeSaturationStage;
+
+}
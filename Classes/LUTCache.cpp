@@ -0,0 +1,107 @@
+#include "LUTCache.h"
+#include "LUTFormatterBinary.h"
+#include "LUTFormatterCube.h"
+#include "LUTHelper.h"
+#include "LUTMappedFile.h"
+
+#include <map> // std::map
+#include <mutex> // std::mutex std::lock_guard
+#include <set> // std::set
+
+using namespace CppLUT;
+
+namespace
+{
+
+/**
+ * @brief      The cache's entries. A LUT can be reachable from several keys:
+ *             the hash of each file it was loaded from and its lattice hash.
+ */
+struct CacheEntries
+{
+	std::mutex mutex;
+	std::map<std::uint64_t, std::shared_ptr<const LUT3Df>> byKey;
+};
+
+CacheEntries & cacheEntries()
+{
+	static CacheEntries entries;
+	return entries;
+}
+
+std::shared_ptr<const LUT3Df> find(std::uint64_t key)
+{
+	CacheEntries & entries = cacheEntries();
+	std::lock_guard<std::mutex> lock(entries.mutex);
+	auto found = entries.byKey.find(key);
+	return (found != entries.byKey.end()) ? found->second : std::shared_ptr<const LUT3Df>();
+}
+
+/**
+ * @brief      Records a freshly loaded LUT under its file key and lattice key,
+ *             and returns the resident LUT for that lattice, which is an
+ *             earlier copy if another thread or file got there first.
+ */
+std::shared_ptr<const LUT3Df> insert(std::uint64_t fileKey, std::uint64_t latticeKey,
+                                     const std::shared_ptr<const LUT3Df> & lut)
+{
+	CacheEntries & entries = cacheEntries();
+	std::lock_guard<std::mutex> lock(entries.mutex);
+	std::shared_ptr<const LUT3Df> & resident = entries.byKey[latticeKey];
+	if (!resident)
+	{
+		resident = lut;
+	}
+	entries.byKey[fileKey] = resident;
+	return resident;
+}
+
+}
+
+std::shared_ptr<const LUT3Df> LUTCache::lut3DFromFile(const std::string & path)
+{
+	LUTMappedFile file = LUTMappedFile::withPath(path);
+	if (LUTFormatterBinary::isBinaryData(file.data(), file.size()))
+	{
+		const std::uint64_t latticeKey = LUTFormatterBinary::storedContentHash(file.data(), file.size());
+		std::shared_ptr<const LUT3Df> resident = find(latticeKey);
+		if (resident)
+		{
+			return resident;
+		}
+		std::shared_ptr<const LUT3Df> lut = std::make_shared<const LUT3Df>(
+			LUTFormatterBinary::readLUT3DFromData<float>(file.data(), file.size()));
+		return insert(latticeKey, latticeKey, lut);
+	}
+
+	// salted so a file key and a lattice key are unlikely to collide; as
+	// with any 64-bit hash a collision is possible, just improbable
+	const std::uint64_t fileKey = LUTHelper::hashBytes(file.data(), file.size(), 0x637562650ULL);
+	std::shared_ptr<const LUT3Df> resident = find(fileKey);
+	if (resident)
+	{
+		return resident;
+	}
+	std::shared_ptr<const LUT3Df> lut = std::make_shared<const LUT3Df>(
+		LUTFormatterCube::readLUT3DFromData<float>(file.data(), file.size()));
+	return insert(fileKey, LUTFormatterBinary::contentHash(*lut), lut);
+}
+
+std::size_t LUTCache::residentCount()
+{
+	CacheEntries & entries = cacheEntries();
+	std::lock_guard<std::mutex> lock(entries.mutex);
+	std::set<const LUT3Df *> distinct;
+	for (const auto & entry : entries.byKey)
+	{
+		distinct.insert(entry.second.get());
+	}
+	return distinct.size();
+}
+
+void LUTCache::clear()
+{
+	CacheEntries & entries = cacheEntries();
+	std::lock_guard<std::mutex> lock(entries.mutex);
+	entries.byKey.clear();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT3D.h"
+
+#include <cstddef> // std::size_t
+#include <memory> // std::shared_ptr
+#include <string> // std::string
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A process-wide cache of loaded LUTs, keyed by content hash.
+ * @discussion Loading a file maps it and hashes its bytes with
+ *             `LUTHelper::hashBytes`. A .cube file whose bytes have been
+ *             seen before skips parsing, and a binary file is looked up by
+ *             the lattice hash in its header. Parsed lattices are also
+ *             recorded under their lattice hash, so a .cube file and the
+ *             binary snapshot of it share one resident LUT. Keys are 64-bit
+ *             hashes, so distinct contents sharing a key, while unlikely, would
+ *             return the first LUT loaded under it.
+ *
+ *             The cache never evicts: every distinct LUT loaded stays
+ *             resident, and memory is only freed by `clear()`. All functions
+ *             are safe to call from several threads.
+ */
+class LUTCache
+{
+public:
+	LUTCache() = delete;
+
+	/**
+	 * @brief      Loads a LUT3D from a .cube or binary file, or returns the
+	 *             resident copy of one with the same content.
+	 *
+	 * @throws     std::runtime_error  If the file cannot be read
+	 * @throws     std::domain_error   If the file is not a valid .cube or
+	 *                                 binary 3D LUT
+	 *
+	 * @param[in]  path  The path of the file
+	 *
+	 * @return     The shared, immutable LUT
+	 */
+	static std::shared_ptr<const LUT3Df> lut3DFromFile(const std::string & path);
+
+	/**
+	 * @brief      The number of distinct LUTs currently resident
+	 */
+	static std::size_t residentCount();
+
+	/**
+	 * @brief      Drops every cached LUT. LUTs still referenced elsewhere stay
+	 *             alive until those references are released.
+	 */
+	static void clear();
+};
+
+}
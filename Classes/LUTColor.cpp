@@ -6,133 +6,150 @@
 
 using namespace CppLUT;
 
-LUTColor::LUTColor(LUTColorValue r, LUTColorValue g, LUTColorValue b):
-                   red(!std::isfinite(r) ? 0 : r),
-                   green(!std::isfinite(g) ? 0 : g),
-                   blue(!std::isfinite(b) ? 0 : b)
+template <typename T>
+BasicLUTColor<T>::BasicLUTColor(T r, T g, T b):
+                                red(!std::isfinite((ComputeType)r) ? T(0) : r),
+                                green(!std::isfinite((ComputeType)g) ? T(0) : g),
+                                blue(!std::isfinite((ComputeType)b) ? T(0) : b)
 {}
 
-LUTColor LUTColor::colorWithRGB(LUTColorValue r, LUTColorValue g, LUTColorValue b)
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorWithRGB(T r, T g, T b)
 {
-	return LUTColor(r, g, b);
+	return BasicLUTColor(r, g, b);
 }
 
-LUTColor LUTColor::colorWithZeroes()
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorWithZeroes()
 {
 	return colorWithValue(0);
 }
-LUTColor LUTColor::colorWithOnes()
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorWithOnes()
 {
 	return colorWithValue(1);
 }
-LUTColor LUTColor::colorWithValue(double value)
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorWithValue(double value)
 {
-	return LUTColor(value, value, value);
+	return BasicLUTColor((T)value, (T)value, (T)value);
 }
 
-LUTColor LUTColor::colorFromIntegersWithBitdepth(int bitdepth, int r, int g, int b)
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorFromIntegersWithBitdepth(int bitdepth, int r, int g, int b)
 {
 	unsigned maxBits = LUTHelper::maxIntegerFromBitdepth(bitdepth);
-	return LUTColor::colorWithRGB(LUTHelper::remapInt01(r, maxBits),
-		                          LUTHelper::remapInt01(g, maxBits),
-		                          LUTHelper::remapInt01(b, maxBits));
+	return BasicLUTColor::colorWithRGB(LUTHelper::remapInt01<ComputeType>(r, maxBits),
+		                               LUTHelper::remapInt01<ComputeType>(g, maxBits),
+		                               LUTHelper::remapInt01<ComputeType>(b, maxBits));
 }
 
-LUTColor LUTColor::colorFromIntegersWithMaxOutputValue(int maxOutputValue, int r, int g, int b)
+template <typename T>
+BasicLUTColor<T> BasicLUTColor<T>::colorFromIntegersWithMaxOutputValue(int maxOutputValue, int r, int g, int b)
 {
-	return LUTColor::colorWithRGB(LUTHelper::remapInt01(r, maxOutputValue),
-		                          LUTHelper::remapInt01(g, maxOutputValue),
-	                              LUTHelper::remapInt01(b, maxOutputValue));
+	return BasicLUTColor::colorWithRGB(LUTHelper::remapInt01<ComputeType>(r, maxOutputValue),
+		                               LUTHelper::remapInt01<ComputeType>(g, maxOutputValue),
+	                                   LUTHelper::remapInt01<ComputeType>(b, maxOutputValue));
 }
 
-double LUTColor::minimumValue() const
+template <typename T>
+double BasicLUTColor<T>::minimumValue() const
 {
-	return std::min(std::min(red, green), blue);
+	return std::min(std::min((ComputeType)red, (ComputeType)green), (ComputeType)blue);
 }
-double LUTColor::maximumValue() const
+template <typename T>
+double BasicLUTColor<T>::maximumValue() const
 {
-	return std::max(std::max(red, green), blue);
+	return std::max(std::max((ComputeType)red, (ComputeType)green), (ComputeType)blue);
 }
 
-void LUTColor::clamp01()
+template <typename T>
+void BasicLUTColor<T>::clamp01()
 {
-	red = LUTHelper::clamp01(red);
-	green = LUTHelper::clamp01(green);
-	blue = LUTHelper::clamp01(blue);
+	red = LUTHelper::clamp01<ComputeType>(red);
+	green = LUTHelper::clamp01<ComputeType>(green);
+	blue = LUTHelper::clamp01<ComputeType>(blue);
 }
 
-void LUTColor::clampToBounds(double lowerBound, double upperBound)
+template <typename T>
+void BasicLUTColor<T>::clampToBounds(double lowerBound, double upperBound)
 {
-	red = LUTHelper::clamp(red, lowerBound, upperBound);
-	green = LUTHelper::clamp(green, lowerBound, upperBound);
-	blue = LUTHelper::clamp(blue, lowerBound, upperBound);
+	red = LUTHelper::clamp<ComputeType>(red, lowerBound, upperBound);
+	green = LUTHelper::clamp<ComputeType>(green, lowerBound, upperBound);
+	blue = LUTHelper::clamp<ComputeType>(blue, lowerBound, upperBound);
 }
 
-void LUTColor::clampToLowerBound(double lowerBound)
+template <typename T>
+void BasicLUTColor<T>::clampToLowerBound(double lowerBound)
 {
-	red = LUTHelper::clampLowerBound(red, lowerBound);
-	green = LUTHelper::clampLowerBound(green, lowerBound);
-	blue = LUTHelper::clampLowerBound(blue, lowerBound);
+	red = LUTHelper::clampLowerBound<ComputeType>(red, lowerBound);
+	green = LUTHelper::clampLowerBound<ComputeType>(green, lowerBound);
+	blue = LUTHelper::clampLowerBound<ComputeType>(blue, lowerBound);
 }
 
-void LUTColor::clampToUpperBound(double upperBound)
+template <typename T>
+void BasicLUTColor<T>::clampToUpperBound(double upperBound)
 {
-	red = LUTHelper::clampUpperBound(red, upperBound);
-	green = LUTHelper::clampUpperBound(green, upperBound);
-	blue = LUTHelper::clampUpperBound(blue, upperBound);
+	red = LUTHelper::clampUpperBound<ComputeType>(red, upperBound);
+	green = LUTHelper::clampUpperBound<ComputeType>(green, upperBound);
+	blue = LUTHelper::clampUpperBound<ComputeType>(blue, upperBound);
 }
 
-void LUTColor::remapContrast(double inputLow, double inputHigh, double outputLow, double outputHigh, bool bounded)
+template <typename T>
+void BasicLUTColor<T>::remapContrast(double inputLow, double inputHigh, double outputLow, double outputHigh, bool bounded)
 {
 	if (!bounded)
 	{
-		red = LUTHelper::remapNoError(red, inputLow, inputHigh, outputLow, outputHigh);
-		green = LUTHelper::remapNoError(green, inputLow, inputHigh, outputLow, outputHigh);
-		blue = LUTHelper::remapNoError(blue, inputLow, inputHigh, outputLow, outputHigh);
+		red = LUTHelper::remapNoError<ComputeType>(red, inputLow, inputHigh, outputLow, outputHigh);
+		green = LUTHelper::remapNoError<ComputeType>(green, inputLow, inputHigh, outputLow, outputHigh);
+		blue = LUTHelper::remapNoError<ComputeType>(blue, inputLow, inputHigh, outputLow, outputHigh);
 	}
 	else
 	{
-		red = LUTHelper::remap(red, inputLow, inputHigh, outputLow, outputHigh);
-		green = LUTHelper::remap(green, inputLow, inputHigh, outputLow, outputHigh);
-		blue = LUTHelper::remap(blue, inputLow, inputHigh, outputLow, outputHigh);
+		red = LUTHelper::remap<ComputeType>(red, inputLow, inputHigh, outputLow, outputHigh);
+		green = LUTHelper::remap<ComputeType>(green, inputLow, inputHigh, outputLow, outputHigh);
+		blue = LUTHelper::remap<ComputeType>(blue, inputLow, inputHigh, outputLow, outputHigh);
 	}
 }
 
-void LUTColor::remapBetweenColors(const LUTColor &  inputLowColor, const LUTColor & inputHighColor,
-                                  const LUTColor & outputLowColor, const LUTColor & outputHighColor,
-                                  bool bounded)
+template <typename T>
+void BasicLUTColor<T>::remapBetweenColors(const BasicLUTColor & inputLowColor, const BasicLUTColor & inputHighColor,
+                                          const BasicLUTColor & outputLowColor, const BasicLUTColor & outputHighColor,
+                                          bool bounded)
 {
 	if (!bounded)
 	{
-		red = LUTHelper::remapNoError(red, inputLowColor.red, inputHighColor.red,
-		                              outputLowColor.red, outputHighColor.red);
-		green = LUTHelper::remapNoError(green, inputLowColor.green, inputHighColor.green,
-		                                outputLowColor.green, outputHighColor.green);
-		blue = LUTHelper::remapNoError(blue, inputLowColor.blue, inputHighColor.blue,
-		                               outputLowColor.blue, outputHighColor.blue);
+		red = LUTHelper::remapNoError<ComputeType>(red, inputLowColor.red, inputHighColor.red,
+		                                           outputLowColor.red, outputHighColor.red);
+		green = LUTHelper::remapNoError<ComputeType>(green, inputLowColor.green, inputHighColor.green,
+		                                             outputLowColor.green, outputHighColor.green);
+		blue = LUTHelper::remapNoError<ComputeType>(blue, inputLowColor.blue, inputHighColor.blue,
+		                                            outputLowColor.blue, outputHighColor.blue);
 	}
 	else
 	{
-		red = LUTHelper::remap(red, inputLowColor.red, inputHighColor.red,
-		                       outputLowColor.red, outputHighColor.red);
-		green = LUTHelper::remap(green, inputLowColor.green, inputHighColor.green,
-		                         outputLowColor.green, outputHighColor.green);
-		blue = LUTHelper::remap(blue, inputLowColor.blue, inputHighColor.blue,
-		                        outputLowColor.blue, outputHighColor.blue);
+		red = LUTHelper::remap<ComputeType>(red, inputLowColor.red, inputHighColor.red,
+		                                    outputLowColor.red, outputHighColor.red);
+		green = LUTHelper::remap<ComputeType>(green, inputLowColor.green, inputHighColor.green,
+		                                      outputLowColor.green, outputHighColor.green);
+		blue = LUTHelper::remap<ComputeType>(blue, inputLowColor.blue, inputHighColor.blue,
+		                                     outputLowColor.blue, outputHighColor.blue);
 	}
 }
 
-void LUTColor::lerpTo(const LUTColor & otherColor, double amount)
+template <typename T>
+void BasicLUTColor<T>::lerpTo(const BasicLUTColor & otherColor, double amount)
 {
-	red = LUTHelper::lerp1d(red, otherColor.red, amount);
-	green = LUTHelper::lerp1d(green, otherColor.green, amount);
-	blue = LUTHelper::lerp1d(blue, otherColor.blue, amount);
+	red = LUTHelper::lerp1d<ComputeType>(red, otherColor.red, amount);
+	green = LUTHelper::lerp1d<ComputeType>(green, otherColor.green, amount);
+	blue = LUTHelper::lerp1d<ComputeType>(blue, otherColor.blue, amount);
 }
 
 //thanks http://en.wikipedia.org/wiki/ASC_CDL
-void LUTColor::applySlopeOffsetPower(double redSlope, double redOffset, double redPower,
-                                     double greenSlope, double greenOffset, double greenPower,
-                                     double blueSlope, double blueOffset, double bluePower)
+template <typename T>
+void BasicLUTColor<T>::applySlopeOffsetPower(double redSlope, double redOffset, double redPower,
+                                             double greenSlope, double greenOffset, double greenPower,
+                                             double blueSlope, double blueOffset, double bluePower)
 {
 	redSlope = LUTHelper::clampLowerBound(redSlope, 0);
 	redPower = LUTHelper::clampLowerBound(redPower, 0);
@@ -141,68 +158,77 @@ void LUTColor::applySlopeOffsetPower(double redSlope, double redOffset, double r
 	blueSlope = LUTHelper::clampLowerBound(blueSlope, 0);
 	bluePower = LUTHelper::clampLowerBound(bluePower, 0);
 
-	red = std::pow(red*redSlope + redOffset, redPower);
-	green = std::pow(green*greenSlope + greenOffset, greenPower);
-	blue = std::pow(blue*blueSlope + blueOffset, bluePower);
+	red = std::pow((ComputeType)(red*redSlope + redOffset), (ComputeType)redPower);
+	green = std::pow((ComputeType)(green*greenSlope + greenOffset), (ComputeType)greenPower);
+	blue = std::pow((ComputeType)(blue*blueSlope + blueOffset), (ComputeType)bluePower);
 }
 
-double LUTColor::distanceToColor(const LUTColor & otherColor) const
+template <typename T>
+double BasicLUTColor<T>::distanceToColor(const BasicLUTColor & otherColor) const
 {
     return std::sqrt(std::pow(red - otherColor.red, 2)
                      + std::pow(green - otherColor.green, 2)
                      + std::pow(blue - otherColor.blue, 2));
 }
 
-double LUTColor::luminanceRec709() const
+template <typename T>
+double BasicLUTColor<T>::luminanceRec709() const
 {
 	return luminanceUsingLuma(0.2126, 0.7152, 0.0722);
 }
 
-double LUTColor::luminanceUsingLuma(double lumaR, double lumaG, double lumaB) const
+template <typename T>
+double BasicLUTColor<T>::luminanceUsingLuma(double lumaR, double lumaG, double lumaB) const
 {
 	return (red*lumaR + green*lumaB + blue*lumaB);
 }
 
-void LUTColor::contrastStretchWithRange(double currentMin, double currentMax, double finalMin, double finalMax)
+template <typename T>
+void BasicLUTColor<T>::contrastStretchWithRange(double currentMin, double currentMax, double finalMin, double finalMax)
 {
-	red = LUTHelper::contrastStretch(red, currentMin, currentMax, finalMin, finalMax);
-	green = LUTHelper::contrastStretch(green, currentMin, currentMax, finalMin, finalMax);
-	blue = LUTHelper::contrastStretch(blue, currentMin, currentMax, finalMin, finalMax);
+	red = LUTHelper::contrastStretch<ComputeType>(red, currentMin, currentMax, finalMin, finalMax);
+	green = LUTHelper::contrastStretch<ComputeType>(green, currentMin, currentMax, finalMin, finalMax);
+	blue = LUTHelper::contrastStretch<ComputeType>(blue, currentMin, currentMax, finalMin, finalMax);
 }
 
-LUTColor & LUTColor::operator*=(double number)
+template <typename T>
+BasicLUTColor<T> & BasicLUTColor<T>::operator*=(double number)
 {
-	red *= number;
-	green *= number;
-	blue *= number;
+	red = (ComputeType)red * (ComputeType)number;
+	green = (ComputeType)green * (ComputeType)number;
+	blue = (ComputeType)blue * (ComputeType)number;
 	return *this;
 }
 
-LUTColor & LUTColor::operator*=(const LUTColor & offsetColor)
+template <typename T>
+BasicLUTColor<T> & BasicLUTColor<T>::operator*=(const BasicLUTColor & offsetColor)
 {
-	red *= offsetColor.red;
-	green *= offsetColor.green;
-	blue *= offsetColor.blue;
+	red = (ComputeType)red * (ComputeType)offsetColor.red;
+	green = (ComputeType)green * (ComputeType)offsetColor.green;
+	blue = (ComputeType)blue * (ComputeType)offsetColor.blue;
 	return *this;
 }
 
-LUTColor & LUTColor::operator+=(const LUTColor & offsetColor)
+template <typename T>
+BasicLUTColor<T> & BasicLUTColor<T>::operator+=(const BasicLUTColor & offsetColor)
 {
-	red += offsetColor.red;
-	green += offsetColor.green;
-	blue += offsetColor.blue;
+	red = (ComputeType)red + (ComputeType)offsetColor.red;
+	green = (ComputeType)green + (ComputeType)offsetColor.green;
+	blue = (ComputeType)blue + (ComputeType)offsetColor.blue;
 	return *this;
 }
 
-LUTColor & LUTColor::operator-=(const LUTColor & offsetColor)
+template <typename T>
+BasicLUTColor<T> & BasicLUTColor<T>::operator-=(const BasicLUTColor & offsetColor)
 {
-	red -= offsetColor.red;
-	green -= offsetColor.green;
-	blue -= offsetColor.blue;
+	red = (ComputeType)red - (ComputeType)offsetColor.red;
+	green = (ComputeType)green - (ComputeType)offsetColor.green;
+	blue = (ComputeType)blue - (ComputeType)offsetColor.blue;
 	return *this;
 }
 
-void LUTColor::invertColorWithRange(double minimumValue, double maximumValue)
+template <typename T>
+void BasicLUTColor<T>::invertColorWithRange(double minimumValue, double maximumValue)
 {
 	double distance = std::abs(maximumValue-minimumValue);
 	red = distance - red;
@@ -210,10 +236,18 @@ void LUTColor::invertColorWithRange(double minimumValue, double maximumValue)
 	blue = distance - blue;
 }
 
-void LUTColor::changeSaturation(double saturation, double lumaR, double lumaG, double lumaB)
+template <typename T>
+void BasicLUTColor<T>::changeSaturation(double saturation, double lumaR, double lumaG, double lumaB)
 {
 	double luma = red * lumaR + green * lumaG + blue * lumaB;
 	red = luma + saturation * (red - luma);
 	green = luma + saturation * (green - luma);
 	blue = luma + saturation * (blue - luma);
+}
+
+namespace CppLUT
+{
+template class BasicLUTColor<float>;
+template class BasicLUTColor<double>;
+template class BasicLUTColor<LUTHalf>;
 }
\ No newline at end of file
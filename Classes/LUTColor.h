@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CppLUT.h"
+#include "LUTHalf.h"
 
 #include <vector>
 
@@ -17,26 +18,57 @@ namespace CppLUT
  */
 typedef double LUTColorValue;
 
+/**
+ * @brief      Describes how a channel value type is stored and computed with.
+ * @discussion Operations on colors load each channel into `ComputeType`, do
+ *             their arithmetic there and store the result back as the channel
+ *             type, so half precision colors are processed in single
+ *             precision.
+ *
+ * @tparam     T     The channel value type
+ */
+template <typename T>
+struct LUTColorValueTraits
+{
+	typedef T ComputeType;
+};
+
+template <>
+struct LUTColorValueTraits<LUTHalf>
+{
+	typedef float ComputeType;
+};
+
 /**
  * @brief      Represents a color value on a 3D LUT lattice.
+ *
+ * @tparam     T     The channel value type: `float`, `double` or `LUTHalf`
  */
-class LUTColor
+template <typename T>
+class BasicLUTColor
 {
+public:
+	/** @brief      The type of each channel */
+	typedef T ValueType;
+
+	/** @brief      The type channels are converted to for arithmetic */
+	typedef typename LUTColorValueTraits<T>::ComputeType ComputeType;
+
 private:
 	/**
 	 *  The value of the red channel of the color. Values should be between 0 and 1
 	 */
-	LUTColorValue red;
+	T red;
 
 	/**
 	 *  The value of the green channel of the color. Values should be between 0 and 1
 	 */
-	LUTColorValue green;
+	T green;
 
 	/**
 	 *  The value of the blue channel of the color. Values should be between 0 and 1
 	 */
-	LUTColorValue blue;
+	T blue;
 
 	/**
 	 * @brief      Creates a `LUTColor` with specified floating point RGB value
@@ -45,7 +77,7 @@ private:
 	 * @param[in]  g     The value of the green channel of the color. Values should be between 0 and 1
 	 * @param[in]  b     The value of the blue channel of the color. Values should be between 0 and 1
 	 */
-	LUTColor(LUTColorValue r, LUTColorValue g, LUTColorValue b);
+	BasicLUTColor(T r, T g, T b);
 
 
 public:
@@ -55,21 +87,21 @@ public:
 	 *
 	 * @return     The value for the red channel.
 	 */
-	LUTColorValue getR() const { return red; }
+	T getR() const { return red; }
 
 	/**
 	 * @brief      Gets the floating point color value for the green channel.
 	 *
 	 * @return     The value for the green channel.
 	 */
-	LUTColorValue getG() const { return green; }
+	T getG() const { return green; }
 	
 	/**
 	 * @brief      Gets the floating point color value for the blue channel.
 	 *
 	 * @return     The value for the blue channel.
 	 */
-	LUTColorValue getB() const { return blue; }
+	T getB() const { return blue; }
 
 	// static std::vector<double> & rgbArray; Find a way to do this
 
@@ -86,7 +118,24 @@ public:
 	 *
 	 * @return     A `LUTColor`.
 	 */
-	static LUTColor colorWithRGB(LUTColorValue r, LUTColorValue g, LUTColorValue b);
+	static BasicLUTColor colorWithRGB(T r, T g, T b);
+
+	/**
+	 * @brief      Creates a `LUTColor` from a color with a different channel
+	 *             value type, converting each channel.
+	 *
+	 * @param      color  The color to convert
+	 *
+	 * @tparam     U      The channel value type of `color`
+	 *
+	 * @return     A `LUTColor`.
+	 */
+	template <typename U>
+	static BasicLUTColor colorWithColor(const BasicLUTColor<U> & color)
+	{
+		typedef typename BasicLUTColor<U>::ComputeType From;
+		return BasicLUTColor((T)(From)color.getR(), (T)(From)color.getG(), (T)(From)color.getB());
+	}
 
 	/**
 	 * @brief      Creates a black `LUTColor` with 0 set for all the for the
@@ -94,7 +143,7 @@ public:
 	 *
 	 * @return     A black `LUTColor`.
 	 */
-	static LUTColor colorWithZeroes();
+	static BasicLUTColor colorWithZeroes();
 
 	/**
 	 * @brief      Creates a while `LUTColor` with 1 set for all the for the
@@ -102,7 +151,7 @@ public:
 	 *
 	 * @return     A while `LUTColor`.
 	 */
-	static LUTColor colorWithOnes();
+	static BasicLUTColor colorWithOnes();
 
 	/**
 	 * @brief      Creates a color with the same given floating-point channel
@@ -113,7 +162,7 @@ public:
 	 *
 	 * @return     A `LUTColor`.
 	 */
-	static LUTColor colorWithValue(double value);
+	static BasicLUTColor colorWithValue(double value);
 
 	/**
 	 * @brief      Creates a `LUTColor` with the provided integer channel values
@@ -131,7 +180,7 @@ public:
 	 *
 	 * @return     A `LUTColor`.
 	 */
-	static LUTColor colorFromIntegersWithBitdepth(int bitdepth, int r, int g, int b);
+	static BasicLUTColor colorFromIntegersWithBitdepth(int bitdepth, int r, int g, int b);
 
 	/**
 	 * @brief      Creates a `LUTColor` with the provided integer channel values
@@ -148,7 +197,7 @@ public:
 	 *
 	 * @return     A `LUTColor`.
 	 */
-	static LUTColor colorFromIntegersWithMaxOutputValue(int maxOutputValue, int r, int g, int b);
+	static BasicLUTColor colorFromIntegersWithMaxOutputValue(int maxOutputValue, int r, int g, int b);
 
 	/**
 	 * @brief      Determine the distance between this and another color point
@@ -157,7 +206,7 @@ public:
 	 *
 	 * @return     A double distance
 	 */
-	double distanceToColor(const LUTColor & otherColor) const;
+	double distanceToColor(const BasicLUTColor & otherColor) const;
 
 	/**
 	 * @brief      Determine the luminance value of this color in the Rec709
@@ -240,8 +289,8 @@ public:
 	 * @param[in]  outputHighColor  The output range high color point
 	 * @param[in]  bounded          The bounded Whether calls with an error !!!
 	 */
-	void remapBetweenColors(const LUTColor & inputLowColor, const LUTColor & inputHighColor,
-	                        const LUTColor & outputLowColor, const LUTColor & outputHighColor,
+	void remapBetweenColors(const BasicLUTColor & inputLowColor, const BasicLUTColor & inputHighColor,
+	                        const BasicLUTColor & outputLowColor, const BasicLUTColor & outputHighColor,
 	                        bool bounded);
 
 	/**
@@ -256,7 +305,7 @@ public:
 	 * @param      otherColor  The destination color of the interpolation.
 	 * @param      amount      The percentage distance between the two colors,
 	 */
-	void lerpTo(const LUTColor & otherColor, double amount);
+	void lerpTo(const BasicLUTColor & otherColor, double amount);
 	
 	/**
 	 * @brief      Apply ASC CDL slope, offset and power
@@ -305,7 +354,7 @@ public:
 	 *
 	 * @return     The color with multiplied channels
 	 */
-	LUTColor & operator*=(double number);
+	BasicLUTColor & operator*=(double number);
 
 	/**
 	 * @brief      Multiplies the channels of the color with the channels of
@@ -315,7 +364,7 @@ public:
 	 *
 	 * @return     A color
 	 */
-	LUTColor & operator*=(const LUTColor & offsetColor);
+	BasicLUTColor & operator*=(const BasicLUTColor & offsetColor);
 
 	/**
 	 * @brief      Adds the channels of another color to the color
@@ -324,7 +373,7 @@ public:
 	 *
 	 * @return     A color
 	 */
-	LUTColor & operator+=(const LUTColor & offsetColor);
+	BasicLUTColor & operator+=(const BasicLUTColor & offsetColor);
 
 	/**
 	 * @brief      Subtracts the channels of another color from the color
@@ -333,36 +382,54 @@ public:
 	 *
 	 * @return     A color
 	 */
-	LUTColor & operator-=(const LUTColor & offsetColor);
+	BasicLUTColor & operator-=(const BasicLUTColor & offsetColor);
 };
 
-inline LUTColor operator*(LUTColor l, double number)
+template <typename T>
+inline BasicLUTColor<T> operator*(BasicLUTColor<T> l, double number)
 {
 	l *= number;
 	return l;
 }
 
-inline LUTColor operator*(double number, LUTColor l)
+template <typename T>
+inline BasicLUTColor<T> operator*(double number, BasicLUTColor<T> l)
 {
 	return l * number;
 }
 
-inline LUTColor operator*(LUTColor l, const LUTColor & r)
+template <typename T>
+inline BasicLUTColor<T> operator*(BasicLUTColor<T> l, const BasicLUTColor<T> & r)
 {
 	l *= r;
 	return l;
 }
 
-inline LUTColor operator+(LUTColor l, const LUTColor & r)
+template <typename T>
+inline BasicLUTColor<T> operator+(BasicLUTColor<T> l, const BasicLUTColor<T> & r)
 {
 	l += r;
 	return l;
 }
 
-inline LUTColor operator-(LUTColor l, const LUTColor & r)
+template <typename T>
+inline BasicLUTColor<T> operator-(BasicLUTColor<T> l, const BasicLUTColor<T> & r)
 {
 	l -= r;
 	return l;
 } 
 
+extern template class BasicLUTColor<float>;
+extern template class BasicLUTColor<double>;
+extern template class BasicLUTColor<LUTHalf>;
+
+/** @brief      A color with double precision channels */
+typedef BasicLUTColor<LUTColorValue> LUTColor;
+
+/** @brief      A color with single precision channels */
+typedef BasicLUTColor<float> LUTColorf;
+
+/** @brief      A color with half precision channels */
+typedef BasicLUTColor<LUTHalf> LUTColorh;
+
 }
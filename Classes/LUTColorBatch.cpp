@@ -0,0 +1,194 @@
+#include "LUTColorBatch.h"
+
+using namespace CppLUT;
+
+template <typename T>
+void LUTColorBatch::clamp01(const LUTColorSpan<T> & span)
+{
+	apply(span, LUTColorOps::clamp01<T>());
+}
+
+template <typename T>
+void LUTColorBatch::clampToBounds(const LUTColorSpan<T> & span, double lowerBound, double upperBound)
+{
+	apply(span, LUTColorOps::clampToBounds<T>(lowerBound, upperBound));
+}
+
+template <typename T>
+void LUTColorBatch::clampToLowerBound(const LUTColorSpan<T> & span, double lowerBound)
+{
+	apply(span, LUTColorOps::clampToLowerBound<T>(lowerBound));
+}
+
+template <typename T>
+void LUTColorBatch::clampToUpperBound(const LUTColorSpan<T> & span, double upperBound)
+{
+	apply(span, LUTColorOps::clampToUpperBound<T>(upperBound));
+}
+
+template <typename T>
+void LUTColorBatch::remapContrast(const LUTColorSpan<T> & span, double inputLow, double inputHigh,
+                                  double outputLow, double outputHigh, bool bounded)
+{
+	apply(span, LUTColorOps::remapContrast<T>(inputLow, inputHigh, outputLow, outputHigh, bounded));
+}
+
+template <typename T>
+void LUTColorBatch::applySlopeOffsetPower(const LUTColorSpan<T> & span,
+                                          double redSlope, double redOffset, double redPower,
+                                          double greenSlope, double greenOffset, double greenPower,
+                                          double blueSlope, double blueOffset, double bluePower)
+{
+	apply(span, LUTColorOps::applySlopeOffsetPower<T>(redSlope, redOffset, redPower,
+	                                                  greenSlope, greenOffset, greenPower,
+	                                                  blueSlope, blueOffset, bluePower));
+}
+
+template <typename T>
+void LUTColorBatch::contrastStretchWithRange(const LUTColorSpan<T> & span, double currentMin, double currentMax,
+                                             double finalMin, double finalMax)
+{
+	apply(span, LUTColorOps::contrastStretchWithRange<T>(currentMin, currentMax, finalMin, finalMax));
+}
+
+template <typename T>
+void LUTColorBatch::invertColorWithRange(const LUTColorSpan<T> & span, double minimumValue, double maximumValue)
+{
+	apply(span, LUTColorOps::invertColorWithRange<T>(minimumValue, maximumValue));
+}
+
+template <typename T>
+void LUTColorBatch::changeSaturation(const LUTColorSpan<T> & span, double saturation,
+                                     double lumaR, double lumaG, double lumaB)
+{
+	apply(span, LUTColorOps::changeSaturation<T>(saturation, lumaR, lumaG, lumaB));
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::clamp01()
+{
+	return clampToBounds(0, 1);
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::clampToBounds(double lowerBound, double upperBound)
+{
+	Step step;
+	step.kind = Step::Clamp;
+	step.clamp = LUTColorOps::clampToBounds<T>(lowerBound, upperBound);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::clampToLowerBound(double lowerBound)
+{
+	Step step;
+	step.kind = Step::ClampLower;
+	step.clampLower = LUTColorOps::clampToLowerBound<T>(lowerBound);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::clampToUpperBound(double upperBound)
+{
+	Step step;
+	step.kind = Step::ClampUpper;
+	step.clampUpper = LUTColorOps::clampToUpperBound<T>(upperBound);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::remapContrast(double inputLow, double inputHigh,
+                                                         double outputLow, double outputHigh, bool bounded)
+{
+	Step step;
+	step.kind = Step::ScaleOffset;
+	step.scaleOffset = LUTColorOps::remapContrast<T>(inputLow, inputHigh, outputLow, outputHigh, bounded);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::applySlopeOffsetPower(double redSlope, double redOffset, double redPower,
+                                                                 double greenSlope, double greenOffset, double greenPower,
+                                                                 double blueSlope, double blueOffset, double bluePower)
+{
+	Step step;
+	step.kind = Step::SlopeOffsetPower;
+	step.slopeOffsetPower = LUTColorOps::applySlopeOffsetPower<T>(redSlope, redOffset, redPower,
+	                                                              greenSlope, greenOffset, greenPower,
+	                                                              blueSlope, blueOffset, bluePower);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::contrastStretchWithRange(double currentMin, double currentMax,
+                                                                    double finalMin, double finalMax)
+{
+	Step step;
+	step.kind = Step::ScaleOffset;
+	step.scaleOffset = LUTColorOps::contrastStretchWithRange<T>(currentMin, currentMax, finalMin, finalMax);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::invertColorWithRange(double minimumValue, double maximumValue)
+{
+	Step step;
+	step.kind = Step::Invert;
+	step.invert = LUTColorOps::invertColorWithRange<T>(minimumValue, maximumValue);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+LUTColorPipeline<T> & LUTColorPipeline<T>::changeSaturation(double saturation, double lumaR, double lumaG, double lumaB)
+{
+	Step step;
+	step.kind = Step::Saturation;
+	step.saturation = LUTColorOps::changeSaturation<T>(saturation, lumaR, lumaG, lumaB);
+	steps.push_back(step);
+	return *this;
+}
+
+template <typename T>
+void LUTColorPipeline<T>::apply(const LUTColorSpan<T> & span) const
+{
+	if (steps.empty())
+	{
+		return;
+	}
+	StepsOp op = { steps.data(), steps.size() };
+	LUTColorBatch::apply(span, op);
+}
+
+#define CPPLUT_INSTANTIATE_COLOR_BATCH(T) \
+	template void clamp01<T>(const LUTColorSpan<T> &); \
+	template void clampToBounds<T>(const LUTColorSpan<T> &, double, double); \
+	template void clampToLowerBound<T>(const LUTColorSpan<T> &, double); \
+	template void clampToUpperBound<T>(const LUTColorSpan<T> &, double); \
+	template void remapContrast<T>(const LUTColorSpan<T> &, double, double, double, double, bool); \
+	template void applySlopeOffsetPower<T>(const LUTColorSpan<T> &, double, double, double, \
+	                                       double, double, double, double, double, double); \
+	template void contrastStretchWithRange<T>(const LUTColorSpan<T> &, double, double, double, double); \
+	template void invertColorWithRange<T>(const LUTColorSpan<T> &, double, double); \
+	template void changeSaturation<T>(const LUTColorSpan<T> &, double, double, double, double);
+
+namespace CppLUT
+{
+namespace LUTColorBatch
+{
+CPPLUT_INSTANTIATE_COLOR_BATCH(float)
+CPPLUT_INSTANTIATE_COLOR_BATCH(double)
+CPPLUT_INSTANTIATE_COLOR_BATCH(LUTHalf)
+}
+
+template class LUTColorPipeline<float>;
+template class LUTColorPipeline<double>;
+template class LUTColorPipeline<LUTHalf>;
+}
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT3D.h"
+#include "LUTColorOps.h"
+
+#include <cstddef> // std::size_t
+#include <vector> // std::vector
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A view of `count` colors whose channels are reached through
+ *             three pointers advanced by `stride` elements per color.
+ * @discussion Covers both separate planes (`stride` 1, as in a `LUT3D`
+ *             lattice) and interleaved pixels (`stride` 3 or 4, one pointer
+ *             per channel offset). The span does not own its memory.
+ *
+ * @tparam     T     The channel value type: `float`, `double` or `LUTHalf`
+ */
+template <typename T>
+struct LUTColorSpan
+{
+	T * red;
+	T * green;
+	T * blue;
+	/** @brief      The number of colors */
+	std::size_t count;
+	/** @brief      The distance in elements between consecutive colors */
+	std::size_t stride;
+
+	/**
+	 * @brief      Creates a span over separate channel planes
+	 *
+	 * @param      red    The red plane
+	 * @param      green  The green plane
+	 * @param      blue   The blue plane
+	 * @param[in]  count  The number of colors
+	 *
+	 * @return     A `LUTColorSpan`
+	 */
+	static LUTColorSpan planar(T * red, T * green, T * blue, std::size_t count)
+	{
+		LUTColorSpan span = { red, green, blue, count, 1 };
+		return span;
+	}
+
+	/**
+	 * @brief      Creates a span over interleaved RGB(A...) pixels
+	 *
+	 * @param      pixels       The first channel of the first pixel
+	 * @param[in]  count        The number of pixels
+	 * @param[in]  pixelStride  The number of elements per pixel, at least 3
+	 *
+	 * @return     A `LUTColorSpan`
+	 */
+	static LUTColorSpan interleaved(T * pixels, std::size_t count, std::size_t pixelStride = 3)
+	{
+		LUTColorSpan span = { pixels, pixels + 1, pixels + 2, count, pixelStride };
+		return span;
+	}
+
+	/**
+	 * @brief      Creates a span over every lattice point of a LUT
+	 *
+	 * @param      lut   The LUT
+	 *
+	 * @return     A `LUTColorSpan`
+	 */
+	static LUTColorSpan ofLUT3D(BasicLUT3D<T> & lut)
+	{
+		return planar(lut.redPlane(), lut.greenPlane(), lut.bluePlane(), lut.getPointCount());
+	}
+};
+
+/**
+ * @brief      Batch equivalents of the `LUTColor` grading operations.
+ * @discussion Each function applies the operation to every color of a span
+ *             in place, with the same arithmetic as the `LUTColor` method of
+ *             the same name. Parameters are validated once per call, then
+ *             the colors are processed in vector registers of the widest
+ *             instruction set available. Strided spans are processed in
+ *             blocks copied to contiguous scratch memory.
+ */
+namespace LUTColorBatch
+{
+	/** @brief      The number of colors staged per block for strided spans */
+	const std::size_t blockSize = 256;
+
+	/**
+	 * @brief      Applies a `LUTColorOps` operation to every color of a span
+	 *
+	 * @param[in]  span  The colors
+	 * @param[in]  op    The operation
+	 */
+	template <typename T, typename Op>
+	void apply(const LUTColorSpan<T> & span, const Op & op)
+	{
+		if (span.stride == 1)
+		{
+			LUTColorOps::applyToPlanes(op, span.red, span.green, span.blue, span.count);
+			return;
+		}
+
+		typedef LUTColorOps::Compute<T> C;
+		C block[3][blockSize];
+		for (std::size_t begin = 0; begin < span.count; begin += blockSize)
+		{
+			const std::size_t n = (span.count - begin < blockSize) ? span.count - begin : blockSize;
+			const std::size_t offset = begin * span.stride;
+			for (std::size_t i = 0; i < n; i++)
+			{
+				block[0][i] = span.red[offset + i * span.stride];
+				block[1][i] = span.green[offset + i * span.stride];
+				block[2][i] = span.blue[offset + i * span.stride];
+			}
+			LUTColorOps::applyToPlanes(op, block[0], block[1], block[2], n);
+			for (std::size_t i = 0; i < n; i++)
+			{
+				span.red[offset + i * span.stride] = (T)block[0][i];
+				span.green[offset + i * span.stride] = (T)block[1][i];
+				span.blue[offset + i * span.stride] = (T)block[2][i];
+			}
+		}
+	}
+
+	/**
+	 * @brief      Applies several `LUTColorOps` operations to every color of a
+	 *             span in a single pass, with the chain compiled into the loop
+	 * @discussion For example
+	 *             `fused(span, LUTColorOps::changeSaturation<float>(1.2, 0.2126, 0.7152, 0.0722),
+	 *                    LUTColorOps::clamp01<float>())`.
+	 *
+	 * @param[in]  span  The colors
+	 * @param[in]  ops   The operations, applied in order
+	 */
+	template <typename T, typename... Ops>
+	void fused(const LUTColorSpan<T> & span, const Ops &... ops)
+	{
+		apply(span, LUTColorOps::fuse(ops...));
+	}
+
+	template <typename T>
+	void clamp01(const LUTColorSpan<T> & span);
+
+	template <typename T>
+	void clampToBounds(const LUTColorSpan<T> & span, double lowerBound, double upperBound);
+
+	template <typename T>
+	void clampToLowerBound(const LUTColorSpan<T> & span, double lowerBound);
+
+	template <typename T>
+	void clampToUpperBound(const LUTColorSpan<T> & span, double upperBound);
+
+	/**
+	 * @brief      Remaps colors from an input contrast range to an output
+	 *             contrast range
+	 *
+	 * @throws     std::domain_error  If `bounded` and either range is inverted
+	 *
+	 * @param[in]  span        The colors
+	 * @param[in]  inputLow    The input range low point
+	 * @param[in]  inputHigh   The input range high point
+	 * @param[in]  outputLow   The output range low point
+	 * @param[in]  outputHigh  The output range high point
+	 * @param[in]  bounded     Whether to check the ranges. Unlike
+	 *                         `LUTColor::remapContrast`, values outside the
+	 *                         input range are clamped to it rather than
+	 *                         throwing part way through the span.
+	 */
+	template <typename T>
+	void remapContrast(const LUTColorSpan<T> & span, double inputLow, double inputHigh,
+	                   double outputLow, double outputHigh, bool bounded);
+
+	/**
+	 * @brief      Apply ASC CDL slope, offset and power
+	 * @see        http://en.wikipedia.org/wiki/ASC_CDL
+	 * @discussion Slope and offset are vectorized. Channels with a power other
+	 *             than 1 then call `std::pow` per value.
+	 */
+	template <typename T>
+	void applySlopeOffsetPower(const LUTColorSpan<T> & span,
+	                           double redSlope, double redOffset, double redPower,
+	                           double greenSlope, double greenOffset, double greenPower,
+	                           double blueSlope, double blueOffset, double bluePower);
+
+	template <typename T>
+	void contrastStretchWithRange(const LUTColorSpan<T> & span, double currentMin, double currentMax,
+	                              double finalMin, double finalMax);
+
+	template <typename T>
+	void invertColorWithRange(const LUTColorSpan<T> & span, double minimumValue, double maximumValue);
+
+	template <typename T>
+	void changeSaturation(const LUTColorSpan<T> & span, double saturation, double lumaR, double lumaG, double lumaB);
+}
+
+/**
+ * @brief      A sequence of `LUTColor` operations recorded at runtime and
+ *             applied to colors in a single pass.
+ * @discussion Each color is loaded once, passed through every step in
+ *             vector registers and stored once, instead of one traversal
+ *             of the data per operation. When the sequence is known at
+ *             compile time, `LUTColorBatch::fused` specialises the loop
+ *             completely.
+ *
+ * @tparam     T     The channel value type: `float`, `double` or `LUTHalf`
+ */
+template <typename T>
+class LUTColorPipeline
+{
+public:
+	typedef LUTColorOps::Compute<T> ComputeType;
+
+	/** @see       LUTColor::clamp01 */
+	LUTColorPipeline & clamp01();
+
+	/** @see       LUTColor::clampToBounds */
+	LUTColorPipeline & clampToBounds(double lowerBound, double upperBound);
+
+	/** @see       LUTColor::clampToLowerBound */
+	LUTColorPipeline & clampToLowerBound(double lowerBound);
+
+	/** @see       LUTColor::clampToUpperBound */
+	LUTColorPipeline & clampToUpperBound(double upperBound);
+
+	/** @see       LUTColorOps::remapContrast */
+	LUTColorPipeline & remapContrast(double inputLow, double inputHigh, double outputLow, double outputHigh, bool bounded);
+
+	/** @see       LUTColor::applySlopeOffsetPower */
+	LUTColorPipeline & applySlopeOffsetPower(double redSlope, double redOffset, double redPower,
+	                                         double greenSlope, double greenOffset, double greenPower,
+	                                         double blueSlope, double blueOffset, double bluePower);
+
+	/** @see       LUTColor::contrastStretchWithRange */
+	LUTColorPipeline & contrastStretchWithRange(double currentMin, double currentMax, double finalMin, double finalMax);
+
+	/** @see       LUTColor::invertColorWithRange */
+	LUTColorPipeline & invertColorWithRange(double minimumValue, double maximumValue);
+
+	/** @see       LUTColor::changeSaturation */
+	LUTColorPipeline & changeSaturation(double saturation, double lumaR, double lumaG, double lumaB);
+
+	/**
+	 * @brief      The number of recorded operations
+	 *
+	 * @return     The step count
+	 */
+	std::size_t getStepCount() const { return steps.size(); }
+
+	/**
+	 * @brief      Applies every recorded operation, in order, to every color
+	 *             of a span
+	 *
+	 * @param[in]  span  The colors
+	 */
+	void apply(const LUTColorSpan<T> & span) const;
+
+private:
+	struct Step
+	{
+		enum Kind
+		{
+			Clamp,
+			ClampLower,
+			ClampUpper,
+			ScaleOffset,
+			SlopeOffsetPower,
+			Invert,
+			Saturation
+		};
+
+		Kind kind;
+		union
+		{
+			LUTColorOps::ClampOp<ComputeType> clamp;
+			LUTColorOps::ClampLowerOp<ComputeType> clampLower;
+			LUTColorOps::ClampUpperOp<ComputeType> clampUpper;
+			LUTColorOps::ScaleOffsetOp<ComputeType> scaleOffset;
+			LUTColorOps::SlopeOffsetPowerOp<ComputeType> slopeOffsetPower;
+			LUTColorOps::InvertOp<ComputeType> invert;
+			LUTColorOps::SaturationOp<ComputeType> saturation;
+		};
+	};
+
+	/** @brief      Runs the steps on one value or vector of each channel */
+	struct StepsOp
+	{
+		const Step * steps;
+		std::size_t count;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const Step & step = steps[i];
+				switch (step.kind)
+				{
+					case Step::Clamp: step.clamp(r, g, b); break;
+					case Step::ClampLower: step.clampLower(r, g, b); break;
+					case Step::ClampUpper: step.clampUpper(r, g, b); break;
+					case Step::ScaleOffset: step.scaleOffset(r, g, b); break;
+					case Step::SlopeOffsetPower: step.slopeOffsetPower(r, g, b); break;
+					case Step::Invert: step.invert(r, g, b); break;
+					case Step::Saturation: step.saturation(r, g, b); break;
+				}
+			}
+		}
+	};
+
+	std::vector<Step> steps;
+};
+
+}
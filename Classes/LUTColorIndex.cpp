@@ -0,0 +1,482 @@
+#include "LUTColorIndex.h"
+#include "LUTHelper.h"
+#include "LUTSIMD.h"
+
+#include <algorithm> // std::sort std::min
+#include <cmath> // std::cbrt std::floor
+#include <limits> // std::numeric_limits
+#include <stdexcept> // std::domain_error
+
+using namespace CppLUT;
+
+namespace
+{
+
+/** @brief      The number of colors the grid aims to put in each cell */
+const double colorsPerCell = 2;
+
+/** @brief      The most cells along each axis of the grid */
+const int maximumCellsPerAxis = 128;
+
+const std::size_t notFound = std::numeric_limits<std::size_t>::max();
+
+void checkRadius(double radius)
+{
+	if (!(radius >= 0))
+	{
+		throw std::domain_error("Invalid Radius: radius must be at least 0");
+	}
+}
+
+/**
+ * @brief      Updates `best` and `bestPosition` with the closest color in
+ *             `begin` to `end` that is strictly closer than `best`
+ */
+inline void scanNearestScalar(const float * const planes[3], std::size_t begin, std::size_t end,
+                              const float query[3], float & best, std::size_t & bestPosition)
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		const float dr = planes[0][i] - query[0];
+		const float dg = planes[1][i] - query[1];
+		const float db = planes[2][i] - query[2];
+		const float distance = dr * dr + dg * dg + db * db;
+		if (distance < best)
+		{
+			best = distance;
+			bestPosition = i;
+		}
+	}
+}
+
+/**
+ * @brief      Appends every color in `begin` to `end` within a squared
+ *             distance of `limit`
+ */
+inline void scanRadiusScalar(const float * const planes[3], std::size_t begin, std::size_t end,
+                             const float query[3], float limit, std::vector<std::size_t> & positions)
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		const float dr = planes[0][i] - query[0];
+		const float dg = planes[1][i] - query[1];
+		const float db = planes[2][i] - query[2];
+		if (dr * dr + dg * dg + db * db <= limit)
+		{
+			positions.push_back(i);
+		}
+	}
+}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+CPPLUT_TARGET_AVX2
+std::size_t scanNearestAVX2(const float * const planes[3], std::size_t begin, std::size_t end,
+                            const float query[3], float & best, std::size_t & bestPosition)
+{
+	const __m256 qr = _mm256_set1_ps(query[0]);
+	const __m256 qg = _mm256_set1_ps(query[1]);
+	const __m256 qb = _mm256_set1_ps(query[2]);
+	__m256 laneBest = _mm256_set1_ps(best);
+	__m256i laneBestOffset = _mm256_set1_epi32(-1);
+	__m256i laneOffset = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i eight = _mm256_set1_epi32(8);
+	std::size_t i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		const __m256 dr = _mm256_sub_ps(_mm256_loadu_ps(planes[0] + i), qr);
+		const __m256 dg = _mm256_sub_ps(_mm256_loadu_ps(planes[1] + i), qg);
+		const __m256 db = _mm256_sub_ps(_mm256_loadu_ps(planes[2] + i), qb);
+		const __m256 distance = _mm256_fmadd_ps(db, db, _mm256_fmadd_ps(dg, dg, _mm256_mul_ps(dr, dr)));
+		const __m256 closer = _mm256_cmp_ps(distance, laneBest, _CMP_LT_OQ);
+		laneBest = _mm256_blendv_ps(laneBest, distance, closer);
+		laneBestOffset = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(laneBestOffset),
+		                                                      _mm256_castsi256_ps(laneOffset), closer));
+		laneOffset = _mm256_add_epi32(laneOffset, eight);
+	}
+
+	float distances[8];
+	int offsets[8];
+	_mm256_storeu_ps(distances, laneBest);
+	_mm256_storeu_si256((__m256i *)offsets, laneBestOffset);
+	for (int lane = 0; lane < 8; lane++)
+	{
+		if (offsets[lane] < 0)
+		{
+			continue;
+		}
+		const std::size_t position = begin + offsets[lane];
+		if (distances[lane] < best || (distances[lane] == best && position < bestPosition))
+		{
+			best = distances[lane];
+			bestPosition = position;
+		}
+	}
+	return i;
+}
+
+CPPLUT_TARGET_AVX2
+std::size_t scanRadiusAVX2(const float * const planes[3], std::size_t begin, std::size_t end,
+                           const float query[3], float limit, std::vector<std::size_t> & positions)
+{
+	const __m256 qr = _mm256_set1_ps(query[0]);
+	const __m256 qg = _mm256_set1_ps(query[1]);
+	const __m256 qb = _mm256_set1_ps(query[2]);
+	const __m256 limits = _mm256_set1_ps(limit);
+	std::size_t i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		const __m256 dr = _mm256_sub_ps(_mm256_loadu_ps(planes[0] + i), qr);
+		const __m256 dg = _mm256_sub_ps(_mm256_loadu_ps(planes[1] + i), qg);
+		const __m256 db = _mm256_sub_ps(_mm256_loadu_ps(planes[2] + i), qb);
+		const __m256 distance = _mm256_fmadd_ps(db, db, _mm256_fmadd_ps(dg, dg, _mm256_mul_ps(dr, dr)));
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(distance, limits, _CMP_LE_OQ));
+		while (mask != 0)
+		{
+			positions.push_back(i + __builtin_ctz(mask));
+			mask &= mask - 1;
+		}
+	}
+	return i;
+}
+
+#endif
+
+/** @brief      Whether the span kernels may use AVX2, read once per query */
+inline bool useAVX2()
+{
+#if defined(CPPLUT_X86_DISPATCH)
+	return LUTSIMD::activeLevel() >= LUTSIMD::AVX2;
+#else
+	return false;
+#endif
+}
+
+inline void scanNearest(bool avx2, const float * const planes[3], std::size_t begin, std::size_t end,
+                        const float query[3], float & best, std::size_t & bestPosition)
+{
+#if defined(CPPLUT_X86_DISPATCH)
+	if (avx2 && end - begin >= 8)
+	{
+		begin = scanNearestAVX2(planes, begin, end, query, best, bestPosition);
+	}
+#endif
+	scanNearestScalar(planes, begin, end, query, best, bestPosition);
+}
+
+inline void scanRadius(bool avx2, const float * const planes[3], std::size_t begin, std::size_t end,
+                       const float query[3], float limit, std::vector<std::size_t> & positions)
+{
+#if defined(CPPLUT_X86_DISPATCH)
+	if (avx2 && end - begin >= 8)
+	{
+		begin = scanRadiusAVX2(planes, begin, end, query, limit, positions);
+	}
+#endif
+	scanRadiusScalar(planes, begin, end, query, limit, positions);
+}
+
+/** @brief      Runs `function(begin, end)` over blocks of `count` queries on the thread pool */
+template <typename Function>
+void concurrentQueryLoop(std::size_t count, Function function)
+{
+	const std::size_t tileSize = CPPLUT_CONCURRENT_TILE_POINTS;
+	const int tileCount = (int)((count + tileSize - 1) / tileSize);
+	LUTHelper::concurrentTileLoop(tileCount, [&](int tile)
+	{
+		const std::size_t begin = (std::size_t)tile * tileSize;
+		function(begin, std::min(begin + tileSize, count));
+	});
+}
+
+}
+
+template <typename T>
+LUTColorIndex::LUTColorIndex(const T * red, const T * green, const T * blue, std::size_t count):
+	count(count),
+	planeStride(alignedElementCount<float>(count)),
+	coordinates(3 * alignedElementCount<float>(count)),
+	originalIndices(count)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	const T * const input[3] = { red, green, blue };
+
+	float upper[3];
+	for (int c = 0; c < 3; c++)
+	{
+		lower[c] = upper[c] = (float)(C)input[c][0];
+		for (std::size_t i = 1; i < count; i++)
+		{
+			const float value = (float)(C)input[c][i];
+			lower[c] = (value < lower[c]) ? value : lower[c];
+			upper[c] = (value > upper[c]) ? value : upper[c];
+		}
+	}
+
+	cellsPerAxis = (int)std::cbrt(count / colorsPerCell);
+	cellsPerAxis = (cellsPerAxis < 1) ? 1 : ((cellsPerAxis > maximumCellsPerAxis) ? maximumCellsPerAxis : cellsPerAxis);
+	for (int c = 0; c < 3; c++)
+	{
+		const float extent = upper[c] - lower[c];
+		scale[c] = (extent > 0) ? cellsPerAxis / extent : 1;
+		cellSize[c] = 1 / scale[c];
+	}
+
+	// counting sort of the colors by cell
+	const std::size_t cellCount = (std::size_t)cellsPerAxis * cellsPerAxis * cellsPerAxis;
+	std::vector<std::uint32_t> cells(count);
+	cellStarts.assign(cellCount + 1, 0);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const std::size_t cell = cellOf((float)(C)red[i], 0)
+		                       + (std::size_t)cellsPerAxis * (cellOf((float)(C)green[i], 1)
+		                       + (std::size_t)cellsPerAxis * cellOf((float)(C)blue[i], 2));
+		cells[i] = (std::uint32_t)cell;
+		cellStarts[cell + 1]++;
+	}
+	for (std::size_t cell = 0; cell < cellCount; cell++)
+	{
+		cellStarts[cell + 1] += cellStarts[cell];
+	}
+	std::vector<std::uint32_t> next(cellStarts.begin(), cellStarts.end() - 1);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const std::uint32_t position = next[cells[i]]++;
+		originalIndices[position] = (std::uint32_t)i;
+		for (int c = 0; c < 3; c++)
+		{
+			coordinates[c * planeStride + position] = (float)(C)input[c][i];
+		}
+	}
+}
+
+template <typename T>
+LUTColorIndex LUTColorIndex::withPlanes(const T * red, const T * green, const T * blue, std::size_t count)
+{
+	if (count == 0)
+	{
+		throw std::domain_error("Invalid Color Index: at least one color is required");
+	}
+	if (count > std::numeric_limits<std::uint32_t>::max())
+	{
+		throw std::domain_error("Invalid Color Index: at most 2^32 - 1 colors can be indexed");
+	}
+	return LUTColorIndex(red, green, blue, count);
+}
+
+template <typename T>
+LUTColorIndex LUTColorIndex::withColors(const std::vector<BasicLUTColor<T>> & colors)
+{
+	std::vector<T> planes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		planes[c].reserve(colors.size());
+	}
+	for (const BasicLUTColor<T> & color : colors)
+	{
+		planes[0].push_back(color.getR());
+		planes[1].push_back(color.getG());
+		planes[2].push_back(color.getB());
+	}
+	return withPlanes(planes[0].data(), planes[1].data(), planes[2].data(), colors.size());
+}
+
+int LUTColorIndex::cellOf(float value, int axis) const
+{
+	float coordinate = (value - lower[axis]) * scale[axis];
+	coordinate = (coordinate > 0) ? coordinate : 0;
+	return (coordinate < cellsPerAxis) ? (int)coordinate : cellsPerAxis - 1;
+}
+
+std::size_t LUTColorIndex::nearestQuery(const float query[3], float & squaredDistance) const
+{
+	const float * const planes[3] = { coordinates.data(), coordinates.data() + planeStride, coordinates.data() + 2 * planeStride };
+	int centre[3];
+	for (int c = 0; c < 3; c++)
+	{
+		centre[c] = cellOf(query[c], c);
+	}
+	const int last = cellsPerAxis - 1;
+	const bool avx2 = useAVX2();
+	float best = std::numeric_limits<float>::infinity();
+	std::size_t bestPosition = notFound;
+
+	for (int ring = 0; ; ring++)
+	{
+		int low[3], high[3];
+		for (int c = 0; c < 3; c++)
+		{
+			low[c] = (centre[c] - ring > 0) ? centre[c] - ring : 0;
+			high[c] = (centre[c] + ring < last) ? centre[c] + ring : last;
+		}
+
+		// visit the cells at Chebyshev distance `ring`, a row along red at a time
+		for (int b = low[2]; b <= high[2]; b++)
+		{
+			for (int g = low[1]; g <= high[1]; g++)
+			{
+				const std::size_t row = (std::size_t)cellsPerAxis * (g + (std::size_t)cellsPerAxis * b);
+				const bool onFace = (b == centre[2] - ring || b == centre[2] + ring ||
+				                     g == centre[1] - ring || g == centre[1] + ring);
+				if (onFace)
+				{
+					scanNearest(avx2, planes, cellStarts[row + low[0]], cellStarts[row + high[0] + 1], query, best, bestPosition);
+					continue;
+				}
+				if (centre[0] - ring >= 0)
+				{
+					const std::size_t cell = row + centre[0] - ring;
+					scanNearest(avx2, planes, cellStarts[cell], cellStarts[cell + 1], query, best, bestPosition);
+				}
+				if (centre[0] + ring <= last)
+				{
+					const std::size_t cell = row + centre[0] + ring;
+					scanNearest(avx2, planes, cellStarts[cell], cellStarts[cell + 1], query, best, bestPosition);
+				}
+			}
+		}
+
+		// the closest any cell outside the visited box can be
+		float bound = std::numeric_limits<float>::infinity();
+		for (int c = 0; c < 3; c++)
+		{
+			if (centre[c] - ring > 0)
+			{
+				bound = std::min(bound, query[c] - (lower[c] + (centre[c] - ring) * cellSize[c]));
+			}
+			if (centre[c] + ring < last)
+			{
+				bound = std::min(bound, lower[c] + (centre[c] + ring + 1) * cellSize[c] - query[c]);
+			}
+		}
+		if (bound == std::numeric_limits<float>::infinity() ||
+		    (bestPosition != notFound && bound * bound >= best))
+		{
+			break;
+		}
+	}
+	if (bestPosition == notFound)
+	{
+		// only a query with a NaN channel is not closer to any color than infinity
+		squaredDistance = std::numeric_limits<float>::quiet_NaN();
+		return 0;
+	}
+	squaredDistance = best;
+	return originalIndices[bestPosition];
+}
+
+void LUTColorIndex::radiusQuery(const float query[3], float radius, std::vector<std::size_t> & indices) const
+{
+	const float * const planes[3] = { coordinates.data(), coordinates.data() + planeStride, coordinates.data() + 2 * planeStride };
+	int low[3], high[3];
+	for (int c = 0; c < 3; c++)
+	{
+		if (!(query[c] + radius >= lower[c] && query[c] - radius <= lower[c] + cellsPerAxis * cellSize[c]))
+		{
+			// the search box misses the grid, or the query is NaN
+			return;
+		}
+		low[c] = cellOf(query[c] - radius, c);
+		high[c] = cellOf(query[c] + radius, c);
+	}
+
+	const std::size_t first = indices.size();
+	const float limit = radius * radius;
+	const bool avx2 = useAVX2();
+	for (int b = low[2]; b <= high[2]; b++)
+	{
+		for (int g = low[1]; g <= high[1]; g++)
+		{
+			const std::size_t row = (std::size_t)cellsPerAxis * (g + (std::size_t)cellsPerAxis * b);
+			scanRadius(avx2, planes, cellStarts[row + low[0]], cellStarts[row + high[0] + 1], query, limit, indices);
+		}
+	}
+	for (std::size_t i = first; i < indices.size(); i++)
+	{
+		indices[i] = originalIndices[indices[i]];
+	}
+	std::sort(indices.begin() + first, indices.end());
+}
+
+std::size_t LUTColorIndex::nearest(const LUTColor & color, double * distance) const
+{
+	const float query[3] = { (float)color.getR(), (float)color.getG(), (float)color.getB() };
+	float squaredDistance;
+	const std::size_t index = nearestQuery(query, squaredDistance);
+	if (distance != nullptr)
+	{
+		*distance = std::sqrt((double)squaredDistance);
+	}
+	return index;
+}
+
+void LUTColorIndex::nearest(const float * colors, std::size_t colorCount, std::size_t * indices,
+                            float * distances, std::size_t pixelStride) const
+{
+	concurrentQueryLoop(colorCount, [&](std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; i++)
+		{
+			float squaredDistance;
+			indices[i] = nearestQuery(colors + i * pixelStride, squaredDistance);
+			if (distances != nullptr)
+			{
+				distances[i] = std::sqrt(squaredDistance);
+			}
+		}
+	});
+}
+
+std::vector<std::size_t> LUTColorIndex::withinRadius(const LUTColor & color, double radius) const
+{
+	checkRadius(radius);
+	const float query[3] = { (float)color.getR(), (float)color.getG(), (float)color.getB() };
+	std::vector<std::size_t> indices;
+	radiusQuery(query, (float)radius, indices);
+	return indices;
+}
+
+void LUTColorIndex::withinRadius(const float * colors, std::size_t colorCount, double radius,
+                                 std::vector<std::size_t> & offsets, std::vector<std::size_t> & indices,
+                                 std::size_t pixelStride) const
+{
+	checkRadius(radius);
+
+	// each block of queries collects its results separately, then the blocks
+	// are joined in order
+	const std::size_t tileSize = CPPLUT_CONCURRENT_TILE_POINTS;
+	std::vector<std::vector<std::size_t>> blockIndices((colorCount + tileSize - 1) / tileSize);
+	offsets.assign(colorCount + 1, 0);
+	concurrentQueryLoop(colorCount, [&](std::size_t begin, std::size_t end)
+	{
+		std::vector<std::size_t> & found = blockIndices[begin / tileSize];
+		for (std::size_t i = begin; i < end; i++)
+		{
+			radiusQuery(colors + i * pixelStride, (float)radius, found);
+			offsets[i + 1] = found.size();
+		}
+	});
+
+	indices.clear();
+	std::size_t blockStart = 0;
+	for (std::size_t block = 0; block < blockIndices.size(); block++)
+	{
+		const std::size_t end = std::min((block + 1) * tileSize, colorCount);
+		for (std::size_t i = block * tileSize; i < end; i++)
+		{
+			offsets[i + 1] += blockStart;
+		}
+		indices.insert(indices.end(), blockIndices[block].begin(), blockIndices[block].end());
+		blockStart = indices.size();
+	}
+}
+
+namespace CppLUT
+{
+template LUTColorIndex LUTColorIndex::withPlanes<float>(const float *, const float *, const float *, std::size_t);
+template LUTColorIndex LUTColorIndex::withPlanes<double>(const double *, const double *, const double *, std::size_t);
+template LUTColorIndex LUTColorIndex::withPlanes<LUTHalf>(const LUTHalf *, const LUTHalf *, const LUTHalf *, std::size_t);
+template LUTColorIndex LUTColorIndex::withColors<float>(const std::vector<LUTColorf> &);
+template LUTColorIndex LUTColorIndex::withColors<double>(const std::vector<LUTColor> &);
+template LUTColorIndex LUTColorIndex::withColors<LUTHalf>(const std::vector<LUTColorh> &);
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT3D.h"
+#include "LUTAlignedBuffer.h"
+#include "LUTColor.h"
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <vector> // std::vector
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A uniform grid index over a fixed set of colors, for nearest
+ *             color and radius queries.
+ * @discussion The colors are bucketed into a grid of cells spanning their
+ *             bounding box, with about two colors per cell, and stored in
+ *             single precision planes sorted by cell with red varying
+ *             fastest. A row of cells along red is then one contiguous span
+ *             of every plane, and distances to a span are evaluated eight
+ *             colors at a time with AVX2 when the CPU supports it.
+ *
+ *             A nearest query visits rings of cells around the query's cell
+ *             until no unvisited cell can hold a closer color. A radius
+ *             query visits only the cells overlapping the query's bounding
+ *             box. Batch queries are spread over `LUTHelper::concurrency()`
+ *             threads.
+ *
+ *             Queries report colors by their position in the set the index
+ *             was built from. Distances are Euclidean and computed in single
+ *             precision, so colors closer than about 1e-7 relative to the
+ *             set's extent may tie.
+ */
+class LUTColorIndex
+{
+	/** @brief      The number of cells along each axis */
+	int cellsPerAxis;
+
+	/** @brief      The lowest value of each channel */
+	float lower[3];
+
+	/** @brief      Cells per unit of each channel */
+	float scale[3];
+
+	/** @brief      The width of a cell along each channel */
+	float cellSize[3];
+
+	/** @brief      The number of indexed colors */
+	std::size_t count;
+
+	/** @brief      The number of elements between the start of each plane */
+	std::size_t planeStride;
+
+	/** @brief      The red, green and blue planes of the colors, sorted by cell */
+	LUTAlignedBuffer<float> coordinates;
+
+	/** @brief      The original position of each sorted color */
+	std::vector<std::uint32_t> originalIndices;
+
+	/** @brief      The first sorted color of each cell, followed by `count` */
+	std::vector<std::uint32_t> cellStarts;
+
+	/**
+	 * @brief      Private constructor for a LUTColorIndex
+	 */
+	template <typename T>
+	LUTColorIndex(const T * red, const T * green, const T * blue, std::size_t count);
+
+	int cellOf(float value, int axis) const;
+
+	std::size_t nearestQuery(const float query[3], float & squaredDistance) const;
+
+	void radiusQuery(const float query[3], float radius, std::vector<std::size_t> & indices) const;
+
+public:
+	/**
+	 * @brief      Indexes colors stored as three planes
+	 *
+	 * @throws     std::domain_error  If count is 0 or does not fit in 32 bits
+	 *
+	 * @param[in]  red    The red values
+	 * @param[in]  green  The green values
+	 * @param[in]  blue   The blue values
+	 * @param[in]  count  The number of colors
+	 *
+	 * @tparam     T      `float`, `double` or `LUTHalf`
+	 *
+	 * @return     The index
+	 */
+	template <typename T>
+	static LUTColorIndex withPlanes(const T * red, const T * green, const T * blue, std::size_t count);
+
+	/**
+	 * @brief      Indexes a list of colors, e.g. a palette
+	 *
+	 * @throws     std::domain_error  If colors is empty
+	 *
+	 * @param[in]  colors  The colors
+	 *
+	 * @tparam     T       The channel type of the colors
+	 *
+	 * @return     The index
+	 */
+	template <typename T>
+	static LUTColorIndex withColors(const std::vector<BasicLUTColor<T>> & colors);
+
+	/**
+	 * @brief      Indexes the output colors of every lattice point of a
+	 *             LUT3D. Queries report `BasicLUT3D::indexOfPoint` indices.
+	 *
+	 * @param[in]  lut   The LUT
+	 *
+	 * @tparam     T     The lattice value type of the LUT
+	 *
+	 * @return     The index
+	 */
+	template <typename T>
+	static LUTColorIndex withLUT3D(const BasicLUT3D<T> & lut)
+	{
+		return withPlanes(lut.redPlane(), lut.greenPlane(), lut.bluePlane(), lut.getPointCount());
+	}
+
+	/**
+	 * @brief      The number of indexed colors
+	 */
+	std::size_t getCount() const { return count; }
+
+	/**
+	 * @brief      Finds the indexed color nearest to a color. Of colors at the
+	 *             same distance, any one may be returned. A color with a NaN
+	 *             channel matches position 0 at a NaN distance.
+	 *
+	 * @param[in]  color     The color to match
+	 * @param[out] distance  Receives the distance to the nearest color, if not
+	 *                       null
+	 *
+	 * @return     The position of the nearest color
+	 */
+	std::size_t nearest(const LUTColor & color, double * distance = nullptr) const;
+
+	/**
+	 * @brief      Finds the nearest indexed color to each of a span of
+	 *             interleaved RGB colors
+	 *
+	 * @param[in]  colors       The first color to match
+	 * @param[in]  colorCount   The number of colors to match
+	 * @param[out] indices      Receives the position of each nearest color
+	 * @param[out] distances    Receives each distance, if not null
+	 * @param[in]  pixelStride  The number of floats from one color to the
+	 *                          next, 3 for RGB and 4 for RGBA
+	 */
+	void nearest(const float * colors, std::size_t colorCount, std::size_t * indices,
+	             float * distances = nullptr, std::size_t pixelStride = 3) const;
+
+	/**
+	 * @brief      Finds every indexed color within a distance of a color
+	 *
+	 * @throws     std::domain_error  If radius is negative or NaN
+	 *
+	 * @param[in]  color   The center of the search
+	 * @param[in]  radius  The largest distance, inclusive
+	 *
+	 * @return     The positions of the colors found, in ascending order
+	 */
+	std::vector<std::size_t> withinRadius(const LUTColor & color, double radius) const;
+
+	/**
+	 * @brief      Finds every indexed color within a distance of each of a
+	 *             span of interleaved RGB colors
+	 * @discussion The colors found for query `i` are
+	 *             `indices[offsets[i]]` up to `indices[offsets[i + 1]]`, in
+	 *             ascending order.
+	 *
+	 * @throws     std::domain_error  If radius is negative or NaN
+	 *
+	 * @param[in]  colors       The first center
+	 * @param[in]  colorCount   The number of centers
+	 * @param[in]  radius       The largest distance, inclusive
+	 * @param[out] offsets      Replaced with `colorCount + 1` offsets into
+	 *                          `indices`
+	 * @param[out] indices      Replaced with the positions found
+	 * @param[in]  pixelStride  The number of floats from one color to the
+	 *                          next, 3 for RGB and 4 for RGBA
+	 */
+	void withinRadius(const float * colors, std::size_t colorCount, double radius,
+	                  std::vector<std::size_t> & offsets, std::vector<std::size_t> & indices,
+	                  std::size_t pixelStride = 3) const;
+};
+
+extern template LUTColorIndex LUTColorIndex::withPlanes<float>(const float *, const float *, const float *, std::size_t);
+extern template LUTColorIndex LUTColorIndex::withPlanes<double>(const double *, const double *, const double *, std::size_t);
+extern template LUTColorIndex LUTColorIndex::withPlanes<LUTHalf>(const LUTHalf *, const LUTHalf *, const LUTHalf *, std::size_t);
+extern template LUTColorIndex LUTColorIndex::withColors<float>(const std::vector<LUTColorf> &);
+extern template LUTColorIndex LUTColorIndex::withColors<double>(const std::vector<LUTColor> &);
+extern template LUTColorIndex LUTColorIndex::withColors<LUTHalf>(const std::vector<LUTColorh> &);
+
+}
@@ -0,0 +1,483 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUTColor.h"
+#include "LUTHelper.h"
+#include "LUTSIMD.h"
+
+#include <cmath> // std::pow std::abs
+#include <cstddef> // std::size_t
+#include <stdexcept> // std::domain_error
+
+namespace CppLUT
+{
+
+/**
+ * @brief      The `LUTColor` grading operations as small function objects
+ *             that can be applied to scalars or vector registers.
+ * @discussion Each operation is called as `op(r, g, b)` with its channels in
+ *             the compute type of the color, or in a compiler vector of it
+ *             (`__m256`, `__m512d`, ...). Bodies use only arithmetic
+ *             operators so one definition serves every kernel, and several
+ *             operations can be fused with `fuse` to run in one pass.
+ *             Factories take the same parameters as the `LUTColor` method of
+ *             the same name and validate them once.
+ */
+namespace LUTColorOps
+{
+	template <typename T>
+	using Compute = typename LUTColorValueTraits<T>::ComputeType;
+
+	template <typename V, typename C>
+	CPPLUT_ALWAYS_INLINE void broadcast(V & result, C value)
+	{
+		result = V() + value;
+	}
+
+	/** @brief      Clamps with NaN landing on the lower bound */
+	template <typename V>
+	CPPLUT_ALWAYS_INLINE void clampValue(V & value, const V & lowerBound, const V & upperBound)
+	{
+		value = (value > lowerBound) ? value : lowerBound;
+		value = (value < upperBound) ? value : upperBound;
+	}
+
+	template <typename V, typename C>
+	CPPLUT_ALWAYS_INLINE void powLanes(V & value, C power)
+	{
+		C * lanes = reinterpret_cast<C *>(&value);
+		for (std::size_t i = 0; i < sizeof(V) / sizeof(C); i++)
+		{
+			lanes[i] = std::pow(lanes[i], power);
+		}
+	}
+
+	template <typename C>
+	struct ClampOp
+	{
+		C lowerBound;
+		C upperBound;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			V lower, upper;
+			broadcast(lower, lowerBound);
+			broadcast(upper, upperBound);
+			clampValue(r, lower, upper);
+			clampValue(g, lower, upper);
+			clampValue(b, lower, upper);
+		}
+	};
+
+	template <typename C>
+	struct ClampLowerOp
+	{
+		C lowerBound;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			V lower;
+			broadcast(lower, lowerBound);
+			r = (r < lower) ? lower : r;
+			g = (g < lower) ? lower : g;
+			b = (b < lower) ? lower : b;
+		}
+	};
+
+	template <typename C>
+	struct ClampUpperOp
+	{
+		C upperBound;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			V upper;
+			broadcast(upper, upperBound);
+			r = (r > upper) ? upper : r;
+			g = (g > upper) ? upper : g;
+			b = (b > upper) ? upper : b;
+		}
+	};
+
+	/** @brief      `value * scale + offset` on every channel, optionally clamped first */
+	template <typename C>
+	struct ScaleOffsetOp
+	{
+		C scale;
+		C offset;
+		bool clampInput;
+		C lowerBound;
+		C upperBound;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			if (clampInput)
+			{
+				V lower, upper;
+				broadcast(lower, lowerBound);
+				broadcast(upper, upperBound);
+				clampValue(r, lower, upper);
+				clampValue(g, lower, upper);
+				clampValue(b, lower, upper);
+			}
+			r = r * scale + offset;
+			g = g * scale + offset;
+			b = b * scale + offset;
+		}
+	};
+
+	/** @brief      ASC CDL. Powers other than 1 are applied per lane with `std::pow`. */
+	template <typename C>
+	struct SlopeOffsetPowerOp
+	{
+		C slope[3];
+		C offset[3];
+		C power[3];
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			r = r * slope[0] + offset[0];
+			g = g * slope[1] + offset[1];
+			b = b * slope[2] + offset[2];
+			if (power[0] != 1)
+			{
+				powLanes(r, power[0]);
+			}
+			if (power[1] != 1)
+			{
+				powLanes(g, power[1]);
+			}
+			if (power[2] != 1)
+			{
+				powLanes(b, power[2]);
+			}
+		}
+	};
+
+	template <typename C>
+	struct InvertOp
+	{
+		C distance;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			V d;
+			broadcast(d, distance);
+			r = d - r;
+			g = d - g;
+			b = d - b;
+		}
+	};
+
+	template <typename C>
+	struct SaturationOp
+	{
+		C saturation;
+		C lumaR;
+		C lumaG;
+		C lumaB;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			const V luma = r * lumaR + g * lumaG + b * lumaB;
+			r = luma + (r - luma) * saturation;
+			g = luma + (g - luma) * saturation;
+			b = luma + (b - luma) * saturation;
+		}
+	};
+
+	/** @brief      Applies each operation in turn while the channels stay in registers */
+	template <typename... Ops>
+	struct FusedOp;
+
+	template <typename Last>
+	struct FusedOp<Last>
+	{
+		Last last;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			last(r, g, b);
+		}
+	};
+
+	template <typename First, typename... Rest>
+	struct FusedOp<First, Rest...>
+	{
+		First first;
+		FusedOp<Rest...> rest;
+
+		template <typename V>
+		CPPLUT_ALWAYS_INLINE void operator()(V & r, V & g, V & b) const
+		{
+			first(r, g, b);
+			rest(r, g, b);
+		}
+	};
+
+	template <typename Last>
+	inline FusedOp<Last> fuse(const Last & last)
+	{
+		FusedOp<Last> fused = { last };
+		return fused;
+	}
+
+	/**
+	 * @brief      Combines operations into one that applies them in order
+	 *
+	 * @return     A `FusedOp`
+	 */
+	template <typename First, typename... Rest>
+	inline FusedOp<First, Rest...> fuse(const First & first, const Rest &... rest)
+	{
+		FusedOp<First, Rest...> fused = { first, fuse(rest...) };
+		return fused;
+	}
+
+	template <typename T>
+	inline ClampOp<Compute<T>> clampToBounds(double lowerBound, double upperBound)
+	{
+		ClampOp<Compute<T>> op = { (Compute<T>)lowerBound, (Compute<T>)upperBound };
+		return op;
+	}
+
+	template <typename T>
+	inline ClampOp<Compute<T>> clamp01()
+	{
+		return clampToBounds<T>(0, 1);
+	}
+
+	template <typename T>
+	inline ClampLowerOp<Compute<T>> clampToLowerBound(double lowerBound)
+	{
+		ClampLowerOp<Compute<T>> op = { (Compute<T>)lowerBound };
+		return op;
+	}
+
+	template <typename T>
+	inline ClampUpperOp<Compute<T>> clampToUpperBound(double upperBound)
+	{
+		ClampUpperOp<Compute<T>> op = { (Compute<T>)upperBound };
+		return op;
+	}
+
+	/**
+	 * @throws     std::domain_error  If `bounded` and either range is inverted
+	 * @discussion When `bounded`, values outside the input range are clamped
+	 *             to it rather than throwing.
+	 */
+	template <typename T>
+	inline ScaleOffsetOp<Compute<T>> remapContrast(double inputLow, double inputHigh,
+	                                               double outputLow, double outputHigh, bool bounded)
+	{
+		if (bounded && inputLow > inputHigh)
+		{
+			throw std::domain_error("RemapInputsError: inputLow must be less than or equal to inputHigh");
+		}
+		if (bounded && outputLow > outputHigh)
+		{
+			throw std::domain_error("RemapOutputsError: outputLow must be less than or equal to outputHigh");
+		}
+		const double scale = (outputHigh - outputLow) / (inputHigh - inputLow);
+		ScaleOffsetOp<Compute<T>> op = { (Compute<T>)scale, (Compute<T>)(outputLow - inputLow * scale),
+		                                 bounded, (Compute<T>)inputLow, (Compute<T>)inputHigh };
+		return op;
+	}
+
+	//thanks http://en.wikipedia.org/wiki/ASC_CDL
+	template <typename T>
+	inline SlopeOffsetPowerOp<Compute<T>> applySlopeOffsetPower(double redSlope, double redOffset, double redPower,
+	                                                            double greenSlope, double greenOffset, double greenPower,
+	                                                            double blueSlope, double blueOffset, double bluePower)
+	{
+		typedef Compute<T> C;
+		SlopeOffsetPowerOp<C> op = {
+			{ (C)LUTHelper::clampLowerBound(redSlope, 0), (C)LUTHelper::clampLowerBound(greenSlope, 0),
+			  (C)LUTHelper::clampLowerBound(blueSlope, 0) },
+			{ (C)redOffset, (C)greenOffset, (C)blueOffset },
+			{ (C)LUTHelper::clampLowerBound(redPower, 0), (C)LUTHelper::clampLowerBound(greenPower, 0),
+			  (C)LUTHelper::clampLowerBound(bluePower, 0) }
+		};
+		return op;
+	}
+
+	template <typename T>
+	inline ScaleOffsetOp<Compute<T>> contrastStretchWithRange(double currentMin, double currentMax,
+	                                                          double finalMin, double finalMax)
+	{
+		const double scale = (finalMax - finalMin) / (currentMax - currentMin);
+		ScaleOffsetOp<Compute<T>> op = { (Compute<T>)scale, (Compute<T>)(finalMin - currentMin * scale), false, 0, 0 };
+		return op;
+	}
+
+	template <typename T>
+	inline InvertOp<Compute<T>> invertColorWithRange(double minimumValue, double maximumValue)
+	{
+		InvertOp<Compute<T>> op = { (Compute<T>)std::abs(maximumValue - minimumValue) };
+		return op;
+	}
+
+	template <typename T>
+	inline SaturationOp<Compute<T>> changeSaturation(double saturation, double lumaR, double lumaG, double lumaB)
+	{
+		SaturationOp<Compute<T>> op = { (Compute<T>)saturation, (Compute<T>)lumaR, (Compute<T>)lumaG, (Compute<T>)lumaB };
+		return op;
+	}
+
+	template <typename E, typename Op>
+	inline void runScalar(const Op & op, E * r, E * g, E * b, std::size_t begin, std::size_t end)
+	{
+		typedef typename LUTColorValueTraits<E>::ComputeType C;
+		for (std::size_t i = begin; i < end; i++)
+		{
+			C red = r[i];
+			C green = g[i];
+			C blue = b[i];
+			op(red, green, blue);
+			r[i] = (E)red;
+			g[i] = (E)green;
+			b[i] = (E)blue;
+		}
+	}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+	template <typename E> struct AVX2Lanes;
+
+	template <>
+	struct AVX2Lanes<float>
+	{
+		typedef __m256 V;
+		static const std::size_t count = 8;
+		CPPLUT_TARGET_AVX2 static V load(const float * p) { return _mm256_loadu_ps(p); }
+		CPPLUT_TARGET_AVX2 static void store(float * p, V v) { _mm256_storeu_ps(p, v); }
+	};
+
+	template <>
+	struct AVX2Lanes<LUTHalf>: AVX2Lanes<float>
+	{
+		CPPLUT_TARGET_AVX2 static V load(const LUTHalf * p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p)); }
+		CPPLUT_TARGET_AVX2 static void store(LUTHalf * p, V v)
+		{
+			_mm_storeu_si128((__m128i *)p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+		}
+	};
+
+	template <>
+	struct AVX2Lanes<double>
+	{
+		typedef __m256d V;
+		static const std::size_t count = 4;
+		CPPLUT_TARGET_AVX2 static V load(const double * p) { return _mm256_loadu_pd(p); }
+		CPPLUT_TARGET_AVX2 static void store(double * p, V v) { _mm256_storeu_pd(p, v); }
+	};
+
+	template <typename E, typename Op>
+	CPPLUT_TARGET_AVX2 void runAVX2(const Op & op, E * r, E * g, E * b, std::size_t count)
+	{
+		typedef AVX2Lanes<E> L;
+		std::size_t i = 0;
+		for (; i + L::count <= count; i += L::count)
+		{
+			typename L::V red = L::load(r + i);
+			typename L::V green = L::load(g + i);
+			typename L::V blue = L::load(b + i);
+			op(red, green, blue);
+			L::store(r + i, red);
+			L::store(g + i, green);
+			L::store(b + i, blue);
+		}
+		runScalar(op, r, g, b, i, count);
+	}
+
+	template <typename E> struct AVX512Lanes;
+
+	template <>
+	struct AVX512Lanes<float>
+	{
+		typedef __m512 V;
+		static const std::size_t count = 16;
+		CPPLUT_TARGET_AVX512 static V load(const float * p) { return _mm512_loadu_ps(p); }
+		CPPLUT_TARGET_AVX512 static void store(float * p, V v) { _mm512_storeu_ps(p, v); }
+	};
+
+	template <>
+	struct AVX512Lanes<LUTHalf>: AVX512Lanes<float>
+	{
+		CPPLUT_TARGET_AVX512 static V load(const LUTHalf * p) { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)p)); }
+		CPPLUT_TARGET_AVX512 static void store(LUTHalf * p, V v)
+		{
+			_mm256_storeu_si256((__m256i *)p, _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+		}
+	};
+
+	template <>
+	struct AVX512Lanes<double>
+	{
+		typedef __m512d V;
+		static const std::size_t count = 8;
+		CPPLUT_TARGET_AVX512 static V load(const double * p) { return _mm512_loadu_pd(p); }
+		CPPLUT_TARGET_AVX512 static void store(double * p, V v) { _mm512_storeu_pd(p, v); }
+	};
+
+	template <typename E, typename Op>
+	CPPLUT_TARGET_AVX512 void runAVX512(const Op & op, E * r, E * g, E * b, std::size_t count)
+	{
+		typedef AVX512Lanes<E> L;
+		std::size_t i = 0;
+		for (; i + L::count <= count; i += L::count)
+		{
+			typename L::V red = L::load(r + i);
+			typename L::V green = L::load(g + i);
+			typename L::V blue = L::load(b + i);
+			op(red, green, blue);
+			L::store(r + i, red);
+			L::store(g + i, green);
+			L::store(b + i, blue);
+		}
+		runScalar(op, r, g, b, i, count);
+	}
+
+#endif
+
+	/**
+	 * @brief      Applies an operation to every color of three contiguous planes
+	 *             with the widest instruction set available
+	 *
+	 * @param[in]  op     The operation, called as `op(r, g, b)` on scalars or vectors
+	 * @param      r      The red plane
+	 * @param      g      The green plane
+	 * @param      b      The blue plane
+	 * @param[in]  count  The number of colors
+	 *
+	 * @tparam     E      The plane element type: `float`, `double` or `LUTHalf`
+	 */
+	template <typename E, typename Op>
+	inline void applyToPlanes(const Op & op, E * r, E * g, E * b, std::size_t count)
+	{
+#if defined(CPPLUT_X86_DISPATCH)
+		switch (LUTSIMD::activeLevel())
+		{
+			case LUTSIMD::AVX512:
+				runAVX512(op, r, g, b, count);
+				return;
+			case LUTSIMD::AVX2:
+				runAVX2(op, r, g, b, count);
+				return;
+			default:
+				break;
+		}
+#endif
+		runScalar(op, r, g, b, 0, count);
+	}
+}
+
+}
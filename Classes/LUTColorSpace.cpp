@@ -1,5 +1,109 @@
 #include "LUTColorSpace.h"
-// #include "LUTColorTransferFunction.h"
+#include "LUTHelper.h"
+#include "LUTColorTransferFunction.h"
+#include "LUTColorSpaceTables.h"
+
+#include <algorithm> // std::copy std::min
+#include <array> // std::array
+#include <map> // std::map
+#include <mutex> // std::mutex std::lock_guard
+#include <stdexcept> // std::domain_error
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+	/**
+	 * @brief      A thread-safe cache of derived matrices
+	 *
+	 * @tparam     N     The number of values in a key
+	 */
+	template <std::size_t N>
+	class MatrixRegistry
+	{
+	public:
+		typedef std::array<double, N> Key;
+
+		bool find(const Key & key, LUTMatrix3 & matrix)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			typename std::map<Key, LUTMatrix3>::const_iterator found = matrices.find(key);
+			if (found == matrices.end())
+			{
+				return false;
+			}
+			matrix = found->second;
+			return true;
+		}
+
+		void insert(const Key & key, const LUTMatrix3 & matrix)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			matrices.insert(std::make_pair(key, matrix));
+		}
+
+	private:
+		std::mutex mutex;
+		std::map<Key, LUTMatrix3> matrices;
+	};
+
+	/** @brief      Color space values that determine an NPM, followed by the white point */
+	const std::size_t npmKeySize = 12;
+
+	MatrixRegistry<npmKeySize> & npmRegistry()
+	{
+		static MatrixRegistry<npmKeySize> registry;
+		return registry;
+	}
+
+	MatrixRegistry<2 * npmKeySize + 3> & transformationRegistry()
+	{
+		static MatrixRegistry<2 * npmKeySize + 3> registry;
+		return registry;
+	}
+
+	/**
+	 * @brief      Writes `matrix` applied to every point of `lut` into
+	 *             `result`, which has the same size
+	 */
+	template <typename T, bool Clamp>
+	void transformLattice(const LUTMatrix3 & matrix, const BasicLUT3D<T> & lut, BasicLUT3D<T> & result,
+	                      double lowerBound, double upperBound)
+	{
+		LUTHelper::LUT3DConcurrentRangeLoop(lut.getSize(), [&](std::size_t begin, std::size_t end)
+		{
+			const T * const input[3] = { lut.redPlane() + begin, lut.greenPlane() + begin, lut.bluePlane() + begin };
+			T * const output[3] = { result.redPlane() + begin, result.greenPlane() + begin, result.bluePlane() + begin };
+			if (Clamp)
+			{
+				matrix.transformPlanes(input, output, end - begin, lowerBound, upperBound);
+			}
+			else
+			{
+				matrix.transformPlanes(input, output, end - begin);
+			}
+		});
+	}
+
+	/** @brief      The number of points `convertColorTemperature` holds in linear light at a time */
+	const std::size_t linearBlockPoints = 512;
+
+	// http://www.brucelindbloom.com/index.html?Eqn_ChromAdapt.html
+	const LUTMatrix3 bradford = LUTMatrix3::withRows( 0.8951,  0.2664, -0.1614,
+	                                                 -0.7502,  1.7135,  0.0367,
+	                                                  0.0389, -0.0685,  1.0296);
+
+	void whitePointXYZ(const LUTColorSpaceWhitePoint & whitePoint, double xyz[3])
+	{
+		double x = whitePoint.getWhiteChromaticityX();
+		double y = whitePoint.getWhiteChromaticityY();
+		xyz[0] = x / y;
+		xyz[1] = 1.0;
+		xyz[2] = (1.0 - x - y) / y;
+	}
+}
 
 LUTColorSpace::LUTColorSpace(LUTColorSpaceWhitePoint whitePoint,
                              double redChromaticityX, double redChromaticityY,
@@ -13,8 +117,24 @@ LUTColorSpace::LUTColorSpace(LUTColorSpaceWhitePoint whitePoint,
                              greenChromaticityY(greenChromaticityY),
                              blueChromaticityX(blueChromaticityX),
                              blueChromaticityY(blueChromaticityY),
+                             forcesNPM(false),
+                             forcedNPM(LUTMatrix3::identity()),
+                             forwardFootlambertCompensation(forwardFootlambertCompensation),
+                             name(name),
+                             knownIndex(-1)
+{}
+
+LUTColorSpace::LUTColorSpace(LUTColorSpaceWhitePoint whitePoint, const LUTMatrix3 & npm,
+                             double forwardFootlambertCompensation, const std::string & name):
+                             defaultWhitePoint(whitePoint),
+                             redChromaticityX(0), redChromaticityY(0),
+                             greenChromaticityX(0), greenChromaticityY(0),
+                             blueChromaticityX(0), blueChromaticityY(0),
+                             forcesNPM(true),
+                             forcedNPM(npm),
                              forwardFootlambertCompensation(forwardFootlambertCompensation),
-                             name(name)
+                             name(name),
+                             knownIndex(-1)
 {}
 
 LUTColorSpace LUTColorSpace::withDefaultWhitePoint(const LUTColorSpaceWhitePoint & whitePoint,
@@ -39,165 +159,381 @@ LUTColorSpace LUTColorSpace::withDefaultWhitePoint(const LUTColorSpaceWhitePoint
 	                     blueChromaticityX, blueChromaticityY, flCompensation, name);
 }
 
-std::vector<LUTColorSpace> LUTColorSpace::knownColorSpaces()
-{
-	return {
-		LUTColorSpace::rec709ColorSpace(),
-		LUTColorSpace::dciP3ColorSpace(),
-		LUTColorSpace::rec2020ColorSpace(),
-		LUTColorSpace::alexaWideGamutColorSpace(),
-		LUTColorSpace::sGamut3CineColorSpace(),
-		LUTColorSpace::sGamutColorSpace(),
-		LUTColorSpace::bmccColorSpace(),
-		LUTColorSpace::redColorColorSpace(),
-		LUTColorSpace::redColor2ColorSpace(),
-		LUTColorSpace::redColor3ColorSpace(),
-		LUTColorSpace::redColor4ColorSpace(),
-		LUTColorSpace::dragonColorColorSpace(),
-		LUTColorSpace::dragonColor2ColorSpace(),
-		LUTColorSpace::canonCinemaGamutColorSpace(),
-		LUTColorSpace::canonDCIP3PlusColorSpace(),
-		LUTColorSpace::vGamutColorSpace(),
-		LUTColorSpace::acesGamutColorSpace(),
-		// LUTColorSpace::dciXYZColorSpace(),
-		LUTColorSpace::xyzColorSpace(),
-		LUTColorSpace::adobeRGBColorSpace(),
-		LUTColorSpace::proPhotoRGBColorSpace()
-	};
+LUTColorSpace LUTColorSpace::withNPM(const LUTMatrix3 & npm, double flCompensation, const std::string & name)
+{
+	return LUTColorSpace(LUTColorSpaceWhitePoint::xyzWhitePoint(), npm, flCompensation, name);
+}
+
+LUTMatrix3 LUTColorSpace::npm() const
+{
+	return npmWithWhitePoint(defaultWhitePoint);
+}
+
+// http://www.brucelindbloom.com/index.html?Eqn_RGB_XYZ_Matrix.html
+LUTMatrix3 LUTColorSpace::npmWithWhitePoint(const LUTColorSpaceWhitePoint & whitePoint) const
+{
+	if (forcesNPM)
+	{
+		return forcedNPM;
+	}
+
+	if (knownIndex >= 0 &&
+	    whitePoint.getWhiteChromaticityX() == defaultWhitePoint.getWhiteChromaticityX() &&
+	    whitePoint.getWhiteChromaticityY() == defaultWhitePoint.getWhiteChromaticityY())
+	{
+		const double * m = LUTColorSpaceTables::npms[knownIndex].m;
+		return LUTMatrix3::withRows(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]);
+	}
+
+	MatrixRegistry<npmKeySize>::Key key = {{
+		redChromaticityX, redChromaticityY,
+		greenChromaticityX, greenChromaticityY,
+		blueChromaticityX, blueChromaticityY,
+		0, 0, 0, 0,
+		whitePoint.getWhiteChromaticityX(), whitePoint.getWhiteChromaticityY()
+	}};
+	LUTMatrix3 matrix;
+	if (npmRegistry().find(key, matrix))
+	{
+		return matrix;
+	}
+
+	LUTMatrix3 primaries = LUTMatrix3::withRows(redChromaticityX / redChromaticityY,
+	                                            greenChromaticityX / greenChromaticityY,
+	                                            blueChromaticityX / blueChromaticityY,
+	                                            1.0, 1.0, 1.0,
+	                                            (1.0 - redChromaticityX - redChromaticityY) / redChromaticityY,
+	                                            (1.0 - greenChromaticityX - greenChromaticityY) / greenChromaticityY,
+	                                            (1.0 - blueChromaticityX - blueChromaticityY) / blueChromaticityY);
+	double white[3];
+	whitePointXYZ(whitePoint, white);
+	double scale[3];
+	primaries.inverse().apply(white, scale);
+	matrix = primaries * LUTMatrix3::diagonal(scale[0], scale[1], scale[2]);
+
+	npmRegistry().insert(key, matrix);
+	return matrix;
+}
+
+LUTMatrix3 LUTColorSpace::bradfordMatrix(const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                         const LUTColorSpaceWhitePoint & destinationWhitePoint)
+{
+	double sourceXYZ[3], destinationXYZ[3];
+	whitePointXYZ(sourceWhitePoint, sourceXYZ);
+	whitePointXYZ(destinationWhitePoint, destinationXYZ);
+
+	double sourceCone[3], destinationCone[3];
+	bradford.apply(sourceXYZ, sourceCone);
+	bradford.apply(destinationXYZ, destinationCone);
+
+	return bradford.inverse() * LUTMatrix3::diagonal(destinationCone[0] / sourceCone[0],
+	                                                 destinationCone[1] / sourceCone[1],
+	                                                 destinationCone[2] / sourceCone[2]) * bradford;
+}
+
+LUTMatrix3 LUTColorSpace::transformationMatrix(const LUTColorSpace & sourceColorSpace,
+                                               const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                               const LUTColorSpace & destinationColorSpace,
+                                               const LUTColorSpaceWhitePoint & destinationWhitePoint,
+                                               bool useBradfordMatrix)
+{
+	MatrixRegistry<2 * npmKeySize + 3>::Key key;
+	const LUTColorSpace * spaces[2] = { &sourceColorSpace, &destinationColorSpace };
+	const LUTColorSpaceWhitePoint * whitePoints[2] = { &sourceWhitePoint, &destinationWhitePoint };
+	for (int side = 0; side < 2; side++)
+	{
+		const LUTColorSpace & space = *spaces[side];
+		double * values = key.data() + side * npmKeySize;
+		if (space.forcesNPM)
+		{
+			std::copy(space.forcedNPM.m, space.forcedNPM.m + 9, values);
+		}
+		else
+		{
+			double chromaticities[9] = {
+				space.redChromaticityX, space.redChromaticityY,
+				space.greenChromaticityX, space.greenChromaticityY,
+				space.blueChromaticityX, space.blueChromaticityY,
+				0, 0, 0
+			};
+			std::copy(chromaticities, chromaticities + 9, values);
+		}
+		values[9] = space.forcesNPM ? 1.0 : 0.0;
+		values[10] = whitePoints[side]->getWhiteChromaticityX();
+		values[11] = whitePoints[side]->getWhiteChromaticityY();
+	}
+	key[2 * npmKeySize] = sourceColorSpace.forwardFootlambertCompensation;
+	key[2 * npmKeySize + 1] = destinationColorSpace.forwardFootlambertCompensation;
+	key[2 * npmKeySize + 2] = useBradfordMatrix ? 1.0 : 0.0;
+
+	LUTMatrix3 matrix;
+	if (transformationRegistry().find(key, matrix))
+	{
+		return matrix;
+	}
+
+	LUTMatrix3 toXYZ = sourceColorSpace.npmWithWhitePoint(sourceWhitePoint);
+	if (useBradfordMatrix)
+	{
+		toXYZ = bradfordMatrix(sourceWhitePoint, destinationWhitePoint) * toXYZ;
+	}
+	matrix = destinationColorSpace.npmWithWhitePoint(destinationWhitePoint).inverse() * toXYZ
+	         * (destinationColorSpace.forwardFootlambertCompensation / sourceColorSpace.forwardFootlambertCompensation);
+
+	transformationRegistry().insert(key, matrix);
+	return matrix;
+}
+
+template <typename T>
+BasicLUT3D<T> LUTColorSpace::convertLUT3D(const BasicLUT3D<T> & lut,
+                                          const LUTColorSpace & sourceColorSpace,
+                                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                          const LUTColorSpace & destinationColorSpace,
+                                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
+                                          bool useBradfordMatrix)
+{
+	LUTMatrix3 matrix = transformationMatrix(sourceColorSpace, sourceWhitePoint,
+	                                         destinationColorSpace, destinationWhitePoint, useBradfordMatrix);
+	BasicLUT3D<T> result = BasicLUT3D<T>::withSize(lut.getSize(), lut.getInputLowerBound(), lut.getInputUpperBound());
+	transformLattice<T, false>(matrix, lut, result, 0, 0);
+	return result;
+}
+
+template <typename T>
+BasicLUT3D<T> LUTColorSpace::convertLUT3D(const BasicLUT3D<T> & lut,
+                                          const LUTColorSpace & sourceColorSpace,
+                                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
+                                          const LUTColorSpace & destinationColorSpace,
+                                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
+                                          bool useBradfordMatrix, double lowerBound, double upperBound)
+{
+	if (lowerBound > upperBound)
+	{
+		throw std::domain_error("Invalid Bounds Error: lowerBound must not be greater than upperBound");
+	}
+	LUTMatrix3 matrix = transformationMatrix(sourceColorSpace, sourceWhitePoint,
+	                                         destinationColorSpace, destinationWhitePoint, useBradfordMatrix);
+	BasicLUT3D<T> result = BasicLUT3D<T>::withSize(lut.getSize(), lut.getInputLowerBound(), lut.getInputUpperBound());
+	transformLattice<T, true>(matrix, lut, result, lowerBound, upperBound);
+	return result;
+}
+
+template <typename T>
+BasicLUT3D<T> LUTColorSpace::convertColorTemperature(const BasicLUT3D<T> & lut,
+                                                     const LUTColorSpace & sourceColorSpace,
+                                                     const LUTColorTransferFunction & sourceTransferFunction,
+                                                     const LUTColorSpaceWhitePoint & sourceColorTemperature,
+                                                     const LUTColorSpaceWhitePoint & destinationColorTemperature)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+
+	const LUTMatrix3 npm = sourceColorSpace.npm();
+	const LUTMatrix3 matrix = npm.inverse() * bradfordMatrix(sourceColorTemperature, destinationColorTemperature) * npm;
+
+	BasicLUT3D<T> result = BasicLUT3D<T>::withSize(lut.getSize(), lut.getInputLowerBound(), lut.getInputUpperBound());
+	LUTHelper::LUT3DConcurrentRangeLoop(lut.getSize(), [&](std::size_t begin, std::size_t end)
+	{
+		C linear[3][linearBlockPoints];
+		C * const planes[3] = { linear[0], linear[1], linear[2] };
+		for (std::size_t blockBegin = begin; blockBegin < end; blockBegin += linearBlockPoints)
+		{
+			const std::size_t count = std::min(linearBlockPoints, end - blockBegin);
+			const T * const input[3] = { lut.redPlane() + blockBegin, lut.greenPlane() + blockBegin,
+			                             lut.bluePlane() + blockBegin };
+			T * const output[3] = { result.redPlane() + blockBegin, result.greenPlane() + blockBegin,
+			                        result.bluePlane() + blockBegin };
+			for (int c = 0; c < 3; c++)
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					planes[c][i] = (C)input[c][i];
+				}
+				sourceTransferFunction.toLinear(planes[c], planes[c], count);
+			}
+			matrix.transformPlanes(planes, planes, count);
+			for (int c = 0; c < 3; c++)
+			{
+				sourceTransferFunction.fromLinear(planes[c], planes[c], count);
+				for (std::size_t i = 0; i < count; i++)
+				{
+					output[c][i] = (T)planes[c][i];
+				}
+			}
+		}
+	});
+	return result;
+}
+
+static_assert((std::size_t)LUTColorSpace::Known::ProPhotoRGB + 1 == LUTColorSpaceTables::colorSpaceCount,
+              "LUTColorSpace::Known must list every entry of the color space table");
+
+const std::vector<LUTColorSpace> & LUTColorSpace::knownColorSpaces()
+{
+	static const std::vector<LUTColorSpace> colorSpaces = []
+	{
+		std::vector<LUTColorSpace> result;
+		result.reserve(LUTColorSpaceTables::colorSpaceCount);
+		for (std::size_t i = 0; i < LUTColorSpaceTables::colorSpaceCount; i++)
+		{
+			const LUTColorSpaceTables::ColorSpaceEntry & entry = LUTColorSpaceTables::colorSpaces[i];
+			const LUTColorSpaceWhitePoint & whitePoint = LUTColorSpaceWhitePoint::knownWhitePoints()[entry.whitePoint];
+			if (entry.isXYZ)
+			{
+				result.push_back(LUTColorSpace(whitePoint, LUTMatrix3::identity(),
+				                               entry.forwardFootlambertCompensation, entry.name));
+			}
+			else
+			{
+				result.push_back(LUTColorSpace(whitePoint, entry.redX, entry.redY, entry.greenX, entry.greenY,
+				                               entry.blueX, entry.blueY, entry.forwardFootlambertCompensation, entry.name));
+			}
+			result.back().knownIndex = (int)i;
+		}
+		return result;
+	}();
+	return colorSpaces;
+}
+
+const LUTColorSpace & LUTColorSpace::known(Known colorSpace)
+{
+	return knownColorSpaces()[(std::size_t)colorSpace];
+}
+
+const LUTColorSpace * LUTColorSpace::knownWithName(const std::string & name)
+{
+	static const std::unordered_map<std::string, std::size_t> indices = []
+	{
+		std::unordered_map<std::string, std::size_t> result;
+		for (std::size_t i = 0; i < LUTColorSpaceTables::colorSpaceCount; i++)
+		{
+			result.emplace(LUTColorSpaceTables::colorSpaces[i].name, i);
+		}
+		return result;
+	}();
+	std::unordered_map<std::string, std::size_t>::const_iterator found = indices.find(name);
+	return found == indices.end() ? nullptr : &knownColorSpaces()[found->second];
 }
 
 LUTColorSpace LUTColorSpace::rec709ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.64, 0.33, 0.30, 0.60, 0.15, 0.06, "Rec. 709");
+	return known(Known::Rec709);
 }
 
 LUTColorSpace LUTColorSpace::canonDCIP3PlusColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::dciWhitePoint(),
-	                                            0.7400, 0.2700, 0.2200, 0.7800, 0.0900, -0.0900, "Canon DCI-P3+");
+	return known(Known::CanonDCIP3Plus);
 }
 
 LUTColorSpace LUTColorSpace::canonCinemaGamutColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.7400, 0.2700, 0.1700, 1.1400, 0.0800, -0.1000, "Canon Cinema Gamut");
+	return known(Known::CanonCinemaGamut);
 }
 
 LUTColorSpace LUTColorSpace::bmccColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.901885370853, 0.249059467640, 0.280038809783,
-	                                                         1.535129255560, 0.078873341398, -0.082629719848, "BMCC");
+	return known(Known::BMCC);
 }
 
 LUTColorSpace LUTColorSpace::redColorColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.682235759294, 0.320973856307, 0.295705729612,
-	                                            0.613311106957, 0.134524597085, 0.034410956920, "REDcolor");
+	return known(Known::REDColor);
 }
 
 LUTColorSpace LUTColorSpace::redColor2ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.858485322390, 0.316594954144, 0.292084791425,
-	                                            0.667838655872, 0.097651412967, -0.026565653796, "REDcolor2");
+	return known(Known::REDColor2);
 }
 
 LUTColorSpace LUTColorSpace::redColor3ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.682450885401, 0.320302618634, 0.291813306036,
-	                                            0.672642663443, 0.109533374066, -0.006916855752, "REDcolor3");
+	return known(Known::REDColor3);
 }
 
 LUTColorSpace LUTColorSpace::redColor4ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.682432347, 0.320314427, 0.291815909,
-	                                            0.672638769, 0.144290202, 0.050547336, "REDcolor4");
+	return known(Known::REDColor4);
 }
 
 LUTColorSpace LUTColorSpace::dragonColorColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.733696621349, 0.319213119879, 0.290807268864,
-	                                            0.689667987865, 0.083009416684, -0.050780628080, "DRAGONcolor");
+	return known(Known::DRAGONColor);
 }
 
 LUTColorSpace LUTColorSpace::dragonColor2ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.733671536367, 0.319227712042, 0.290804815281,
-	                                            0.689668775507, 0.143989704285, 0.050047743857, "DRAGONcolor2");
+	return known(Known::DRAGONColor2);
 }
 
 LUTColorSpace LUTColorSpace::proPhotoRGBColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.7347, 0.2653, 0.1596, 0.8404, 0.0366, 0.0001, "ProPhoto RGB");
+	return known(Known::ProPhotoRGB);
 }
 
 LUTColorSpace LUTColorSpace::adobeRGBColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.64, 0.33, 0.21, 0.71, 0.15, 0.06, "Adobe RGB");
+	return known(Known::AdobeRGB);
 }
 
 LUTColorSpace LUTColorSpace::dciP3ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::dciWhitePoint(),
-	                                            0.680, 0.320, 0.265, 0.69, 0.15, 0.06, "DCI-P3");
+	return known(Known::DCIP3);
 }
 
 LUTColorSpace LUTColorSpace::rec2020ColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.708, 0.292, 0.170, 0.797, 0.131, 0.046, "Rec. 2020");
-
+	return known(Known::Rec2020);
 }
 
 LUTColorSpace LUTColorSpace::alexaWideGamutColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.6840, 0.3130, 0.2210, 0.8480, 0.0861, -0.1020, "Alexa Wide Gamut");
+	return known(Known::AlexaWideGamut);
 }
 
 LUTColorSpace LUTColorSpace::sGamut3CineColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.76600, 0.27500, 0.22500, 0.80000, 0.08900, -0.08700, "S-Gamut3.Cine");
+	return known(Known::SGamut3Cine);
 }
 
 LUTColorSpace LUTColorSpace::sGamutColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.73000, 0.28000, 0.14000, 0.85500, 0.10000, -0.05000, "S-Gamut/S-Gamut3");
+	return known(Known::SGamut);
 }
 
 LUTColorSpace LUTColorSpace::vGamutColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d65WhitePoint(),
-	                                            0.730, 0.280, 0.165, 0.840, 0.100, -0.030, "V-Gamut");
+	return known(Known::VGamut);
 }
 
 LUTColorSpace LUTColorSpace::acesGamutColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::d60WhitePoint(),
-	                                            0.73470, 0.26530, 0.00000, 1.00000, 0.00010, -0.07700, "ACES Gamut");
+	return known(Known::ACESGamut);
 }
 /*
 LUTColorSpace LUTColorSpace::dciXYZColorSpace()
 {
-	return LUTColorSpace::withNPM(GLKMatrix3MakeWithRows(GLKVector3Make(1.0, 0.0, 0.0),
-	                                                     GLKVector3Make(0.0, 1.0, 0.0),
-	                                                     GLKVector3Make(0.0, 0.0, 1.0))
-	                              0.916555, "DCI-XYZ");
+	return LUTColorSpace::withNPM(LUTMatrix3::identity(), 0.916555, "DCI-XYZ");
 }
 */
 LUTColorSpace LUTColorSpace::xyzColorSpace()
 {
-	return LUTColorSpace::withDefaultWhitePoint(LUTColorSpaceWhitePoint::xyzWhitePoint(),
-	                                            1, 0, 0, 1, 0, 0, 0.916555, "CIE-XYZ");
+	return known(Known::XYZ);
 }
+
+template LUT3Df LUTColorSpace::convertLUT3D(const LUT3Df &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                            const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool);
+template LUT3D LUTColorSpace::convertLUT3D(const LUT3D &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                           const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool);
+template LUT3Dh LUTColorSpace::convertLUT3D(const LUT3Dh &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                            const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool);
+template LUT3Df LUTColorSpace::convertLUT3D(const LUT3Df &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                            const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool, double, double);
+template LUT3D LUTColorSpace::convertLUT3D(const LUT3D &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                           const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool, double, double);
+template LUT3Dh LUTColorSpace::convertLUT3D(const LUT3Dh &, const LUTColorSpace &, const LUTColorSpaceWhitePoint &,
+                                            const LUTColorSpace &, const LUTColorSpaceWhitePoint &, bool, double, double);
+template LUT3Df LUTColorSpace::convertColorTemperature(const LUT3Df &, const LUTColorSpace &, const LUTColorTransferFunction &,
+                                                       const LUTColorSpaceWhitePoint &, const LUTColorSpaceWhitePoint &);
+template LUT3D LUTColorSpace::convertColorTemperature(const LUT3D &, const LUTColorSpace &, const LUTColorTransferFunction &,
+                                                      const LUTColorSpaceWhitePoint &, const LUTColorSpaceWhitePoint &);
+template LUT3Dh LUTColorSpace::convertColorTemperature(const LUT3Dh &, const LUTColorSpace &, const LUTColorTransferFunction &,
+                                                       const LUTColorSpaceWhitePoint &, const LUTColorSpaceWhitePoint &);
@@ -2,6 +2,8 @@
 
 #include "CppLUT.h"
 #include "LUTColorSpaceWhitePoint.h"
+#include "LUTMatrix3.h"
+#include "LUT3D.h"
 
 #include <string> // std::string
 #include <vector> //std::vector
@@ -35,13 +37,20 @@ private:
 	/** @brief      The Y coordinate for the blue channel chromacity */
 	double blueChromaticityY;
 
+	/** @brief      Whether `forcedNPM` replaces the matrix derived from the chromaticities */
 	bool forcesNPM;
 
+	/** @brief      The normalized primary matrix used when `forcesNPM` is set */
+	CppLUT::LUTMatrix3 forcedNPM;
+
 	double forwardFootlambertCompensation;
 
 	/** @brief      The name of the color space */
 	std::string name;
 
+	/** @brief      The index of the color space in the known tables, -1 for other color spaces */
+	int knownIndex;
+
 	/**
 	 * @brief      Private constructor for a ColorSpace
 	 *
@@ -61,8 +70,48 @@ private:
 	              double blueChromaticityX, double blueChromaticityY,
 	              double forwardFootlambertCompensation, const std::string & name);
 
+	/**
+	 * @brief      Private constructor for a ColorSpace with a fixed normalized
+	 *             primary matrix
+	 *
+	 * @param[in]  whitePoint                      The white point of the color space
+	 * @param[in]  npm                             The normalized primary matrix
+	 * @param[in]  forwardFootlambertCompensation  The forward footlambert compensation
+	 * @param[in]  name                            The name of the colorspace
+	 */
+	LUTColorSpace(LUTColorSpaceWhitePoint whitePoint, const CppLUT::LUTMatrix3 & npm,
+	              double forwardFootlambertCompensation, const std::string & name);
+
 public:
 
+	/**
+	 * @brief      The color spaces known to the library, in the order of
+	 *             `knownColorSpaces`
+	 */
+	enum class Known
+	{
+		Rec709,
+		DCIP3,
+		Rec2020,
+		AlexaWideGamut,
+		SGamut3Cine,
+		SGamut,
+		BMCC,
+		REDColor,
+		REDColor2,
+		REDColor3,
+		REDColor4,
+		DRAGONColor,
+		DRAGONColor2,
+		CanonCinemaGamut,
+		CanonDCIP3Plus,
+		VGamut,
+		ACESGamut,
+		XYZ,
+		AdobeRGB,
+		ProPhotoRGB
+	};
+
 	/**
 	 * @brief      Create a colorspace with the default white point
 	 *
@@ -103,26 +152,196 @@ public:
 	                                           double greenChromaticityX, double greenChromaticityY,
 	                                           double blueChromaticityX, double blueChromaticityY,
 	                                           double flCompensation, const std::string & name);
-/*
-	static LUT3D convertLUT3D(const LUT3D & lut,
-	                          const LUTColorSpace & sourceColorSpace,
-	                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
-	                          const LUTColorSpace & destinationColorSpace,
-	                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
-	                          bool useBradfordMatrix);
-
-	static LUT3D convertColorTemperature(const LUT3D & lut,
-	                                     const LUTColorSpace & sourceColorSpace,
-	                                     const LUTColorTransferFunction & sourceTransferFunction,
-	                                     const LUTColorSpaceWhitePoint & sourceColorTemperature,
-	                                     const LUTColorSpaceWhitePoint & destinationColorTemperature);
-*/
+
+	/**
+	 * @brief      Create a colorspace defined directly by its normalized primary
+	 *             matrix rather than by chromaticities
+	 *
+	 * @param[in]  npm             The RGB to XYZ matrix
+	 * @param[in]  flCompensation  The forward footlambert compensation
+	 * @param[in]  name            The name of the colorspace
+	 *
+	 * @return     A colorspace
+	 */
+	static LUTColorSpace withNPM(const CppLUT::LUTMatrix3 & npm, double flCompensation, const std::string & name);
+
+	const std::string & getName() const { return name; }
+
+	const LUTColorSpaceWhitePoint & getDefaultWhitePoint() const { return defaultWhitePoint; }
+
+	double getForwardFootlambertCompensation() const { return forwardFootlambertCompensation; }
+
+	/**
+	 * @brief      The normalized primary (RGB to XYZ) matrix of the color space
+	 *             under its default white point
+	 * @discussion For known color spaces this is read from a table computed at
+	 *             compile time.
+	 *
+	 * @return     The matrix
+	 */
+	CppLUT::LUTMatrix3 npm() const;
+
+	/**
+	 * @brief      The normalized primary (RGB to XYZ) matrix of the color space
+	 *             under a given white point
+	 * @discussion Matrices are derived once per color space and white point and
+	 *             cached, so repeated calls are a lookup.
+	 *
+	 * @param[in]  whitePoint  The white point
+	 *
+	 * @return     The matrix
+	 */
+	CppLUT::LUTMatrix3 npmWithWhitePoint(const LUTColorSpaceWhitePoint & whitePoint) const;
+
+	/**
+	 * @brief      The Bradford chromatic adaptation matrix between two white
+	 *             points, operating on XYZ
+	 *
+	 * @param[in]  sourceWhitePoint       The source white point
+	 * @param[in]  destinationWhitePoint  The destination white point
+	 *
+	 * @return     The matrix
+	 */
+	static CppLUT::LUTMatrix3 bradfordMatrix(const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                         const LUTColorSpaceWhitePoint & destinationWhitePoint);
+
+	/**
+	 * @brief      The matrix taking linear RGB in one color space to linear RGB
+	 *             in another
+	 * @discussion The result is cached in a thread-safe registry keyed by both
+	 *             color spaces, both white points and the adaptation method, so
+	 *             converting a LUT is a single 3x3 multiply per point.
+	 *
+	 * @param[in]  sourceColorSpace       The source color space
+	 * @param[in]  sourceWhitePoint       The source white point
+	 * @param[in]  destinationColorSpace  The destination color space
+	 * @param[in]  destinationWhitePoint  The destination white point
+	 * @param[in]  useBradfordMatrix      Adapt between the white points with the
+	 *                                    Bradford transform
+	 *
+	 * @return     The matrix
+	 */
+	static CppLUT::LUTMatrix3 transformationMatrix(const LUTColorSpace & sourceColorSpace,
+	                                               const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                               const LUTColorSpace & destinationColorSpace,
+	                                               const LUTColorSpaceWhitePoint & destinationWhitePoint,
+	                                               bool useBradfordMatrix);
+
+	/**
+	 * @brief      Converts the output of a LUT from one color space to another
+	 * @discussion The cached transformation matrix is applied to the whole
+	 *             lattice as one vectorized pass, split over
+	 *             `LUTHelper::concurrency()` threads. The input range of the
+	 *             LUT is kept.
+	 *
+	 * @param[in]  lut                    The LUT, with linear output in the source color space
+	 * @param[in]  sourceColorSpace       The source color space
+	 * @param[in]  sourceWhitePoint       The source white point
+	 * @param[in]  destinationColorSpace  The destination color space
+	 * @param[in]  destinationWhitePoint  The destination white point
+	 * @param[in]  useBradfordMatrix      Adapt between the white points with the
+	 *                                    Bradford transform
+	 *
+	 * @tparam     T                      The channel type of the LUT
+	 *
+	 * @return     The converted LUT
+	 */
+	template <typename T>
+	static CppLUT::BasicLUT3D<T> convertLUT3D(const CppLUT::BasicLUT3D<T> & lut,
+	                                          const LUTColorSpace & sourceColorSpace,
+	                                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                          const LUTColorSpace & destinationColorSpace,
+	                                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
+	                                          bool useBradfordMatrix);
+
+	/**
+	 * @brief      Converts the output of a LUT from one color space to another
+	 *             and clamps it in the same pass
+	 * @discussion Pass bounds of 0 and 1 for the equivalent of
+	 *             `LUTColor::clamp01`, or any other range for
+	 *             `LUTColor::clampToBounds`.
+	 *
+	 * @param[in]  lut                    The LUT, with linear output in the source color space
+	 * @param[in]  sourceColorSpace       The source color space
+	 * @param[in]  sourceWhitePoint       The source white point
+	 * @param[in]  destinationColorSpace  The destination color space
+	 * @param[in]  destinationWhitePoint  The destination white point
+	 * @param[in]  useBradfordMatrix      Adapt between the white points with the
+	 *                                    Bradford transform
+	 * @param[in]  lowerBound             The lower bound of the output
+	 * @param[in]  upperBound             The upper bound of the output
+	 *
+	 * @tparam     T                      The channel type of the LUT
+	 *
+	 * @return     The converted LUT
+	 */
+	template <typename T>
+	static CppLUT::BasicLUT3D<T> convertLUT3D(const CppLUT::BasicLUT3D<T> & lut,
+	                                          const LUTColorSpace & sourceColorSpace,
+	                                          const LUTColorSpaceWhitePoint & sourceWhitePoint,
+	                                          const LUTColorSpace & destinationColorSpace,
+	                                          const LUTColorSpaceWhitePoint & destinationWhitePoint,
+	                                          bool useBradfordMatrix, double lowerBound, double upperBound);
+
+	/**
+	 * @brief      Changes the color temperature a LUT's output was balanced
+	 *             for
+	 * @discussion Colors lit by `sourceColorTemperature` are adapted with the
+	 *             Bradford transform to look as if lit by
+	 *             `destinationColorTemperature`, keeping the color space and
+	 *             its encoding. The lattice is linearized through
+	 *             `sourceTransferFunction`, multiplied by a single adaptation
+	 *             matrix and re-encoded, in one pass over blocks of lattice
+	 *             points spread over `LUTHelper::concurrency()` threads. Pass
+	 *             a transfer function from
+	 *             `LUTColorTransferFunction::withFastEvaluation` to trade its
+	 *             measured error for table lookups.
+	 *
+	 * @param[in]  lut                          The LUT, with output encoded in the source color space
+	 * @param[in]  sourceColorSpace             The color space of the LUT's output
+	 * @param[in]  sourceTransferFunction       The transfer function of the LUT's output
+	 * @param[in]  sourceColorTemperature       The white point the output is balanced for
+	 * @param[in]  destinationColorTemperature  The white point to balance the output for
+	 *
+	 * @tparam     T                            The channel type of the LUT
+	 *
+	 * @return     The converted LUT
+	 */
+	template <typename T>
+	static CppLUT::BasicLUT3D<T> convertColorTemperature(const CppLUT::BasicLUT3D<T> & lut,
+	                                                     const LUTColorSpace & sourceColorSpace,
+	                                                     const LUTColorTransferFunction & sourceTransferFunction,
+	                                                     const LUTColorSpaceWhitePoint & sourceColorTemperature,
+	                                                     const LUTColorSpaceWhitePoint & destinationColorTemperature);
+
 	/**
 	 * @brief      Returns the vector of all known color spaces in the library
+	 * @discussion The color spaces are built once from a compile-time table
+	 *             and shared by every caller.
 	 *
 	 * @return     A vector of color spaces
 	 */
-	static std::vector<LUTColorSpace> knownColorSpaces();
+	static const std::vector<LUTColorSpace> & knownColorSpaces();
+
+	/**
+	 * @brief      Get a known color space without copying it
+	 *
+	 * @param[in]  colorSpace  The color space
+	 *
+	 * @return     The shared color space
+	 */
+	static const LUTColorSpace & known(Known colorSpace);
+
+	/**
+	 * @brief      Finds a known color space by name, e.g. "Rec. 709" or
+	 *             "Alexa Wide Gamut"
+	 *
+	 * @param[in]  name  The name of the color space
+	 *
+	 * @return     The shared color space, or null if no known color space has
+	 *             that name
+	 */
+	static const LUTColorSpace * knownWithName(const std::string & name);
 
 	static LUTColorSpace rec709ColorSpace();
 	static LUTColorSpace dciP3ColorSpace();
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      Compile-time tables of the library's known white points and
+ *             color spaces, shared by `LUTColorSpaceWhitePoint` and
+ *             `LUTColorSpace`. Entries are in the order of the `Known`
+ *             enumerations of those classes.
+ * @discussion The normalized primary matrix of every known color space under
+ *             its default white point is derived here with `constexpr`
+ *             arithmetic, so reading one at run time is a table lookup with no
+ *             locking or allocation.
+ */
+namespace LUTColorSpaceTables
+{
+	struct WhitePointEntry
+	{
+		const char * name;
+		double x;
+		double y;
+	};
+
+	constexpr WhitePointEntry whitePoints[] = {
+		{ "D65", 0.31271, 0.32902 },
+		{ "D60", 0.32168, 0.33767 },
+		{ "D55", 0.33242, 0.34743 },
+		{ "D50", 0.34567, 0.35850 },
+		{ "DCI White", .314, .351 },
+		{ "XYZ White", 1.0 / 3.0, 1.0 / 3.0 }
+	};
+
+	constexpr std::size_t whitePointCount = sizeof(whitePoints) / sizeof(whitePoints[0]);
+
+	struct ColorSpaceEntry
+	{
+		const char * name;
+		/** @brief      The index of the default white point in `whitePoints` */
+		std::size_t whitePoint;
+		double redX;
+		double redY;
+		double greenX;
+		double greenY;
+		double blueX;
+		double blueY;
+		double forwardFootlambertCompensation;
+		/** @brief      Whether the color space is XYZ itself, with an identity NPM */
+		bool isXYZ;
+	};
+
+	constexpr ColorSpaceEntry colorSpaces[] = {
+		{ "Rec. 709", 0, 0.64, 0.33, 0.30, 0.60, 0.15, 0.06, 1.0, false },
+		{ "DCI-P3", 4, 0.680, 0.320, 0.265, 0.69, 0.15, 0.06, 1.0, false },
+		{ "Rec. 2020", 0, 0.708, 0.292, 0.170, 0.797, 0.131, 0.046, 1.0, false },
+		{ "Alexa Wide Gamut", 0, 0.6840, 0.3130, 0.2210, 0.8480, 0.0861, -0.1020, 1.0, false },
+		{ "S-Gamut3.Cine", 0, 0.76600, 0.27500, 0.22500, 0.80000, 0.08900, -0.08700, 1.0, false },
+		{ "S-Gamut/S-Gamut3", 0, 0.73000, 0.28000, 0.14000, 0.85500, 0.10000, -0.05000, 1.0, false },
+		{ "BMCC", 0, 0.901885370853, 0.249059467640, 0.280038809783,
+		             1.535129255560, 0.078873341398, -0.082629719848, 1.0, false },
+		{ "REDcolor", 0, 0.682235759294, 0.320973856307, 0.295705729612,
+		                 0.613311106957, 0.134524597085, 0.034410956920, 1.0, false },
+		{ "REDcolor2", 0, 0.858485322390, 0.316594954144, 0.292084791425,
+		                  0.667838655872, 0.097651412967, -0.026565653796, 1.0, false },
+		{ "REDcolor3", 0, 0.682450885401, 0.320302618634, 0.291813306036,
+		                  0.672642663443, 0.109533374066, -0.006916855752, 1.0, false },
+		{ "REDcolor4", 0, 0.682432347, 0.320314427, 0.291815909,
+		                  0.672638769, 0.144290202, 0.050547336, 1.0, false },
+		{ "DRAGONcolor", 0, 0.733696621349, 0.319213119879, 0.290807268864,
+		                    0.689667987865, 0.083009416684, -0.050780628080, 1.0, false },
+		{ "DRAGONcolor2", 0, 0.733671536367, 0.319227712042, 0.290804815281,
+		                     0.689668775507, 0.143989704285, 0.050047743857, 1.0, false },
+		{ "Canon Cinema Gamut", 0, 0.7400, 0.2700, 0.1700, 1.1400, 0.0800, -0.1000, 1.0, false },
+		{ "Canon DCI-P3+", 4, 0.7400, 0.2700, 0.2200, 0.7800, 0.0900, -0.0900, 1.0, false },
+		{ "V-Gamut", 0, 0.730, 0.280, 0.165, 0.840, 0.100, -0.030, 1.0, false },
+		{ "ACES Gamut", 1, 0.73470, 0.26530, 0.00000, 1.00000, 0.00010, -0.07700, 1.0, false },
+		{ "CIE-XYZ", 5, 0, 0, 0, 0, 0, 0, 0.916555, true },
+		{ "Adobe RGB", 0, 0.64, 0.33, 0.21, 0.71, 0.15, 0.06, 1.0, false },
+		{ "ProPhoto RGB", 0, 0.7347, 0.2653, 0.1596, 0.8404, 0.0366, 0.0001, 1.0, false }
+	};
+
+	constexpr std::size_t colorSpaceCount = sizeof(colorSpaces) / sizeof(colorSpaces[0]);
+
+	/** @brief      A row-major 3x3 matrix that can be built at compile time */
+	struct MatrixEntry
+	{
+		double m[9];
+	};
+
+	constexpr double determinant(double a, double b, double c,
+	                             double d, double e, double f,
+	                             double g, double h, double i)
+	{
+		return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+	}
+
+	/** @brief      X / Y of a chromaticity */
+	constexpr double xOverY(double x, double y) { return x / y; }
+
+	/** @brief      Z / Y of a chromaticity */
+	constexpr double zOverY(double x, double y) { return (1.0 - x - y) / y; }
+
+	constexpr double primariesDeterminant(const ColorSpaceEntry & s)
+	{
+		return determinant(xOverY(s.redX, s.redY), xOverY(s.greenX, s.greenY), xOverY(s.blueX, s.blueY),
+		                   1.0, 1.0, 1.0,
+		                   zOverY(s.redX, s.redY), zOverY(s.greenX, s.greenY), zOverY(s.blueX, s.blueY));
+	}
+
+	/**
+	 * @brief      The luminance of one primary in the white point, solved by
+	 *             Cramer's rule
+	 *
+	 * @param[in]  s        The color space
+	 * @param[in]  w        The white point
+	 * @param[in]  primary  0 for red, 1 for green and 2 for blue
+	 */
+	constexpr double primaryScale(const ColorSpaceEntry & s, const WhitePointEntry & w, int primary)
+	{
+		return determinant(primary == 0 ? xOverY(w.x, w.y) : xOverY(s.redX, s.redY),
+		                   primary == 1 ? xOverY(w.x, w.y) : xOverY(s.greenX, s.greenY),
+		                   primary == 2 ? xOverY(w.x, w.y) : xOverY(s.blueX, s.blueY),
+		                   1.0, 1.0, 1.0,
+		                   primary == 0 ? zOverY(w.x, w.y) : zOverY(s.redX, s.redY),
+		                   primary == 1 ? zOverY(w.x, w.y) : zOverY(s.greenX, s.greenY),
+		                   primary == 2 ? zOverY(w.x, w.y) : zOverY(s.blueX, s.blueY)) / primariesDeterminant(s);
+	}
+
+	/**
+	 * @brief      The normalized primary (RGB to XYZ) matrix of a color space
+	 *             under its default white point
+	 *
+	 * @see        http://www.brucelindbloom.com/index.html?Eqn_RGB_XYZ_Matrix.html
+	 */
+	constexpr MatrixEntry npm(const ColorSpaceEntry & s)
+	{
+		return s.isXYZ ? MatrixEntry{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 } } : MatrixEntry{ {
+			xOverY(s.redX, s.redY) * primaryScale(s, whitePoints[s.whitePoint], 0),
+			xOverY(s.greenX, s.greenY) * primaryScale(s, whitePoints[s.whitePoint], 1),
+			xOverY(s.blueX, s.blueY) * primaryScale(s, whitePoints[s.whitePoint], 2),
+			primaryScale(s, whitePoints[s.whitePoint], 0),
+			primaryScale(s, whitePoints[s.whitePoint], 1),
+			primaryScale(s, whitePoints[s.whitePoint], 2),
+			zOverY(s.redX, s.redY) * primaryScale(s, whitePoints[s.whitePoint], 0),
+			zOverY(s.greenX, s.greenY) * primaryScale(s, whitePoints[s.whitePoint], 1),
+			zOverY(s.blueX, s.blueY) * primaryScale(s, whitePoints[s.whitePoint], 2)
+		} };
+	}
+
+	constexpr MatrixEntry npms[] = {
+		npm(colorSpaces[0]), npm(colorSpaces[1]), npm(colorSpaces[2]), npm(colorSpaces[3]),
+		npm(colorSpaces[4]), npm(colorSpaces[5]), npm(colorSpaces[6]), npm(colorSpaces[7]),
+		npm(colorSpaces[8]), npm(colorSpaces[9]), npm(colorSpaces[10]), npm(colorSpaces[11]),
+		npm(colorSpaces[12]), npm(colorSpaces[13]), npm(colorSpaces[14]), npm(colorSpaces[15]),
+		npm(colorSpaces[16]), npm(colorSpaces[17]), npm(colorSpaces[18]), npm(colorSpaces[19])
+	};
+
+	static_assert(sizeof(npms) / sizeof(npms[0]) == colorSpaceCount, "Every known color space needs an NPM");
+
+	// The middle row of an NPM is the luminance of each primary, which sums to the white point's Y of 1
+	static_assert(npms[0].m[3] + npms[0].m[4] + npms[0].m[5] > 0.999999 &&
+	              npms[0].m[3] + npms[0].m[4] + npms[0].m[5] < 1.000001, "The Rec. 709 NPM must map white to Y = 1");
+	static_assert(npms[0].m[3] > 0.2126 && npms[0].m[3] < 0.2127, "The Rec. 709 NPM must give red a luminance of 0.2126");
+}
+
+}
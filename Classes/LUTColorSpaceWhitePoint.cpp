@@ -1,6 +1,58 @@
 #include "LUTColorSpaceWhitePoint.h"
+#include "LUTColorSpaceTables.h"
 
-#include <cmath> // std::pow
+#include <stdexcept> // std::domain_error
+#include <unordered_map> // std::unordered_map
+
+namespace
+{
+
+void checkColorTemperature(double colorTemperature)
+{
+	if (!(colorTemperature >= 1667 && colorTemperature <= 25000))
+	{
+		throw std::domain_error("Invalid Color Temperature Error: Color temperature must be in the range 1667k to 25000k");
+	}
+}
+
+/**
+ * @brief      The Planckian locus approximation for a color temperature known
+ *             to be in range. Each cubic is in Horner form, x in u = 1000/T and
+ *             y in x, so a call costs one division and no `std::pow`.
+ * @see        http://en.wikipedia.org/wiki/Planckian_locus#Approximation
+ */
+inline void planckianLocus(double colorTemperature, double & xC, double & yC)
+{
+	const double u = 1000.0 / colorTemperature;
+
+	//calculate x
+	if (colorTemperature <= 4000)
+	{
+		xC = ((-0.2661239 * u - 0.2343580) * u + 0.8776956) * u + 0.179910;
+	}
+	else
+	{
+		//temp > 4000 and <= 25000
+		xC = ((-3.0258469 * u + 2.1070379) * u + 0.2226347) * u + 0.240390;
+	}
+
+	//calculate y
+	if (colorTemperature <= 2222)
+	{
+		yC = ((-1.1063814 * xC - 1.34811020) * xC + 2.18555832) * xC - 0.20219683;
+	}
+	else if (colorTemperature <= 4000)
+	{
+		yC = ((-0.9549476 * xC - 1.37418593) * xC + 2.09137015) * xC - 0.16748867;
+	}
+	else
+	{
+		//temp > 4000 and <= 25000
+		yC = ((3.0817580 * xC - 5.87338670) * xC + 3.75112997) * xC - 0.37001483;
+	}
+}
+
+}
 
 LUTColorSpaceWhitePoint::LUTColorSpaceWhitePoint(double whiteChromaticityX,
                                                  double whiteChromaticityY,
@@ -10,26 +62,53 @@ LUTColorSpaceWhitePoint::LUTColorSpaceWhitePoint(double whiteChromaticityX,
                                                  name(name)
 {} 
 
-std::vector<LUTColorSpaceWhitePoint> LUTColorSpaceWhitePoint::knownWhitePoints()
+static_assert((std::size_t)LUTColorSpaceWhitePoint::Known::XYZ + 1 == CppLUT::LUTColorSpaceTables::whitePointCount,
+              "LUTColorSpaceWhitePoint::Known must list every entry of the white point table");
+
+const std::vector<LUTColorSpaceWhitePoint> & LUTColorSpaceWhitePoint::knownWhitePoints()
 {
-	return {
-		d65WhitePoint(),
-		d60WhitePoint(),
-		d55WhitePoint(),
-		d50WhitePoint(),
-		dciWhitePoint(),
-		xyzWhitePoint()
-	};
+	static const std::vector<LUTColorSpaceWhitePoint> whitePoints = []
+	{
+		std::vector<LUTColorSpaceWhitePoint> result;
+		result.reserve(CppLUT::LUTColorSpaceTables::whitePointCount);
+		for (const CppLUT::LUTColorSpaceTables::WhitePointEntry & entry : CppLUT::LUTColorSpaceTables::whitePoints)
+		{
+			result.push_back(LUTColorSpaceWhitePoint(entry.x, entry.y, entry.name));
+		}
+		return result;
+	}();
+	return whitePoints;
+}
+
+const LUTColorSpaceWhitePoint & LUTColorSpaceWhitePoint::known(Known whitePoint)
+{
+	return knownWhitePoints()[(std::size_t)whitePoint];
+}
+
+const LUTColorSpaceWhitePoint * LUTColorSpaceWhitePoint::knownWithName(const std::string & name)
+{
+	static const std::unordered_map<std::string, std::size_t> indices = []
+	{
+		std::unordered_map<std::string, std::size_t> result;
+		for (std::size_t i = 0; i < CppLUT::LUTColorSpaceTables::whitePointCount; i++)
+		{
+			result.emplace(CppLUT::LUTColorSpaceTables::whitePoints[i].name, i);
+		}
+		return result;
+	}();
+	std::unordered_map<std::string, std::size_t>::const_iterator found = indices.find(name);
+	return found == indices.end() ? nullptr : &knownWhitePoints()[found->second];
 }
 
-std::vector<LUTColorSpaceWhitePoint> LUTColorSpaceWhitePoint::knownColorTemperatureWhitePoints()
+const std::vector<LUTColorSpaceWhitePoint> & LUTColorSpaceWhitePoint::knownColorTemperatureWhitePoints()
 {
-	return {
+	static const std::vector<LUTColorSpaceWhitePoint> whitePoints = {
 		fromColorTemperature(2900, "Incandescent (2900K)"),
 		fromColorTemperature(3200, "Tungsten (3200K)"),
 		fromColorTemperature(4400, "Mixed (4400K)"),
 		fromColorTemperature(5600, "Daylight (5600K)")
 	};
+	return whitePoints;
 }
 
 //http://en.wikipedia.org/wiki/Planckian_locus#Approximation
@@ -41,69 +120,85 @@ LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::fromColorTemperature(double col
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::fromColorTemperature(double colorTemperature, const std::string & name)
 {
-	if (colorTemperature < 1667 || colorTemperature > 25000)
+	double xC;
+	double yC;
+	chromaticityFromColorTemperature(colorTemperature, xC, yC);
+	return LUTColorSpaceWhitePoint(xC, yC, name);
+}
+
+std::vector<LUTColorSpaceWhitePoint> LUTColorSpaceWhitePoint::fromColorTemperatureRange(double lowest, double highest, double step)
+{
+	if (!(step > 0))
 	{
-		throw std::domain_error("Invalid Color Temperature Error: Color temperature must be in the range 1667k to 25000k");
+		throw std::domain_error("Invalid Color Temperature Error: The step must be greater than 0");
 	}
+	checkColorTemperature(lowest);
+	checkColorTemperature(highest);
 
-	//calculate x
-	double xC;
-	if (colorTemperature >= 1667 && colorTemperature <= 4000)
+	const std::size_t count = highest < lowest ? 0 : (std::size_t)((highest - lowest) / step + 1e-9) + 1;
+	std::vector<double> temperatures(count);
+	for (std::size_t i = 0; i < count; i++)
 	{
-		xC = -0.2661239*(std::pow(10, 9)/std::pow(colorTemperature, 3)) - 0.2343580*(std::pow(10, 6)/std::pow(colorTemperature, 2)) + 0.8776956*(std::pow(10, 3)/colorTemperature) + 0.179910;
+		temperatures[i] = lowest + i * step;
 	}
-	else
+	std::vector<double> xs(count);
+	std::vector<double> ys(count);
+	chromaticitiesFromColorTemperatures(temperatures.data(), count, xs.data(), ys.data());
+
+	std::vector<LUTColorSpaceWhitePoint> whitePoints;
+	whitePoints.reserve(count);
+	for (std::size_t i = 0; i < count; i++)
 	{
-		//temp > 4000 and <= 25000
-		xC = -3.0258469*(std::pow(10, 9)/std::pow(colorTemperature, 3)) + 2.1070379*(std::pow(10, 6)/std::pow(colorTemperature, 2)) + 0.2226347*(std::pow(10, 3)/colorTemperature) + 0.240390;
+		whitePoints.push_back(LUTColorSpaceWhitePoint(xs[i], ys[i], std::to_string((int) temperatures[i]) + "K"));
 	}
+	return whitePoints;
+}
 
-	//calculate y
-	double yC;
+void LUTColorSpaceWhitePoint::chromaticityFromColorTemperature(double colorTemperature, double & whiteChromaticityX, double & whiteChromaticityY)
+{
+	checkColorTemperature(colorTemperature);
+	planckianLocus(colorTemperature, whiteChromaticityX, whiteChromaticityY);
+}
 
-	if (colorTemperature >= 1667 && colorTemperature <= 2222)
-	{
-		yC = -1.1063814*std::pow(xC, 3) - 1.34811020*std::pow(xC, 2) + 2.18555832*xC - 0.20219683;
-	}
-	else if (colorTemperature > 2222 && colorTemperature <= 4000)
+void LUTColorSpaceWhitePoint::chromaticitiesFromColorTemperatures(const double * colorTemperatures, std::size_t count,
+                                                                  double * whiteChromaticityX, double * whiteChromaticityY)
+{
+	for (std::size_t i = 0; i < count; i++)
 	{
-		yC = -0.9549476*std::pow(xC, 3) - 1.37418593*std::pow(xC, 2) + 2.09137015*xC - 0.16748867;
+		checkColorTemperature(colorTemperatures[i]);
 	}
-	else
+	for (std::size_t i = 0; i < count; i++)
 	{
-		//temp > 4000 and <= 25000
-		yC = 3.0817580*std::pow(xC, 3) - 5.87338670*std::pow(xC, 2) + 3.75112997*xC - 0.37001483;
+		planckianLocus(colorTemperatures[i], whiteChromaticityX[i], whiteChromaticityY[i]);
 	}
-
-	return LUTColorSpaceWhitePoint(xC, yC, name);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::d65WhitePoint()
 {
-	return LUTColorSpaceWhitePoint(0.31271 , 0.32902 , "D65");
+	return known(Known::D65);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::d60WhitePoint()
 {
-	return LUTColorSpaceWhitePoint(0.32168 , 0.33767 , "D60");
+	return known(Known::D60);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::d55WhitePoint()
 {
-	return LUTColorSpaceWhitePoint(0.33242 , 0.34743 , "D55");
+	return known(Known::D55);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::d50WhitePoint()
 {
-	return LUTColorSpaceWhitePoint(0.34567 , 0.35850 , "D50");
+	return known(Known::D50);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::dciWhitePoint()
 {
-	return LUTColorSpaceWhitePoint(.314 , .351 , "DCI White");
+	return known(Known::DCI);
 }
 
 LUTColorSpaceWhitePoint LUTColorSpaceWhitePoint::xyzWhitePoint()
 {
-	return LUTColorSpaceWhitePoint(1.0/3.0 , 1.0/3.0 , "XYZ White");
+	return known(Known::XYZ);
 }
@@ -1,4 +1,6 @@
+#pragma once
 
+#include <cstddef> // std::size_t
 #include <vector> // std::vector
 #include <string> //std::string
 
@@ -9,6 +11,20 @@ class LUTColorSpaceWhitePoint
 {
 public:
 
+	/**
+	 * @brief      The white points known to the library, in the order of
+	 *             `knownWhitePoints`
+	 */
+	enum class Known
+	{
+		D65,
+		D60,
+		D55,
+		D50,
+		DCI,
+		XYZ
+	};
+
 	/**
 	 * @brief      Create a LUTColorSpaceWhitePoint with X & Y chromacity points
 	 *
@@ -24,10 +40,31 @@ public:
 
 	/**
 	 * @brief      Get a vector of all known color space white points
+	 * @discussion The white points are built once from a compile-time table
+	 *             and shared by every caller.
 	 *
 	 * @return     A  `vector` of `LUTColorSpaceWhitePoint`s 
 	 */
-	static std::vector<LUTColorSpaceWhitePoint> knownWhitePoints();
+	static const std::vector<LUTColorSpaceWhitePoint> & knownWhitePoints();
+
+	/**
+	 * @brief      Get a known white point without copying it
+	 *
+	 * @param[in]  whitePoint  The white point
+	 *
+	 * @return     The shared `LUTColorSpaceWhitePoint`
+	 */
+	static const LUTColorSpaceWhitePoint & known(Known whitePoint);
+
+	/**
+	 * @brief      Finds a known white point by name, e.g. "D65" or "DCI White"
+	 *
+	 * @param[in]  name  The name of the white point
+	 *
+	 * @return     The shared `LUTColorSpaceWhitePoint`, or null if no known
+	 *             white point has that name
+	 */
+	static const LUTColorSpaceWhitePoint * knownWithName(const std::string & name);
 
 	/**
 	 * @brief      Get a vector of all known color temperature white points
@@ -35,7 +72,7 @@ public:
 	 * @return     A  `vector` of `LUTColorSpaceWhitePoint`s
 	 * @todo Fix case for values <1667 and >25000
 	 */
-	static std::vector<LUTColorSpaceWhitePoint> knownColorTemperatureWhitePoints();
+	static const std::vector<LUTColorSpaceWhitePoint> & knownColorTemperatureWhitePoints();
 
 	/**
 	 * @brief      Creates a `LUTColorSpaceWhitePoint` using a color temperature
@@ -59,6 +96,55 @@ public:
 	 */
 	static LUTColorSpaceWhitePoint fromColorTemperature(double colorTemperature, const std::string & name);
 
+	/**
+	 * @brief      Creates a `LUTColorSpaceWhitePoint` for each color
+	 *             temperature from `lowest` to `highest` in steps of `step`,
+	 *             named like `fromColorTemperature`
+	 *
+	 * @throws     std::domain_error  If the range is outside 1667K to 25000K
+	 *                                or step is not positive
+	 *
+	 * @param[in]  lowest   The first color temperature in kelvin
+	 * @param[in]  highest  The last color temperature in kelvin, included if
+	 *                      it falls on a step
+	 * @param[in]  step     The distance between color temperatures in kelvin
+	 *
+	 * @return     A `vector` of `LUTColorSpaceWhitePoint`s
+	 */
+	static std::vector<LUTColorSpaceWhitePoint> fromColorTemperatureRange(double lowest, double highest, double step);
+
+	/**
+	 * @brief      Computes the chromaticity of a color temperature without
+	 *             creating a `LUTColorSpaceWhitePoint` or allocating a name
+	 * @discussion Uses the same Planckian locus approximation as
+	 *             `fromColorTemperature`, with each cubic evaluated by
+	 *             Horner's rule in 1000 / `colorTemperature` and `x`.
+	 *
+	 * @throws     std::domain_error  If colorTemperature is not in the range
+	 *                                1667K to 25000K
+	 *
+	 * @param[in]  colorTemperature    The color temperature in kelvin
+	 * @param[out] whiteChromaticityX  The white chromaticity X coordinate
+	 * @param[out] whiteChromaticityY  The white chromaticity Y coordinate
+	 */
+	static void chromaticityFromColorTemperature(double colorTemperature, double & whiteChromaticityX, double & whiteChromaticityY);
+
+	/**
+	 * @brief      Computes the chromaticities of many color temperatures at
+	 *             once, without allocating
+	 *
+	 * @throws     std::domain_error  If any color temperature is not in the
+	 *                                range 1667K to 25000K, before any output
+	 *                                is written
+	 *
+	 * @param[in]  colorTemperatures   The color temperatures in kelvin
+	 * @param[in]  count               The number of color temperatures
+	 * @param[out] whiteChromaticityX  Receives `count` X coordinates
+	 * @param[out] whiteChromaticityY  Receives `count` Y coordinates
+	 */
+	static void chromaticitiesFromColorTemperatures(const double * colorTemperatures, std::size_t count,
+	                                                double * whiteChromaticityX, double * whiteChromaticityY);
+
 	static LUTColorSpaceWhitePoint d65WhitePoint();
 
 	static LUTColorSpaceWhitePoint d60WhitePoint();
@@ -70,6 +156,12 @@ public:
 	static LUTColorSpaceWhitePoint dciWhitePoint();
 
 	static LUTColorSpaceWhitePoint xyzWhitePoint();
+
+	double getWhiteChromaticityX() const { return whiteChromaticityX; }
+
+	double getWhiteChromaticityY() const { return whiteChromaticityY; }
+
+	const std::string & getName() const { return name; }
 	
 
 private:
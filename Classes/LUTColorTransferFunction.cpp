@@ -0,0 +1,560 @@
+#include "LUTColorTransferFunction.h"
+#include "LUTSIMD.h"
+
+#include <algorithm> // std::max std::min
+#include <cmath> // std::pow std::fabs std::copysign std::log std::log10 std::exp std::sqrt std::ldexp
+#include <cstdint> // std::uint32_t
+#include <cstring> // std::memcpy
+#include <sstream> // std::ostringstream
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+
+using namespace CppLUT;
+
+/**
+ * @brief      A curve sampled either uniformly over a range of inputs or at
+ *             logarithmically spaced inputs, read back with linear
+ *             interpolation. Inputs the table does not cover are passed to
+ *             the exact curve.
+ */
+struct LUTColorTransferFunction::FastTable
+{
+	/** @brief      Whether the table is indexed by the bits of a float rather than uniformly */
+	bool logarithmic;
+
+	/** @brief      The input of the first uniform sample */
+	float lower;
+
+	/** @brief      The number of uniform samples per unit of input */
+	float scale;
+
+	/** @brief      The number of uniform segments */
+	int segmentCount;
+
+	/** @brief      The samples */
+	std::vector<float> values;
+
+	/** @brief      The curve the samples were taken from */
+	Curve exact;
+
+	/** @brief      The largest error measured within the segments */
+	double maximumError;
+
+	static FastTable sampledUniformly(const Curve & exact, double lower, double upper, int segmentCount);
+	static FastTable sampledLogarithmically(const Curve & exact);
+
+	float evaluate(float value) const;
+	void evaluate(const float * input, float * output, std::size_t count) const;
+};
+
+namespace
+{
+
+/** @brief      The number of leading mantissa bits that select a logarithmic segment */
+const int logarithmicMantissaBits = 6;
+const int logarithmicShift = 23 - logarithmicMantissaBits;
+const std::uint32_t logarithmicFractionMask = (1u << logarithmicShift) - 1;
+const float logarithmicFractionScale = 1.0f / (1u << logarithmicShift);
+
+/** @brief      The magnitudes covered by a logarithmic table, 2^-24 to 2^16 */
+const int logarithmicMinimumExponent = -24;
+const int logarithmicMaximumExponent = 16;
+const std::uint32_t logarithmicMinimumBits = (std::uint32_t)(127 + logarithmicMinimumExponent) << 23;
+const std::uint32_t logarithmicMaximumBits = (std::uint32_t)(127 + logarithmicMaximumExponent) << 23;
+
+/** @brief      The number of segments for each sign of a logarithmic table */
+const int logarithmicSegmentCount = (logarithmicMaximumExponent - logarithmicMinimumExponent) << logarithmicMantissaBits;
+
+/** @brief      Where the two samples for an input of zero are held in a logarithmic table */
+const int logarithmicZeroIndex = 2 * (logarithmicSegmentCount + 1);
+
+/** @brief      The range and size of the uniform tables used to linearize */
+const double uniformLower = -0.25;
+const double uniformUpper = 1.25;
+const int uniformSegmentCount = 4096;
+
+std::uint32_t floatBits(float value)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+float floatFromBits(std::uint32_t bits)
+{
+	float value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/** @brief      The number of evenly spaced points in each segment a table's error is measured at */
+const int errorPointsPerSegment = 8;
+
+/**
+ * @brief      Absolute error for results within -1 to 1, relative beyond
+ */
+double tableError(double approximate, double exact)
+{
+	return std::fabs(approximate - exact) / std::max(1.0, std::fabs(exact));
+}
+
+double mirrored(double value, double (*curve)(double))
+{
+	return std::copysign(curve(std::fabs(value)), value);
+}
+
+// IEC 61966-2-1
+double sRGBToLinear(double value)
+{
+	return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+double sRGBFromLinear(double value)
+{
+	return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+}
+
+// ARRI LogC (v3) EI 800
+const double logCCut = 0.010591;
+const double logCA = 5.555556;
+const double logCB = 0.052272;
+const double logCC = 0.247190;
+const double logCD = 0.385537;
+const double logCE = 5.367655;
+const double logCF = 0.092809;
+
+double logCToLinear(double value)
+{
+	return value > logCE * logCCut + logCF ? (std::pow(10.0, (value - logCD) / logCC) - logCB) / logCA
+	                                       : (value - logCF) / logCE;
+}
+
+double logCFromLinear(double value)
+{
+	return value > logCCut ? logCC * std::log10(logCA * value + logCB) + logCD : logCE * value + logCF;
+}
+
+// Sony S-Log3
+double sLog3ToLinear(double value)
+{
+	return value >= 171.2102946929 / 1023.0 ? std::pow(10.0, (value * 1023.0 - 420.0) / 261.5) * (0.18 + 0.01) - 0.01
+	                                        : (value * 1023.0 - 95.0) * 0.01125 / (171.2102946929 - 95.0);
+}
+
+double sLog3FromLinear(double value)
+{
+	return value >= 0.01125 ? (420.0 + std::log10((value + 0.01) / (0.18 + 0.01)) * 261.5) / 1023.0
+	                        : (value * (171.2102946929 - 95.0) / 0.01125 + 95.0) / 1023.0;
+}
+
+// Panasonic V-Log
+const double vLogB = 0.00873;
+const double vLogC = 0.241514;
+const double vLogD = 0.598206;
+
+double vLogToLinear(double value)
+{
+	return value < 0.181 ? (value - 0.125) / 5.6 : std::pow(10.0, (value - vLogD) / vLogC) - vLogB;
+}
+
+double vLogFromLinear(double value)
+{
+	return value < 0.01 ? 5.6 * value + 0.125 : vLogC * std::log10(value + vLogB) + vLogD;
+}
+
+// SMPTE ST 2084
+const double pqM1 = 2610.0 / 16384.0;
+const double pqM2 = 2523.0 / 4096.0 * 128.0;
+const double pqC1 = 3424.0 / 4096.0;
+const double pqC2 = 2413.0 / 4096.0 * 32.0;
+const double pqC3 = 2392.0 / 4096.0 * 32.0;
+
+double pqToLinear(double value)
+{
+	const double power = std::pow(value, 1.0 / pqM2);
+	return std::pow(std::max(power - pqC1, 0.0) / (pqC2 - pqC3 * power), 1.0 / pqM1);
+}
+
+double pqFromLinear(double value)
+{
+	const double power = std::pow(value, pqM1);
+	return std::pow((pqC1 + pqC2 * power) / (1.0 + pqC3 * power), pqM2);
+}
+
+// ITU-R BT.2100 HLG
+const double hlgA = 0.17883277;
+const double hlgB = 1.0 - 4.0 * hlgA;
+const double hlgC = 0.5 - hlgA * std::log(4.0 * hlgA);
+
+double hlgToLinear(double value)
+{
+	return value <= 0.5 ? value * value / 3.0 : (std::exp((value - hlgC) / hlgA) + hlgB) / 12.0;
+}
+
+double hlgFromLinear(double value)
+{
+	return value <= 1.0 / 12.0 ? std::sqrt(3.0 * value) : hlgA * std::log(12.0 * value - hlgB) + hlgC;
+}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+/**
+ * @brief      Reads eight table entries for the lanes of `value` that the
+ *             table covers, and returns the mask of lanes it does not
+ */
+CPPLUT_TARGET_AVX2 inline __m256 lookupAVX2(const LUTColorTransferFunction::FastTable & table, __m256 value, int & uncovered)
+{
+	__m256i base;
+	__m256 fraction;
+	if (table.logarithmic)
+	{
+		const __m256i bits = _mm256_castps_si256(value);
+		const __m256i magnitude = _mm256_and_si256(bits, _mm256_set1_epi32(0x7fffffff));
+		const __m256i covered = _mm256_and_si256(_mm256_cmpgt_epi32(magnitude, _mm256_set1_epi32(logarithmicMinimumBits - 1)),
+		                                         _mm256_cmpgt_epi32(_mm256_set1_epi32(logarithmicMaximumBits), magnitude));
+		const __m256i zero = _mm256_cmpeq_epi32(magnitude, _mm256_setzero_si256());
+		base = _mm256_srli_epi32(_mm256_sub_epi32(magnitude, _mm256_set1_epi32(logarithmicMinimumBits)), logarithmicShift);
+		base = _mm256_add_epi32(base, _mm256_and_si256(_mm256_srai_epi32(bits, 31), _mm256_set1_epi32(logarithmicSegmentCount + 1)));
+		base = _mm256_or_si256(_mm256_and_si256(covered, base), _mm256_and_si256(zero, _mm256_set1_epi32(logarithmicZeroIndex)));
+		fraction = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(magnitude, _mm256_set1_epi32(logarithmicFractionMask))),
+		                         _mm256_set1_ps(logarithmicFractionScale));
+		fraction = _mm256_and_ps(fraction, _mm256_castsi256_ps(covered));
+		uncovered = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(covered, zero))) & 0xff;
+	}
+	else
+	{
+		__m256 coordinate = _mm256_mul_ps(_mm256_sub_ps(value, _mm256_set1_ps(table.lower)), _mm256_set1_ps(table.scale));
+		const __m256 segments = _mm256_set1_ps((float)table.segmentCount);
+		const __m256 covered = _mm256_and_ps(_mm256_cmp_ps(coordinate, _mm256_setzero_ps(), _CMP_GE_OQ),
+		                                     _mm256_cmp_ps(coordinate, segments, _CMP_LE_OQ));
+		uncovered = ~_mm256_movemask_ps(covered) & 0xff;
+		// max_ps returns its second operand when the first is NaN
+		coordinate = _mm256_min_ps(_mm256_max_ps(coordinate, _mm256_setzero_ps()), segments);
+		base = _mm256_min_epi32(_mm256_cvttps_epi32(coordinate), _mm256_set1_epi32(table.segmentCount - 1));
+		fraction = _mm256_sub_ps(coordinate, _mm256_cvtepi32_ps(base));
+	}
+	const __m256 low = _mm256_i32gather_ps(table.values.data(), base, 4);
+	const __m256 high = _mm256_i32gather_ps(table.values.data() + 1, base, 4);
+	return _mm256_fmadd_ps(fraction, _mm256_sub_ps(high, low), low);
+}
+
+CPPLUT_TARGET_AVX2 std::size_t evaluateAVX2(const LUTColorTransferFunction::FastTable & table,
+                                            const float * input, float * output, std::size_t count)
+{
+	std::size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 value = _mm256_loadu_ps(input + i);
+		int uncovered;
+		const __m256 result = lookupAVX2(table, value, uncovered);
+		if (uncovered == 0)
+		{
+			_mm256_storeu_ps(output + i, result);
+			continue;
+		}
+		float values[8];
+		float results[8];
+		_mm256_storeu_ps(values, value);
+		_mm256_storeu_ps(results, result);
+		// the exact curves are SSE code
+		_mm256_zeroupper();
+		for (int lane = 0; lane < 8; lane++)
+		{
+			output[i + lane] = (uncovered >> lane) & 1 ? (float)table.exact(values[lane]) : results[lane];
+		}
+	}
+	_mm256_zeroupper();
+	return i;
+}
+
+#endif
+
+}
+
+LUTColorTransferFunction::FastTable LUTColorTransferFunction::FastTable::sampledUniformly(const Curve & exact, double lower,
+                                                                                 double upper, int segmentCount)
+{
+	FastTable table;
+	table.logarithmic = false;
+	table.lower = (float)lower;
+	table.scale = (float)(segmentCount / (upper - lower));
+	table.segmentCount = segmentCount;
+	table.exact = exact;
+	table.values.resize(segmentCount + 1);
+	for (int i = 0; i <= segmentCount; i++)
+	{
+		table.values[i] = (float)exact(lower + i / (double)table.scale);
+	}
+
+	table.maximumError = 0;
+	for (int i = 0; i < segmentCount; i++)
+	{
+		for (int point = 0; point < errorPointsPerSegment; point++)
+		{
+			const float input = (float)(lower + (i + (point + 0.5) / errorPointsPerSegment) / table.scale);
+			table.maximumError = std::max(table.maximumError, tableError(table.evaluate(input), exact(input)));
+		}
+	}
+	return table;
+}
+
+LUTColorTransferFunction::FastTable LUTColorTransferFunction::FastTable::sampledLogarithmically(const Curve & exact)
+{
+	FastTable table;
+	table.logarithmic = true;
+	table.lower = 0;
+	table.scale = 0;
+	table.segmentCount = logarithmicSegmentCount;
+	table.exact = exact;
+	table.values.resize(logarithmicZeroIndex + 2);
+	for (int sign = 0; sign < 2; sign++)
+	{
+		for (int i = 0; i <= logarithmicSegmentCount; i++)
+		{
+			const std::uint32_t bits = logarithmicMinimumBits + ((std::uint32_t)i << logarithmicShift);
+			const double magnitude = bits == logarithmicMaximumBits ? std::ldexp(1.0, logarithmicMaximumExponent)
+			                                                        : floatFromBits(bits);
+			table.values[sign * (logarithmicSegmentCount + 1) + i] = (float)exact(sign ? -magnitude : magnitude);
+		}
+	}
+	table.values[logarithmicZeroIndex] = (float)exact(0);
+	table.values[logarithmicZeroIndex + 1] = table.values[logarithmicZeroIndex];
+
+	table.maximumError = 0;
+	for (int sign = 0; sign < 2; sign++)
+	{
+		for (int i = 0; i < logarithmicSegmentCount; i++)
+		{
+			for (int point = 0; point < errorPointsPerSegment; point++)
+			{
+				const std::uint32_t bits = logarithmicMinimumBits + ((std::uint32_t)i << logarithmicShift) +
+				                           (std::uint32_t)((2 * point + 1) << logarithmicShift) / (2 * errorPointsPerSegment);
+				const float input = sign ? -floatFromBits(bits) : floatFromBits(bits);
+				table.maximumError = std::max(table.maximumError, tableError(table.evaluate(input), exact(input)));
+			}
+		}
+	}
+	return table;
+}
+
+float LUTColorTransferFunction::FastTable::evaluate(float value) const
+{
+	int base;
+	float fraction;
+	if (logarithmic)
+	{
+		const std::uint32_t bits = floatBits(value);
+		const std::uint32_t magnitude = bits & 0x7fffffff;
+		if (magnitude == 0)
+		{
+			return values[logarithmicZeroIndex];
+		}
+		if (magnitude < logarithmicMinimumBits || magnitude >= logarithmicMaximumBits)
+		{
+			return (float)exact(value);
+		}
+		base = (int)((magnitude - logarithmicMinimumBits) >> logarithmicShift) + ((bits >> 31) ? logarithmicSegmentCount + 1 : 0);
+		fraction = (magnitude & logarithmicFractionMask) * logarithmicFractionScale;
+	}
+	else
+	{
+		const float coordinate = (value - lower) * scale;
+		if (!(coordinate >= 0 && coordinate <= segmentCount))
+		{
+			return (float)exact(value);
+		}
+		base = std::min((int)coordinate, segmentCount - 1);
+		fraction = coordinate - base;
+	}
+	return values[base] + fraction * (values[base + 1] - values[base]);
+}
+
+void LUTColorTransferFunction::FastTable::evaluate(const float * input, float * output, std::size_t count) const
+{
+	std::size_t i = 0;
+#if defined(CPPLUT_X86_DISPATCH)
+	if (LUTSIMD::activeLevel() >= LUTSIMD::AVX2)
+	{
+		i = evaluateAVX2(*this, input, output, count);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		output[i] = evaluate(input[i]);
+	}
+}
+
+LUTColorTransferFunction::LUTColorTransferFunction(const Curve & toLinear, const Curve & fromLinear, const std::string & name):
+	linearFunction(toLinear), encodedFunction(fromLinear), name(name)
+{}
+
+LUTColorTransferFunction LUTColorTransferFunction::withFunctions(const Curve & toLinear, const Curve & fromLinear,
+                                                                 const std::string & name)
+{
+	if (!toLinear || !fromLinear)
+	{
+		throw std::domain_error("Invalid Transfer Function: both curves must be set");
+	}
+	return LUTColorTransferFunction(toLinear, fromLinear, name);
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::gammaTransferFunction(double gamma)
+{
+	if (!(gamma > 0))
+	{
+		throw std::domain_error("Invalid Gamma: " + std::to_string(gamma) + " must be greater than 0");
+	}
+	const double inverseGamma = 1.0 / gamma;
+	std::ostringstream name;
+	name << "Gamma " << gamma;
+	return LUTColorTransferFunction([gamma](double value)
+	{
+		return std::copysign(std::pow(std::fabs(value), gamma), value);
+	}, [inverseGamma](double value)
+	{
+		return std::copysign(std::pow(std::fabs(value), inverseGamma), value);
+	}, name.str());
+}
+
+std::vector<LUTColorTransferFunction> LUTColorTransferFunction::knownTransferFunctions()
+{
+	return {
+		linearTransferFunction(),
+		gammaTransferFunction(2.2),
+		gammaTransferFunction(2.4),
+		gammaTransferFunction(2.6),
+		sRGBTransferFunction(),
+		logCTransferFunction(),
+		sLog3TransferFunction(),
+		vLogTransferFunction(),
+		pqTransferFunction(),
+		hlgTransferFunction()
+	};
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::linearTransferFunction()
+{
+	return LUTColorTransferFunction([](double value) { return value; }, [](double value) { return value; }, "Linear");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::sRGBTransferFunction()
+{
+	return LUTColorTransferFunction([](double value) { return mirrored(value, sRGBToLinear); },
+	                                [](double value) { return mirrored(value, sRGBFromLinear); }, "sRGB");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::logCTransferFunction()
+{
+	return LUTColorTransferFunction(logCToLinear, logCFromLinear, "LogC (EI 800)");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::sLog3TransferFunction()
+{
+	return LUTColorTransferFunction(sLog3ToLinear, sLog3FromLinear, "S-Log3");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::vLogTransferFunction()
+{
+	return LUTColorTransferFunction(vLogToLinear, vLogFromLinear, "V-Log");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::pqTransferFunction()
+{
+	return LUTColorTransferFunction([](double value) { return mirrored(value, pqToLinear); },
+	                                [](double value) { return mirrored(value, pqFromLinear); }, "PQ (ST 2084)");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::hlgTransferFunction()
+{
+	return LUTColorTransferFunction([](double value) { return mirrored(value, hlgToLinear); },
+	                                [](double value) { return mirrored(value, hlgFromLinear); }, "HLG");
+}
+
+LUTColorTransferFunction LUTColorTransferFunction::withFastEvaluation() const
+{
+	LUTColorTransferFunction fast = *this;
+	fast.linearTable = std::make_shared<const FastTable>(FastTable::sampledUniformly(linearFunction, uniformLower, uniformUpper,
+	                                                                        uniformSegmentCount));
+	fast.encodedTable = std::make_shared<const FastTable>(FastTable::sampledLogarithmically(encodedFunction));
+	return fast;
+}
+
+double LUTColorTransferFunction::getFastEvaluationError() const
+{
+	return usesFastEvaluation() ? std::max(linearTable->maximumError, encodedTable->maximumError) : 0;
+}
+
+double LUTColorTransferFunction::toLinear(double value) const
+{
+	return linearTable ? linearTable->evaluate((float)value) : linearFunction(value);
+}
+
+double LUTColorTransferFunction::fromLinear(double value) const
+{
+	return encodedTable ? encodedTable->evaluate((float)value) : encodedFunction(value);
+}
+
+namespace
+{
+
+template <typename T>
+void evaluateSpan(const LUTColorTransferFunction::Curve & exact, const LUTColorTransferFunction::FastTable * table,
+                  const T * input, T * output, std::size_t count)
+{
+	if (table == nullptr)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			output[i] = (T)exact(input[i]);
+		}
+		return;
+	}
+	float buffer[256];
+	for (std::size_t begin = 0; begin < count; begin += 256)
+	{
+		const std::size_t length = std::min<std::size_t>(256, count - begin);
+		for (std::size_t i = 0; i < length; i++)
+		{
+			buffer[i] = (float)input[begin + i];
+		}
+		table->evaluate(buffer, buffer, length);
+		for (std::size_t i = 0; i < length; i++)
+		{
+			output[begin + i] = (T)buffer[i];
+		}
+	}
+}
+
+template <>
+void evaluateSpan<float>(const LUTColorTransferFunction::Curve & exact, const LUTColorTransferFunction::FastTable * table,
+                         const float * input, float * output, std::size_t count)
+{
+	if (table == nullptr)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			output[i] = (float)exact(input[i]);
+		}
+		return;
+	}
+	table->evaluate(input, output, count);
+}
+
+}
+
+template <typename T>
+void LUTColorTransferFunction::toLinear(const T * input, T * output, std::size_t count) const
+{
+	evaluateSpan(linearFunction, linearTable.get(), input, output, count);
+}
+
+template <typename T>
+void LUTColorTransferFunction::fromLinear(const T * input, T * output, std::size_t count) const
+{
+	evaluateSpan(encodedFunction, encodedTable.get(), input, output, count);
+}
+
+template void LUTColorTransferFunction::toLinear<float>(const float *, float *, std::size_t) const;
+template void LUTColorTransferFunction::toLinear<double>(const double *, double *, std::size_t) const;
+template void LUTColorTransferFunction::fromLinear<float>(const float *, float *, std::size_t) const;
+template void LUTColorTransferFunction::fromLinear<double>(const double *, double *, std::size_t) const;
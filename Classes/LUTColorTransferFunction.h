@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+#include <memory> // std::shared_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+/**
+ * @brief      A transfer function between encoded values and linear light
+ * @discussion Every transfer function evaluates its exact curves by default.
+ *             `withFastEvaluation` returns a copy that reads both curves from
+ *             precomputed tables instead, with linear interpolation and a
+ *             measured error bound; spans of values are then processed with
+ *             the widest vector instruction set available. Values outside a
+ *             table's range still use the exact curve.
+ */
+class LUTColorTransferFunction
+{
+public:
+	/** @brief      Maps one channel value to another */
+	typedef std::function<double(double)> Curve;
+
+	/**
+	 * @brief      A precomputed approximation of one curve, defined with its
+	 *             implementation in the source file
+	 */
+	struct FastTable;
+
+private:
+	/** @brief      Maps an encoded value to linear light */
+	Curve linearFunction;
+
+	/** @brief      Maps linear light to an encoded value */
+	Curve encodedFunction;
+
+	/** @brief      The name of the transfer function */
+	std::string name;
+
+	/** @brief      The table for `linearFunction`, null for exact evaluation */
+	std::shared_ptr<const FastTable> linearTable;
+
+	/** @brief      The table for `encodedFunction`, null for exact evaluation */
+	std::shared_ptr<const FastTable> encodedTable;
+
+	/**
+	 * @brief      Private constructor for a LUTColorTransferFunction
+	 *
+	 * @param[in]  toLinear    Maps an encoded value to linear light
+	 * @param[in]  fromLinear  Maps linear light to an encoded value
+	 * @param[in]  name        The name of the transfer function
+	 */
+	LUTColorTransferFunction(const Curve & toLinear, const Curve & fromLinear, const std::string & name);
+
+public:
+	/**
+	 * @brief      Creates a transfer function from a pair of inverse curves
+	 *
+	 * @throws     std::domain_error  If either curve is empty
+	 *
+	 * @param[in]  toLinear    Maps an encoded value to linear light
+	 * @param[in]  fromLinear  Maps linear light to an encoded value
+	 * @param[in]  name        The name of the transfer function
+	 *
+	 * @return     A `LUTColorTransferFunction`
+	 */
+	static LUTColorTransferFunction withFunctions(const Curve & toLinear, const Curve & fromLinear, const std::string & name);
+
+	/**
+	 * @brief      A pure power function, mirrored for negative values
+	 *
+	 * @throws     std::domain_error  If gamma is not greater than 0
+	 *
+	 * @param[in]  gamma  The exponent applied when linearizing
+	 *
+	 * @return     A `LUTColorTransferFunction`
+	 */
+	static LUTColorTransferFunction gammaTransferFunction(double gamma);
+
+	/**
+	 * @brief      Get a vector of all known transfer functions
+	 *
+	 * @return     A `vector` of `LUTColorTransferFunction`s
+	 */
+	static std::vector<LUTColorTransferFunction> knownTransferFunctions();
+
+	static LUTColorTransferFunction linearTransferFunction();
+
+	/** @brief      IEC 61966-2-1 sRGB, mirrored for negative values */
+	static LUTColorTransferFunction sRGBTransferFunction();
+
+	/** @brief      ARRI LogC (v3) at EI 800, with scene linear 0.18 at 18% grey */
+	static LUTColorTransferFunction logCTransferFunction();
+
+	/** @brief      Sony S-Log3, with scene linear 0.18 at 18% grey */
+	static LUTColorTransferFunction sLog3TransferFunction();
+
+	/** @brief      Panasonic V-Log, with scene linear 0.18 at 18% grey */
+	static LUTColorTransferFunction vLogTransferFunction();
+
+	/**
+	 * @brief      SMPTE ST 2084 (PQ), with linear 1 at 10000 cd/m^2, mirrored
+	 *             for negative values
+	 */
+	static LUTColorTransferFunction pqTransferFunction();
+
+	/**
+	 * @brief      ITU-R BT.2100 hybrid log-gamma OETF, with scene linear 0 to
+	 *             1, mirrored for negative values
+	 */
+	static LUTColorTransferFunction hlgTransferFunction();
+
+	/**
+	 * @brief      A copy of this transfer function that evaluates both curves
+	 *             from precomputed tables.
+	 * @discussion Encoded values from -0.25 to 1.25 are linearized from a
+	 *             uniform table. Linear values are encoded from a table indexed
+	 *             by the exponent and leading mantissa bits of their single
+	 *             precision representation, so the samples are spaced
+	 *             logarithmically from 2^-24 to 2^16 in both signs. Evaluation
+	 *             is in single precision.
+	 *
+	 * @return     A `LUTColorTransferFunction` in fast mode
+	 */
+	LUTColorTransferFunction withFastEvaluation() const;
+
+	/**
+	 * @brief      Whether the curves are read from tables
+	 */
+	bool usesFastEvaluation() const { return linearTable != nullptr; }
+
+	/**
+	 * @brief      The largest error of the tables measured against the exact
+	 *             curves at eight points in every table segment, as an absolute
+	 *             error for results within -1 to 1 and a relative error
+	 *             beyond. 0 for exact evaluation.
+	 */
+	double getFastEvaluationError() const;
+
+	const std::string & getName() const { return name; }
+
+	/**
+	 * @brief      Maps an encoded value to linear light
+	 */
+	double toLinear(double value) const;
+
+	/**
+	 * @brief      Maps linear light to an encoded value
+	 */
+	double fromLinear(double value) const;
+
+	/**
+	 * @brief      Maps a span of encoded values to linear light.
+	 *             `input` and `output` may be the same span.
+	 *
+	 * @param[in]  input   The encoded values
+	 * @param[out] output  Receives the linear values
+	 * @param[in]  count   The number of values
+	 *
+	 * @tparam     T       `float` or `double`
+	 */
+	template <typename T>
+	void toLinear(const T * input, T * output, std::size_t count) const;
+
+	/**
+	 * @brief      Maps a span of linear values to encoded values.
+	 *             `input` and `output` may be the same span.
+	 *
+	 * @param[in]  input   The linear values
+	 * @param[out] output  Receives the encoded values
+	 * @param[in]  count   The number of values
+	 *
+	 * @tparam     T       `float` or `double`
+	 */
+	template <typename T>
+	void fromLinear(const T * input, T * output, std::size_t count) const;
+};
+
+extern template void LUTColorTransferFunction::toLinear<float>(const float *, float *, std::size_t) const;
+extern template void LUTColorTransferFunction::toLinear<double>(const double *, double *, std::size_t) const;
+extern template void LUTColorTransferFunction::fromLinear<float>(const float *, float *, std::size_t) const;
+extern template void LUTColorTransferFunction::fromLinear<double>(const double *, double *, std::size_t) const;
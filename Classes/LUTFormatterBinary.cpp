@@ -0,0 +1,303 @@
+#include "LUTFormatterBinary.h"
+#include "LUTAlignedBuffer.h"
+#include "LUTHelper.h"
+#include "LUTMappedFile.h"
+
+#include <cstring> // std::memcpy std::memcmp std::strncpy
+#include <fstream> // std::ofstream
+#include <stdexcept> // std::domain_error std::runtime_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+const char binarySignature[8] = { 'C', 'P', 'P', 'L', 'U', 'T', '3', 'D' };
+const std::uint32_t binaryVersion = 1;
+/** @brief      Reads back as a different value on a host of the other byte order */
+const std::uint32_t binaryByteOrder = 0x01020304;
+
+/**
+ * @brief      The header at the start of every binary LUT file. Its size is a
+ *             whole number of cache lines so the planes that follow stay
+ *             aligned in a mapping.
+ */
+struct BinaryHeader
+{
+	char signature[8];
+	std::uint32_t version;
+	std::uint32_t byteOrder;
+	std::uint32_t headerSize;
+	std::uint32_t size;
+	/** @brief      The number of floats from the start of one plane to the next */
+	std::uint64_t planeStride;
+	double inputLowerBound;
+	double inputUpperBound;
+	std::uint64_t contentHash;
+	double whitePointX;
+	double whitePointY;
+	char colorSpaceName[64];
+	char whitePointName[64];
+	char reserved[56];
+};
+
+static_assert(sizeof(BinaryHeader) == 256, "The binary LUT header must be 256 bytes");
+
+void copyName(char * destination, std::size_t capacity, const std::string & name)
+{
+	std::memset(destination, 0, capacity);
+	std::strncpy(destination, name.c_str(), capacity - 1);
+}
+
+std::string readName(const char * source, std::size_t capacity)
+{
+	std::size_t length = 0;
+	while (length < capacity && source[length] != '\0')
+	{
+		length++;
+	}
+	return std::string(source, length);
+}
+
+std::uint64_t hashFloatPlanes(const float * const planes[3], std::size_t pointCount, int size,
+                              double inputLowerBound, double inputUpperBound)
+{
+	const double shape[3] = { (double)size, inputLowerBound, inputUpperBound };
+	std::uint64_t hash = LUTHelper::hashBytes(shape, sizeof(shape));
+	for (int c = 0; c < 3; c++)
+	{
+		hash = LUTHelper::hashBytes(planes[c], pointCount * sizeof(float), hash);
+	}
+	return hash;
+}
+
+/**
+ * @brief      The lattice of a LUT as float32 planes, copied only when the
+ *             lattice is not already float32.
+ */
+template <typename T>
+struct FloatPlanes
+{
+	std::vector<float> storage;
+	const float * planes[3];
+
+	explicit FloatPlanes(const BasicLUT3D<T> & lut)
+	{
+		typedef typename LUTColorValueTraits<T>::ComputeType C;
+		const std::size_t count = lut.getPointCount();
+		const T * source[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+		storage.resize(3 * count);
+		for (int c = 0; c < 3; c++)
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				storage[c * count + i] = (float)(C)source[c][i];
+			}
+			planes[c] = storage.data() + c * count;
+		}
+	}
+};
+
+template <>
+struct FloatPlanes<float>
+{
+	const float * planes[3];
+
+	explicit FloatPlanes(const BasicLUT3D<float> & lut)
+	{
+		planes[0] = lut.redPlane();
+		planes[1] = lut.greenPlane();
+		planes[2] = lut.bluePlane();
+	}
+};
+
+template <typename T>
+void copyPlane(T * destination, const char * source, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		float value;
+		std::memcpy(&value, source + i * sizeof(float), sizeof(float));
+		destination[i] = (T)value;
+	}
+}
+
+void copyPlane(float * destination, const char * source, std::size_t count)
+{
+	std::memcpy(destination, source, count * sizeof(float));
+}
+
+BinaryHeader readHeader(const char * data, std::size_t length)
+{
+	BinaryHeader header;
+	if (length < sizeof(header))
+	{
+		throw std::domain_error("Invalid Binary LUT: the data is shorter than the header");
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.signature, binarySignature, sizeof(binarySignature)) != 0)
+	{
+		throw std::domain_error("Invalid Binary LUT: missing signature");
+	}
+	if (header.byteOrder != binaryByteOrder)
+	{
+		throw std::domain_error("Invalid Binary LUT: written on a host with a different byte order");
+	}
+	if (header.version != binaryVersion || header.headerSize != sizeof(header))
+	{
+		throw std::domain_error("Invalid Binary LUT: unsupported version " + std::to_string(header.version));
+	}
+	if (header.size < 2 || header.size > CPPLUT_MAX_LUT3D_SIZE)
+	{
+		throw std::domain_error("Invalid Binary LUT: size " + std::to_string(header.size) + " is out of range");
+	}
+	const std::uint64_t pointCount = (std::uint64_t)header.size * header.size * header.size;
+	if (header.planeStride != alignedElementCount<float>((std::size_t)pointCount))
+	{
+		throw std::domain_error("Invalid Binary LUT: plane stride " + std::to_string(header.planeStride)
+		                        + " does not match size " + std::to_string(header.size));
+	}
+	// divided rather than multiplied so a corrupt header cannot wrap around
+	if (header.planeStride > (length - sizeof(header)) / (3 * sizeof(float)))
+	{
+		throw std::domain_error("Invalid Binary LUT: the data is shorter than the lattice");
+	}
+	return header;
+}
+
+}
+
+LUTBinaryMetadata LUTBinaryMetadata::empty()
+{
+	LUTBinaryMetadata metadata = { "", "", 0, 0 };
+	return metadata;
+}
+
+LUTBinaryMetadata LUTBinaryMetadata::withColorSpace(const LUTColorSpace & colorSpace,
+                                                    const LUTColorSpaceWhitePoint & whitePoint)
+{
+	LUTBinaryMetadata metadata = { colorSpace.getName(), whitePoint.getName(),
+	                               whitePoint.getWhiteChromaticityX(), whitePoint.getWhiteChromaticityY() };
+	return metadata;
+}
+
+template <typename T>
+void LUTFormatterBinary::writeLUT3DToFile(const BasicLUT3D<T> & lut, const std::string & path,
+                                          const LUTBinaryMetadata & metadata)
+{
+	FloatPlanes<T> planes(lut);
+	const std::size_t pointCount = lut.getPointCount();
+
+	BinaryHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.signature, binarySignature, sizeof(binarySignature));
+	header.version = binaryVersion;
+	header.byteOrder = binaryByteOrder;
+	header.headerSize = sizeof(header);
+	header.size = (std::uint32_t)lut.getSize();
+	header.planeStride = alignedElementCount<float>(pointCount);
+	header.inputLowerBound = lut.getInputLowerBound();
+	header.inputUpperBound = lut.getInputUpperBound();
+	header.contentHash = hashFloatPlanes(planes.planes, pointCount, lut.getSize(),
+	                                     lut.getInputLowerBound(), lut.getInputUpperBound());
+	header.whitePointX = metadata.whitePointX;
+	header.whitePointY = metadata.whitePointY;
+	copyName(header.colorSpaceName, sizeof(header.colorSpaceName), metadata.colorSpaceName);
+	copyName(header.whitePointName, sizeof(header.whitePointName), metadata.whitePointName);
+
+	std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		throw std::runtime_error("Unable to open file for writing: " + path);
+	}
+	stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	const std::vector<float> padding(header.planeStride - pointCount, 0.0f);
+	for (int c = 0; c < 3; c++)
+	{
+		stream.write(reinterpret_cast<const char *>(planes.planes[c]), pointCount * sizeof(float));
+		stream.write(reinterpret_cast<const char *>(padding.data()), padding.size() * sizeof(float));
+	}
+	if (!stream)
+	{
+		throw std::runtime_error("Unable to write file: " + path);
+	}
+}
+
+template <typename T>
+BasicLUT3D<T> LUTFormatterBinary::readLUT3DFromFile(const std::string & path, LUTBinaryMetadata * metadata)
+{
+	LUTMappedFile file = LUTMappedFile::withPath(path);
+	return readLUT3DFromData<T>(file.data(), file.size(), metadata);
+}
+
+template <typename T>
+BasicLUT3D<T> LUTFormatterBinary::readLUT3DFromData(const char * data, std::size_t length, LUTBinaryMetadata * metadata)
+{
+	BinaryHeader header = readHeader(data, length);
+	const std::size_t pointCount = (std::size_t)header.size * header.size * header.size;
+
+	const char * planeData = data + sizeof(header);
+	const float * filePlanes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		// only handed to hashBytes, which reads through memcpy, as the data need not be aligned
+		filePlanes[c] = reinterpret_cast<const float *>(planeData + c * header.planeStride * sizeof(float));
+	}
+	if (hashFloatPlanes(filePlanes, pointCount, (int)header.size, header.inputLowerBound,
+	                    header.inputUpperBound) != header.contentHash)
+	{
+		throw std::domain_error("Invalid Binary LUT: the lattice does not match its content hash");
+	}
+
+	BasicLUT3D<T> lut = BasicLUT3D<T>::withSize((int)header.size, header.inputLowerBound, header.inputUpperBound);
+	T * planes[3] = { lut.redPlane(), lut.greenPlane(), lut.bluePlane() };
+	for (int c = 0; c < 3; c++)
+	{
+		copyPlane(planes[c], reinterpret_cast<const char *>(filePlanes[c]), pointCount);
+	}
+
+	if (metadata != nullptr)
+	{
+		metadata->colorSpaceName = readName(header.colorSpaceName, sizeof(header.colorSpaceName));
+		metadata->whitePointName = readName(header.whitePointName, sizeof(header.whitePointName));
+		metadata->whitePointX = header.whitePointX;
+		metadata->whitePointY = header.whitePointY;
+	}
+	return lut;
+}
+
+bool LUTFormatterBinary::isBinaryData(const char * data, std::size_t length)
+{
+	return length >= sizeof(binarySignature) && std::memcmp(data, binarySignature, sizeof(binarySignature)) == 0;
+}
+
+std::uint64_t LUTFormatterBinary::storedContentHash(const char * data, std::size_t length)
+{
+	return readHeader(data, length).contentHash;
+}
+
+template <typename T>
+std::uint64_t LUTFormatterBinary::contentHash(const BasicLUT3D<T> & lut)
+{
+	FloatPlanes<T> planes(lut);
+	return hashFloatPlanes(planes.planes, lut.getPointCount(), lut.getSize(),
+	                       lut.getInputLowerBound(), lut.getInputUpperBound());
+}
+
+namespace CppLUT
+{
+template void LUTFormatterBinary::writeLUT3DToFile<float>(const LUT3Df &, const std::string &, const LUTBinaryMetadata &);
+template void LUTFormatterBinary::writeLUT3DToFile<double>(const LUT3D &, const std::string &, const LUTBinaryMetadata &);
+template void LUTFormatterBinary::writeLUT3DToFile<LUTHalf>(const LUT3Dh &, const std::string &, const LUTBinaryMetadata &);
+template LUT3Df LUTFormatterBinary::readLUT3DFromFile<float>(const std::string &, LUTBinaryMetadata *);
+template LUT3D LUTFormatterBinary::readLUT3DFromFile<double>(const std::string &, LUTBinaryMetadata *);
+template LUT3Dh LUTFormatterBinary::readLUT3DFromFile<LUTHalf>(const std::string &, LUTBinaryMetadata *);
+template LUT3Df LUTFormatterBinary::readLUT3DFromData<float>(const char *, std::size_t, LUTBinaryMetadata *);
+template LUT3D LUTFormatterBinary::readLUT3DFromData<double>(const char *, std::size_t, LUTBinaryMetadata *);
+template LUT3Dh LUTFormatterBinary::readLUT3DFromData<LUTHalf>(const char *, std::size_t, LUTBinaryMetadata *);
+template std::uint64_t LUTFormatterBinary::contentHash<float>(const LUT3Df &);
+template std::uint64_t LUTFormatterBinary::contentHash<double>(const LUT3D &);
+template std::uint64_t LUTFormatterBinary::contentHash<LUTHalf>(const LUT3Dh &);
+}
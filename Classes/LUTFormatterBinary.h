@@ -0,0 +1,159 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT3D.h"
+#include "LUTColorSpace.h"
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <string> // std::string
+
+namespace CppLUT
+{
+
+/**
+ * @brief      The color space a binary LUT's output is in, stored alongside
+ *             the lattice.
+ */
+struct LUTBinaryMetadata
+{
+	std::string colorSpaceName;
+	std::string whitePointName;
+	double whitePointX;
+	double whitePointY;
+
+	/**
+	 * @brief      Metadata with no color space and a white point of (0, 0)
+	 */
+	static LUTBinaryMetadata empty();
+
+	/**
+	 * @brief      Metadata naming a color space and white point
+	 *
+	 * @param[in]  colorSpace  The color space
+	 * @param[in]  whitePoint  The white point
+	 *
+	 * @return     The metadata
+	 */
+	static LUTBinaryMetadata withColorSpace(const LUTColorSpace & colorSpace, const LUTColorSpaceWhitePoint & whitePoint);
+};
+
+/**
+ * @brief      Reads and writes LUTs in the CppLUT binary format.
+ * @discussion A file is a 256 byte header followed by the red, green and
+ *             blue planes as float32 in the writing host's byte order, each
+ *             padded to a whole number of cache lines, in the same point
+ *             order as `LUT3D`. Files written on a host with the other byte
+ *             order are rejected.
+ *             The header holds the size, input bounds, metadata and a
+ *             `LUTHelper::hashBytes` content hash of the lattice, which is
+ *             checked on read. Reading maps the file and copies the planes
+ *             straight into the LUT; there is no text to parse.
+ */
+class LUTFormatterBinary
+{
+public:
+	LUTFormatterBinary() = delete;
+
+	/**
+	 * @brief      Writes a LUT3D to a binary file
+	 *
+	 * @throws     std::runtime_error  If the file cannot be written
+	 *
+	 * @param[in]  lut       The LUT
+	 * @param[in]  path      The path of the file
+	 * @param[in]  metadata  The metadata to store with the lattice
+	 *
+	 * @tparam     T         The lattice value type of the LUT
+	 */
+	template <typename T>
+	static void writeLUT3DToFile(const BasicLUT3D<T> & lut, const std::string & path,
+	                             const LUTBinaryMetadata & metadata = LUTBinaryMetadata::empty());
+
+	/**
+	 * @brief      Reads a LUT3D from a binary file
+	 *
+	 * @throws     std::runtime_error  If the file cannot be read
+	 * @throws     std::domain_error   If the file is not a valid binary LUT or
+	 *                                 its content hash does not match
+	 *
+	 * @param[in]  path      The path of the file
+	 * @param[out] metadata  Receives the stored metadata, if not null
+	 *
+	 * @tparam     T         The lattice value type of the returned LUT
+	 *
+	 * @return     The LUT
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT3D<T> readLUT3DFromFile(const std::string & path, LUTBinaryMetadata * metadata = nullptr);
+
+	/**
+	 * @brief      Reads a LUT3D from the contents of a binary file
+	 *
+	 * @throws     std::domain_error  If the data is not a valid binary LUT or
+	 *                                its content hash does not match
+	 *
+	 * @param[in]  data      The contents of the file
+	 * @param[in]  length    The length of `data` in bytes
+	 * @param[out] metadata  Receives the stored metadata, if not null
+	 *
+	 * @tparam     T         The lattice value type of the returned LUT
+	 *
+	 * @return     The LUT
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT3D<T> readLUT3DFromData(const char * data, std::size_t length, LUTBinaryMetadata * metadata = nullptr);
+
+	/**
+	 * @brief      Checks whether data starts with a binary LUT header
+	 *
+	 * @param[in]  data    The data
+	 * @param[in]  length  The length of `data` in bytes
+	 *
+	 * @return     True if the data has the binary LUT signature
+	 */
+	static bool isBinaryData(const char * data, std::size_t length);
+
+	/**
+	 * @brief      Reads the content hash stored in a binary LUT header without
+	 *             reading or checking the lattice
+	 *
+	 * @throws     std::domain_error  If the data does not start with a valid
+	 *                                header
+	 *
+	 * @param[in]  data    The data
+	 * @param[in]  length  The length of `data` in bytes
+	 *
+	 * @return     The stored hash
+	 */
+	static std::uint64_t storedContentHash(const char * data, std::size_t length);
+
+	/**
+	 * @brief      The content hash of a LUT's lattice as float32, together
+	 *             with its size and input bounds. Equal for equal LUTs of any
+	 *             value type that round to the same float32 lattice.
+	 *
+	 * @param[in]  lut   The LUT
+	 *
+	 * @tparam     T     The lattice value type of the LUT
+	 *
+	 * @return     The hash
+	 */
+	template <typename T>
+	static std::uint64_t contentHash(const BasicLUT3D<T> & lut);
+};
+
+extern template void LUTFormatterBinary::writeLUT3DToFile<float>(const LUT3Df &, const std::string &, const LUTBinaryMetadata &);
+extern template void LUTFormatterBinary::writeLUT3DToFile<double>(const LUT3D &, const std::string &, const LUTBinaryMetadata &);
+extern template void LUTFormatterBinary::writeLUT3DToFile<LUTHalf>(const LUT3Dh &, const std::string &, const LUTBinaryMetadata &);
+extern template LUT3Df LUTFormatterBinary::readLUT3DFromFile<float>(const std::string &, LUTBinaryMetadata *);
+extern template LUT3D LUTFormatterBinary::readLUT3DFromFile<double>(const std::string &, LUTBinaryMetadata *);
+extern template LUT3Dh LUTFormatterBinary::readLUT3DFromFile<LUTHalf>(const std::string &, LUTBinaryMetadata *);
+extern template LUT3Df LUTFormatterBinary::readLUT3DFromData<float>(const char *, std::size_t, LUTBinaryMetadata *);
+extern template LUT3D LUTFormatterBinary::readLUT3DFromData<double>(const char *, std::size_t, LUTBinaryMetadata *);
+extern template LUT3Dh LUTFormatterBinary::readLUT3DFromData<LUTHalf>(const char *, std::size_t, LUTBinaryMetadata *);
+extern template std::uint64_t LUTFormatterBinary::contentHash<float>(const LUT3Df &);
+extern template std::uint64_t LUTFormatterBinary::contentHash<double>(const LUT3D &);
+extern template std::uint64_t LUTFormatterBinary::contentHash<LUTHalf>(const LUT3Dh &);
+
+}
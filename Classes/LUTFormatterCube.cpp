@@ -0,0 +1,266 @@
+#include "LUTFormatterCube.h"
+#include "LUTHelper.h"
+#include "LUTMappedFile.h"
+
+#include <algorithm> // std::count
+#include <cmath> // std::floor
+#include <cstring> // std::strncmp
+#include <stdexcept> // std::domain_error
+#include <string> // std::string std::to_string
+
+using namespace CppLUT;
+
+namespace
+{
+
+inline bool isBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char * skipBlanks(const char * c, const char * end)
+{
+	while (c < end && isBlank(*c))
+	{
+		c++;
+	}
+	return c;
+}
+
+inline const char * skipLine(const char * c, const char * end)
+{
+	while (c < end && *c != '\n')
+	{
+		c++;
+	}
+	return (c < end) ? c + 1 : c;
+}
+
+/**
+ * @brief      Skips whitespace, newlines and comment lines between values
+ */
+inline const char * skipSeparators(const char * c, const char * end)
+{
+	for (;;)
+	{
+		while (c < end && (isBlank(*c) || *c == '\n'))
+		{
+			c++;
+		}
+		if (c < end && *c == '#')
+		{
+			c = skipLine(c, end);
+			continue;
+		}
+		return c;
+	}
+}
+
+inline bool matchesKeyword(const char * c, const char * end, const char * keyword, std::size_t length)
+{
+	return (std::size_t)(end - c) >= length && std::strncmp(c, keyword, length) == 0
+	       && (c + length == end || isBlank(c[length]) || c[length] == '\n');
+}
+
+std::string lineDescription(const char * data, const char * position)
+{
+	return "line " + std::to_string(std::count(data, position, '\n') + 1);
+}
+
+void readNumbers(const char * data, const char * & c, const char * end, double * values, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		c = skipBlanks(c, end);
+		if (!LUTHelper::parseNumber(c, end, values[i]))
+		{
+			throw std::domain_error("Invalid Cube File: expected a number on " + lineDescription(data, c));
+		}
+	}
+}
+
+/**
+ * @brief      Reads a LUT_1D_SIZE or LUT_3D_SIZE value, checking it is a whole
+ *             number in range before it is converted to an int
+ */
+int readSize(const char * data, const char * & c, const char * end, const char * keyword, int maximumSize)
+{
+	double value;
+	const char * position = c;
+	readNumbers(data, c, end, &value, 1);
+	if (!(value >= 2 && value <= maximumSize) || value != std::floor(value))
+	{
+		throw std::domain_error(std::string("Invalid Cube File: ") + keyword + " on " + lineDescription(data, position)
+		                        + " must be a whole number in the range 2 to " + std::to_string(maximumSize));
+	}
+	return (int)value;
+}
+
+/**
+ * @brief      The keywords read from the header of a .cube file
+ */
+struct CubeHeader
+{
+	int size3D;
+	int size1D;
+	double domainMin[3];
+	double domainMax[3];
+};
+
+/**
+ * @brief      Reads keywords and comments until the first line starting with
+ *             a number, leaving `c` at that number.
+ */
+CubeHeader readHeader(const char * data, const char * & c, const char * end)
+{
+	CubeHeader header = { 0, 0, { 0, 0, 0 }, { 1, 1, 1 } };
+	for (;;)
+	{
+		c = skipSeparators(c, end);
+		if (c == end || !((*c >= 'A' && *c <= 'Z') || (*c >= 'a' && *c <= 'z')))
+		{
+			break;
+		}
+
+		const char * keyword = c;
+		while (c < end && !isBlank(*c) && *c != '\n')
+		{
+			c++;
+		}
+		if (matchesKeyword(keyword, end, "LUT_3D_SIZE", 11))
+		{
+			header.size3D = readSize(data, c, end, "LUT_3D_SIZE", CPPLUT_MAX_LUT3D_SIZE);
+		}
+		else if (matchesKeyword(keyword, end, "LUT_1D_SIZE", 11))
+		{
+			header.size1D = readSize(data, c, end, "LUT_1D_SIZE", CPPLUT_MAX_LUT1D_SIZE);
+		}
+		else if (matchesKeyword(keyword, end, "DOMAIN_MIN", 10))
+		{
+			readNumbers(data, c, end, header.domainMin, 3);
+		}
+		else if (matchesKeyword(keyword, end, "DOMAIN_MAX", 10))
+		{
+			readNumbers(data, c, end, header.domainMax, 3);
+		}
+		else if (matchesKeyword(keyword, end, "LUT_3D_INPUT_RANGE", 18)
+		         || matchesKeyword(keyword, end, "LUT_1D_INPUT_RANGE", 18))
+		{
+			double range[2];
+			readNumbers(data, c, end, range, 2);
+			header.domainMin[0] = header.domainMin[1] = header.domainMin[2] = range[0];
+			header.domainMax[0] = header.domainMax[1] = header.domainMax[2] = range[1];
+		}
+		// TITLE and unknown keywords are ignored
+		c = skipLine(c, end);
+	}
+
+	if (header.domainMin[0] != header.domainMin[1] || header.domainMin[0] != header.domainMin[2]
+	    || header.domainMax[0] != header.domainMax[1] || header.domainMax[0] != header.domainMax[2])
+	{
+		throw std::domain_error("Invalid Cube File: per-channel DOMAIN_MIN/DOMAIN_MAX values are not supported");
+	}
+	return header;
+}
+
+/**
+ * @brief      Parses `pointCount` RGB triples straight into three planes and
+ *             checks that nothing but comments follows them.
+ */
+template <typename T>
+void readPoints(const char * data, const char * c, const char * end,
+                T * red, T * green, T * blue, std::size_t pointCount, const char * pointName)
+{
+	for (std::size_t i = 0; i < pointCount; i++)
+	{
+		double rgb[3];
+		for (int channel = 0; channel < 3; channel++)
+		{
+			c = skipSeparators(c, end);
+			if (!LUTHelper::parseNumber(c, end, rgb[channel]))
+			{
+				throw std::domain_error("Invalid Cube File: expected " + std::to_string(pointCount) + " " + pointName
+				                        + " but found " + std::to_string(i)
+				                        + ", stopped at " + lineDescription(data, c));
+			}
+		}
+		red[i] = (T)rgb[0];
+		green[i] = (T)rgb[1];
+		blue[i] = (T)rgb[2];
+	}
+
+	c = skipSeparators(c, end);
+	if (c != end)
+	{
+		throw std::domain_error("Invalid Cube File: unexpected data after the " + std::string(pointName)
+		                        + " on " + lineDescription(data, c));
+	}
+}
+
+}
+
+template <typename T>
+BasicLUT3D<T> LUTFormatterCube::readLUT3DFromFile(const std::string & path)
+{
+	LUTMappedFile file = LUTMappedFile::withPath(path);
+	return readLUT3DFromData<T>(file.data(), file.size());
+}
+
+template <typename T>
+BasicLUT3D<T> LUTFormatterCube::readLUT3DFromData(const char * data, std::size_t length)
+{
+	const char * c = data;
+	const char * end = data + length;
+	CubeHeader header = readHeader(data, c, end);
+
+	if (header.size3D == 0)
+	{
+		throw std::domain_error(header.size1D != 0 ? "Invalid Cube File: 1D cube files are not supported by readLUT3D"
+		                                           : "Invalid Cube File: missing LUT_3D_SIZE");
+	}
+
+	BasicLUT3D<T> lut = BasicLUT3D<T>::withSize(header.size3D, header.domainMin[0], header.domainMax[0]);
+	readPoints(data, c, end, lut.redPlane(), lut.greenPlane(), lut.bluePlane(), lut.getPointCount(), "lattice points");
+	return lut;
+}
+
+template <typename T>
+BasicLUT1D<T> LUTFormatterCube::readLUT1DFromFile(const std::string & path)
+{
+	LUTMappedFile file = LUTMappedFile::withPath(path);
+	return readLUT1DFromData<T>(file.data(), file.size());
+}
+
+template <typename T>
+BasicLUT1D<T> LUTFormatterCube::readLUT1DFromData(const char * data, std::size_t length)
+{
+	const char * c = data;
+	const char * end = data + length;
+	CubeHeader header = readHeader(data, c, end);
+
+	if (header.size1D == 0)
+	{
+		throw std::domain_error(header.size3D != 0 ? "Invalid Cube File: 3D cube files are not supported by readLUT1D"
+		                                           : "Invalid Cube File: missing LUT_1D_SIZE");
+	}
+
+	BasicLUT1D<T> lut = BasicLUT1D<T>::withSize(header.size1D, header.domainMin[0], header.domainMax[0]);
+	readPoints(data, c, end, lut.redCurve(), lut.greenCurve(), lut.blueCurve(), (std::size_t)header.size1D, "curve points");
+	return lut;
+}
+
+namespace CppLUT
+{
+template LUT3Df LUTFormatterCube::readLUT3DFromFile<float>(const std::string &);
+template LUT3D LUTFormatterCube::readLUT3DFromFile<double>(const std::string &);
+template LUT3Dh LUTFormatterCube::readLUT3DFromFile<LUTHalf>(const std::string &);
+template LUT3Df LUTFormatterCube::readLUT3DFromData<float>(const char *, std::size_t);
+template LUT3D LUTFormatterCube::readLUT3DFromData<double>(const char *, std::size_t);
+template LUT3Dh LUTFormatterCube::readLUT3DFromData<LUTHalf>(const char *, std::size_t);
+template LUT1Df LUTFormatterCube::readLUT1DFromFile<float>(const std::string &);
+template LUT1D LUTFormatterCube::readLUT1DFromFile<double>(const std::string &);
+template LUT1Dh LUTFormatterCube::readLUT1DFromFile<LUTHalf>(const std::string &);
+template LUT1Df LUTFormatterCube::readLUT1DFromData<float>(const char *, std::size_t);
+template LUT1D LUTFormatterCube::readLUT1DFromData<double>(const char *, std::size_t);
+template LUT1Dh LUTFormatterCube::readLUT1DFromData<LUTHalf>(const char *, std::size_t);
+}
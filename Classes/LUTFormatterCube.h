@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+
+#include <cstddef> // std::size_t
+#include <string> // std::string
+
+namespace CppLUT
+{
+
+/**
+ * @brief      Reads Resolve and Adobe .cube files.
+ * @discussion The file is memory-mapped and parsed in a single pass with no
+ *             per-line allocation: header keywords are matched in place and
+ *             lattice and curve values are parsed straight into the planes
+ *             of the returned LUT.
+ */
+class LUTFormatterCube
+{
+public:
+	LUTFormatterCube() = delete;
+
+	/**
+	 * @brief      Reads a 3D LUT from a .cube file
+	 *
+	 * @throws     std::runtime_error  If the file cannot be read
+	 * @throws     std::domain_error   If the file is not a valid 3D .cube file
+	 *
+	 * @param[in]  path  The path of the .cube file
+	 *
+	 * @tparam     T     The lattice value type of the returned LUT
+	 *
+	 * @return     The LUT described by the file
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT3D<T> readLUT3DFromFile(const std::string & path);
+
+	/**
+	 * @brief      Reads a 3D LUT from the contents of a .cube file
+	 *
+	 * @throws     std::domain_error  If the data is not a valid 3D .cube file
+	 *
+	 * @param[in]  data    The contents of the file, need not be null terminated
+	 * @param[in]  length  The length of `data` in bytes
+	 *
+	 * @tparam     T       The lattice value type of the returned LUT
+	 *
+	 * @return     The LUT described by the data
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT3D<T> readLUT3DFromData(const char * data, std::size_t length);
+
+	/**
+	 * @brief      Reads a 1D LUT from a .cube file
+	 *
+	 * @throws     std::runtime_error  If the file cannot be read
+	 * @throws     std::domain_error   If the file is not a valid 1D .cube file
+	 *
+	 * @param[in]  path  The path of the .cube file
+	 *
+	 * @tparam     T     The curve value type of the returned LUT
+	 *
+	 * @return     The LUT described by the file
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT1D<T> readLUT1DFromFile(const std::string & path);
+
+	/**
+	 * @brief      Reads a 1D LUT from the contents of a .cube file
+	 *
+	 * @throws     std::domain_error  If the data is not a valid 1D .cube file
+	 *
+	 * @param[in]  data    The contents of the file, need not be null terminated
+	 * @param[in]  length  The length of `data` in bytes
+	 *
+	 * @tparam     T       The curve value type of the returned LUT
+	 *
+	 * @return     The LUT described by the data
+	 */
+	template <typename T = LUTColorValue>
+	static BasicLUT1D<T> readLUT1DFromData(const char * data, std::size_t length);
+};
+
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CppLUT.h"
+
+#include <cstdint> // std::uint16_t std::uint32_t
+#include <cstring> // std::memcpy
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace CppLUT
+{
+
+/**
+ * @brief      An IEEE 754 binary16 (half precision) floating-point value.
+ * @discussion Only storage is half precision. The value converts implicitly
+ *             to and from `float`, so arithmetic is carried out in single
+ *             precision and rounded (to nearest, ties to even) when stored.
+ */
+class LUTHalf
+{
+private:
+	/** @brief      The raw binary16 bit pattern */
+	std::uint16_t bits;
+
+	static std::uint16_t floatToBits(float value)
+	{
+#if defined(__F16C__)
+		return (std::uint16_t)_cvtss_sh(value, 0);
+#else
+		std::uint32_t f;
+		std::memcpy(&f, &value, sizeof(f));
+		std::uint32_t sign = (f >> 16) & 0x8000;
+		std::uint32_t exponent = (f >> 23) & 0xFF;
+		std::uint32_t mantissa = f & 0x7FFFFF;
+
+		if (exponent == 0xFF)
+		{
+			// infinity stays infinity, NaN stays a quiet NaN
+			return (std::uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 | (mantissa >> 13) : 0));
+		}
+
+		int halfExponent = (int)exponent - 127 + 15;
+		if (halfExponent >= 0x1F)
+		{
+			return (std::uint16_t)(sign | 0x7C00);
+		}
+		if (halfExponent <= 0)
+		{
+			if (halfExponent < -10)
+			{
+				return (std::uint16_t)sign;
+			}
+			mantissa |= 0x800000;
+			int shift = 14 - halfExponent;
+			std::uint32_t halfMantissa = mantissa >> shift;
+			std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+			std::uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (halfMantissa & 1)))
+			{
+				halfMantissa++;
+			}
+			return (std::uint16_t)(sign | halfMantissa);
+		}
+
+		std::uint32_t half = ((std::uint32_t)halfExponent << 10) | (mantissa >> 13);
+		std::uint32_t remainder = mantissa & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			// a carry out of the mantissa correctly bumps the exponent
+			half++;
+		}
+		return (std::uint16_t)(sign | half);
+#endif
+	}
+
+	static float bitsToFloat(std::uint16_t half)
+	{
+#if defined(__F16C__)
+		return _cvtsh_ss(half);
+#else
+		std::uint32_t sign = (std::uint32_t)(half & 0x8000) << 16;
+		std::uint32_t exponent = (half >> 10) & 0x1F;
+		std::uint32_t mantissa = half & 0x3FF;
+		std::uint32_t f;
+
+		if (exponent == 0)
+		{
+			if (mantissa == 0)
+			{
+				f = sign;
+			}
+			else
+			{
+				int e = 1;
+				while (!(mantissa & 0x400))
+				{
+					mantissa <<= 1;
+					e--;
+				}
+				mantissa &= 0x3FF;
+				f = sign | ((std::uint32_t)(e + 127 - 15) << 23) | (mantissa << 13);
+			}
+		}
+		else if (exponent == 0x1F)
+		{
+			f = sign | 0x7F800000 | (mantissa << 13);
+		}
+		else
+		{
+			f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+
+		float value;
+		std::memcpy(&value, &f, sizeof(value));
+		return value;
+#endif
+	}
+
+public:
+	LUTHalf() = default;
+
+	/**
+	 * @brief      Creates a half by rounding a single precision value
+	 *
+	 * @param[in]  value  The value to store
+	 */
+	LUTHalf(float value): bits(floatToBits(value)) {}
+
+	/**
+	 * @brief      Creates a half from a raw binary16 bit pattern
+	 *
+	 * @param[in]  bits  The bit pattern
+	 *
+	 * @return     A `LUTHalf`
+	 */
+	static LUTHalf fromBits(std::uint16_t bits)
+	{
+		LUTHalf half;
+		half.bits = bits;
+		return half;
+	}
+
+	/**
+	 * @brief      Gets the raw binary16 bit pattern
+	 *
+	 * @return     The bit pattern
+	 */
+	std::uint16_t getBits() const { return bits; }
+
+	operator float() const { return bitsToFloat(bits); }
+};
+
+}
@@ -1,63 +1,212 @@
 #include "LUTHelper.h"
 #include <cmath> // std::round
 #include <typeinfo> // typeid
-#include <exception> // std::domain_error
-#include <cstdio> // std::sprintf
+#include <stdexcept> // std::domain_error
+#include <cstdio> // std::snprintf
+#include <cstring> // std::memcpy
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <exception> // std::exception_ptr
+#include <limits> // std::numeric_limits
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <thread> // std::thread
 
-double LUTHelper::remap(double value, double inputLow, double inputHigh, double outputLow, double outputHigh)
+template <typename T>
+T LUTHelper::remap(NonDeduced<T> value, NonDeduced<T> inputLow, NonDeduced<T> inputHigh,
+                   NonDeduced<T> outputLow, NonDeduced<T> outputHigh)
 {
 	if(value < inputLow || value > inputHigh)
 	{
 		char msg[256];
-		std::sprintf(msg, "Remap value out of bounds: Tried to remap out-of-bounds value (%f) with input constraints low:%f high:%f", value, inputLow, inputHigh);
+		std::snprintf(msg, sizeof msg, "Remap value out of bounds: Tried to remap out-of-bounds value (%f) with input constraints low:%f high:%f", (double)value, (double)inputLow, (double)inputHigh);
 		throw std::domain_error(msg);
 	}
 	if(inputLow > inputHigh)
 	{
 		char msg[256];
-		std::sprintf(msg, "RemapInputsError: Inputs low:%f high:%f. low must be less than or equal to high", inputLow, inputHigh);
+		std::snprintf(msg, sizeof msg, "RemapInputsError: Inputs low:%f high:%f. low must be less than or equal to high", (double)inputLow, (double)inputHigh);
 		throw std::domain_error(msg);
 	}
 	if(outputLow > outputHigh)
 	{
 		char msg[256];
-		std::sprintf(msg, "RemapOutputsError: Outputs low:%f high:%f. low must be less than or equal to high", outputLow, outputHigh);
+		std::snprintf(msg, sizeof msg, "RemapOutputsError: Outputs low:%f high:%f. low must be less than or equal to high", (double)outputLow, (double)outputHigh);
 		throw std::domain_error(msg);
 	}
-	return remapNoError(value, inputLow, inputHigh, outputLow, outputHigh);
+	return remapNoError<T>(value, inputLow, inputHigh, outputLow, outputHigh);
 }
 
-double LUTHelper::lerp1d(double beginning, double end, double value01)
+template <typename T>
+T LUTHelper::lerp1d(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> value01)
 {
 	if (value01 < 0 || value01 > 1)
 	{
 		throw std::domain_error("Invalid Lerp: Value out of bounds");
 	}
-	double range = end - beginning;
-	return (beginning + range * value01);
+	return lerp1dNoError<T>(beginning, end, value01);
 }
 
-double LUTHelper::smootherstep(double beginning, double end, double percentage)
+template <typename T>
+T LUTHelper::smootherstep(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage)
 {
 	if(percentage < 0 || percentage > 1)
 	{
 		throw std::domain_error("Invalid Smoothstep: Percentage out of bounds [0-1]");
 	}
-	percentage = remap(percentage, 0, 1, beginning, end);
-	return percentage*percentage*percentage*(percentage*(percentage*6.0 - 15.0) + 10.0);
+	percentage = remap<T>(percentage, 0, 1, beginning, end);
+	return smootherstepPolynomial<T>(percentage);
 }
 
-double LUTHelper::smoothstep(double beginning, double end, double percentage)
+template <typename T>
+T LUTHelper::smoothstep(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage)
 {
 	if(percentage < 0 || percentage > 1)
 	{
 		throw std::domain_error("Invalid Smoothstep: Percentage out of bounds [0-1]");
 	}
-	percentage = remap(percentage, 0, 1, beginning, end);
+	percentage = remap<T>(percentage, 0, 1, beginning, end);
 	// Evaluate polynomial
-	return percentage*percentage*(3 - 2*percentage);
+	return smoothstepPolynomial<T>(percentage);
 }
 
+namespace
+{
+	/** @brief      The type values are compared in; halves widen to float */
+	template <typename T>
+	struct RangeType { typedef T type; };
+
+	template <>
+	struct RangeType<CppLUT::LUTHalf> { typedef float type; };
+
+	/**
+	 * @brief      Finds the smallest and largest of `count` values without
+	 *             branching on each one. A NaN value makes the range NaN.
+	 */
+	template <typename T, typename C>
+	void valueRange(const T * values, std::size_t count, C & minimum, C & maximum)
+	{
+		minimum = std::numeric_limits<C>::infinity();
+		maximum = -std::numeric_limits<C>::infinity();
+		bool unordered = false;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const C value = values[i];
+			minimum = (value < minimum) ? value : minimum;
+			maximum = (value > maximum) ? value : maximum;
+			unordered |= (value != value);
+		}
+		if (unordered)
+		{
+			minimum = maximum = std::numeric_limits<C>::quiet_NaN();
+		}
+	}
+
+	template <typename T>
+	void checkPercentages(const T * values, std::size_t count, const char * msg)
+	{
+		typename RangeType<T>::type minimum, maximum;
+		valueRange(values, count, minimum, maximum);
+		if (count != 0 && !(minimum >= 0 && maximum <= 1))
+		{
+			throw std::domain_error(msg);
+		}
+	}
+}
+
+template <typename T>
+void LUTHelper::remap(const T * input, T * output, std::size_t count,
+                      NonDeduced<T> inputLow, NonDeduced<T> inputHigh, NonDeduced<T> outputLow, NonDeduced<T> outputHigh)
+{
+	typename RangeType<T>::type minimum, maximum;
+	valueRange(input, count, minimum, maximum);
+	if (count != 0 && !(minimum >= inputLow && maximum <= inputHigh))
+	{
+		char msg[256];
+		std::snprintf(msg, sizeof msg, "Remap value out of bounds: Tried to remap out-of-bounds values (%f to %f) with input constraints low:%f high:%f", (double)minimum, (double)maximum, (double)inputLow, (double)inputHigh);
+		throw std::domain_error(msg);
+	}
+	if(inputLow > inputHigh)
+	{
+		char msg[256];
+		std::snprintf(msg, sizeof msg, "RemapInputsError: Inputs low:%f high:%f. low must be less than or equal to high", (double)inputLow, (double)inputHigh);
+		throw std::domain_error(msg);
+	}
+	if(outputLow > outputHigh)
+	{
+		char msg[256];
+		std::snprintf(msg, sizeof msg, "RemapOutputsError: Outputs low:%f high:%f. low must be less than or equal to high", (double)outputLow, (double)outputHigh);
+		throw std::domain_error(msg);
+	}
+	for (std::size_t i = 0; i < count; i++)
+	{
+		output[i] = remapNoError<T>(input[i], inputLow, inputHigh, outputLow, outputHigh);
+	}
+}
+
+template <typename T>
+void LUTHelper::lerp1d(NonDeduced<T> beginning, NonDeduced<T> end, const T * values01, T * output, std::size_t count)
+{
+	checkPercentages(values01, count, "Invalid Lerp: Value out of bounds");
+	for (std::size_t i = 0; i < count; i++)
+	{
+		output[i] = lerp1dNoError<T>(beginning, end, values01[i]);
+	}
+}
+
+template <typename T>
+void LUTHelper::smoothstep(NonDeduced<T> beginning, NonDeduced<T> end, const T * percentages, T * output, std::size_t count)
+{
+	checkPercentages(percentages, count, "Invalid Smoothstep: Percentage out of bounds [0-1]");
+	if (beginning > end)
+	{
+		throw std::domain_error("RemapOutputsError: beginning must be less than or equal to end");
+	}
+	for (std::size_t i = 0; i < count; i++)
+	{
+		output[i] = smoothstepNoError<T>(beginning, end, percentages[i]);
+	}
+}
+
+template <typename T>
+void LUTHelper::smootherstep(NonDeduced<T> beginning, NonDeduced<T> end, const T * percentages, T * output, std::size_t count)
+{
+	checkPercentages(percentages, count, "Invalid Smoothstep: Percentage out of bounds [0-1]");
+	if (beginning > end)
+	{
+		throw std::domain_error("RemapOutputsError: beginning must be less than or equal to end");
+	}
+	for (std::size_t i = 0; i < count; i++)
+	{
+		output[i] = smootherstepNoError<T>(beginning, end, percentages[i]);
+	}
+}
+
+template float LUTHelper::remap<float>(float, float, float, float, float);
+template double LUTHelper::remap<double>(double, double, double, double, double);
+template CppLUT::LUTHalf LUTHelper::remap<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+template float LUTHelper::lerp1d<float>(float, float, float);
+template double LUTHelper::lerp1d<double>(double, double, double);
+template CppLUT::LUTHalf LUTHelper::lerp1d<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+template float LUTHelper::smootherstep<float>(float, float, float);
+template double LUTHelper::smootherstep<double>(double, double, double);
+template CppLUT::LUTHalf LUTHelper::smootherstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+template float LUTHelper::smoothstep<float>(float, float, float);
+template double LUTHelper::smoothstep<double>(double, double, double);
+template CppLUT::LUTHalf LUTHelper::smoothstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+template void LUTHelper::remap<float>(const float *, float *, std::size_t, float, float, float, float);
+template void LUTHelper::remap<double>(const double *, double *, std::size_t, double, double, double, double);
+template void LUTHelper::remap<CppLUT::LUTHalf>(const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+template void LUTHelper::lerp1d<float>(float, float, const float *, float *, std::size_t);
+template void LUTHelper::lerp1d<double>(double, double, const double *, double *, std::size_t);
+template void LUTHelper::lerp1d<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
+template void LUTHelper::smoothstep<float>(float, float, const float *, float *, std::size_t);
+template void LUTHelper::smoothstep<double>(double, double, const double *, double *, std::size_t);
+template void LUTHelper::smoothstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
+template void LUTHelper::smootherstep<float>(float, float, const float *, float *, std::size_t);
+template void LUTHelper::smootherstep<double>(double, double, const double *, double *, std::size_t);
+template void LUTHelper::smootherstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
+
 std::vector<double> LUTHelper::indicesDoubleVector(double startValue, double endValue, int numIndices)
 {
 	std::vector<double> indices;
@@ -79,4 +228,419 @@ std::vector<int> LUTHelper::indicesIntegerVector(int startValue, int endValue, i
 		indices.push_back(std::round(i * ratio));
 	}
 	return indices;
-}
\ No newline at end of file
+}
+
+bool LUTHelper::parseNumber(const char * & cursor, const char * end, double & value)
+{
+	static const double powersOf10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char * c = cursor;
+	bool negative = false;
+	if (c < end && (*c == '-' || *c == '+'))
+	{
+		negative = (*c == '-');
+		c++;
+	}
+
+	// up to 19 significant digits fit in the mantissa, later ones only scale
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	for (; c < end && *c >= '0' && *c <= '9'; c++)
+	{
+		anyDigits = true;
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*c - '0');
+			significantDigits += (mantissa != 0);
+		}
+		else
+		{
+			exponent++;
+		}
+	}
+	if (c < end && *c == '.')
+	{
+		c++;
+		for (; c < end && *c >= '0' && *c <= '9'; c++)
+		{
+			anyDigits = true;
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*c - '0');
+				significantDigits += (mantissa != 0);
+				exponent--;
+			}
+		}
+	}
+	if (!anyDigits)
+	{
+		return false;
+	}
+
+	if (c < end && (*c == 'e' || *c == 'E'))
+	{
+		const char * e = c + 1;
+		bool negativeExponent = false;
+		if (e < end && (*e == '-' || *e == '+'))
+		{
+			negativeExponent = (*e == '-');
+			e++;
+		}
+		if (e < end && *e >= '0' && *e <= '9')
+		{
+			int explicitExponent = 0;
+			for (; e < end && *e >= '0' && *e <= '9'; e++)
+			{
+				if (explicitExponent < 10000)
+				{
+					explicitExponent = explicitExponent * 10 + (*e - '0');
+				}
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			c = e;
+		}
+	}
+
+	double result = (double)mantissa;
+	if (exponent < 0 && exponent >= -22)
+	{
+		result /= powersOf10[-exponent];
+	}
+	else if (exponent > 0 && exponent <= 22)
+	{
+		result *= powersOf10[exponent];
+	}
+	else if (exponent != 0)
+	{
+		result *= std::pow(10.0, exponent);
+	}
+
+	value = negative ? -result : result;
+	cursor = c;
+	return true;
+}
+
+namespace
+{
+
+const std::uint64_t hashPrime1 = 0x9E3779B185EBCA87ULL;
+const std::uint64_t hashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const std::uint64_t hashPrime3 = 0x165667B19E3779F9ULL;
+
+inline std::uint64_t rotateLeft(std::uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+inline std::uint64_t hashRound(std::uint64_t accumulator, std::uint64_t input)
+{
+	return rotateLeft(accumulator + input * hashPrime2, 31) * hashPrime1;
+}
+
+inline std::uint64_t readWord(const unsigned char * bytes)
+{
+	std::uint64_t word;
+	std::memcpy(&word, bytes, sizeof(word));
+	return word;
+}
+
+}
+
+std::uint64_t LUTHelper::hashBytes(const void * data, std::size_t length, std::uint64_t seed)
+{
+	const unsigned char * bytes = static_cast<const unsigned char *>(data);
+	const unsigned char * end = bytes + length;
+	std::uint64_t lanes[4] = { seed + hashPrime1 + hashPrime2, seed + hashPrime2, seed, seed - hashPrime1 };
+	for (; end - bytes >= 32; bytes += 32)
+	{
+		lanes[0] = hashRound(lanes[0], readWord(bytes));
+		lanes[1] = hashRound(lanes[1], readWord(bytes + 8));
+		lanes[2] = hashRound(lanes[2], readWord(bytes + 16));
+		lanes[3] = hashRound(lanes[3], readWord(bytes + 24));
+	}
+	std::uint64_t hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+	hash += (std::uint64_t)length;
+	for (; end - bytes >= 8; bytes += 8)
+	{
+		hash = rotateLeft(hash ^ hashRound(0, readWord(bytes)), 27) * hashPrime1 + hashPrime3;
+	}
+	for (; bytes < end; bytes++)
+	{
+		hash = rotateLeft(hash ^ (*bytes * hashPrime3), 11) * hashPrime1;
+	}
+	hash ^= hash >> 33;
+	hash *= hashPrime2;
+	hash ^= hash >> 29;
+	hash *= hashPrime3;
+	return hash ^ (hash >> 32);
+}
+
+namespace
+{
+
+/**
+ * @brief      The block of tiles still owned by one thread of a concurrent loop
+ */
+struct TileBlock
+{
+	std::mutex mutex;
+	int begin;
+	int end;
+};
+
+/**
+ * @brief      A lazily grown set of worker threads shared by every concurrent
+ *             loop. One loop runs at a time; the calling thread is participant
+ *             0 and worker `i` is participant `i + 1`.
+ */
+class ConcurrentLoopPool
+{
+public:
+	static ConcurrentLoopPool & shared()
+	{
+		static ConcurrentLoopPool pool;
+		return pool;
+	}
+
+	void run(int tileCount, const std::function<void(int)> & body, unsigned threadCount)
+	{
+		std::lock_guard<std::mutex> runLock(runMutex);
+
+		while (blocks.size() < threadCount)
+		{
+			blocks.push_back(std::unique_ptr<TileBlock>(new TileBlock()));
+		}
+		for (unsigned i = 0; i < threadCount; i++)
+		{
+			blocks[i]->begin = (int)((long long)tileCount * i / threadCount);
+			blocks[i]->end = (int)((long long)tileCount * (i + 1) / threadCount);
+		}
+		currentBody = &body;
+		error = nullptr;
+		abandoned = false;
+
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			while (workers.size() + 1 < threadCount)
+			{
+				workers.push_back(std::thread(&ConcurrentLoopPool::workerMain, this,
+				                              (unsigned)workers.size(), generation));
+			}
+			participants = threadCount;
+			busyWorkers = participants - 1;
+			generation++;
+		}
+		wake.notify_all();
+
+		work(0);
+
+		{
+			std::unique_lock<std::mutex> lock(stateMutex);
+			done.wait(lock, [this] { return busyWorkers == 0; });
+		}
+		currentBody = nullptr;
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	/** @brief      Whether the current thread is running a tile */
+	static bool & insideLoop()
+	{
+		static thread_local bool inside = false;
+		return inside;
+	}
+
+private:
+	std::mutex runMutex;
+	std::mutex stateMutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<TileBlock>> blocks;
+	const std::function<void(int)> * currentBody = nullptr;
+	unsigned participants = 0;
+	unsigned busyWorkers = 0;
+	unsigned long long generation = 0;
+	bool stopping = false;
+	std::atomic<bool> abandoned;
+	std::mutex errorMutex;
+	std::exception_ptr error;
+
+	ConcurrentLoopPool(): abandoned(false) {}
+
+	~ConcurrentLoopPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(stateMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread & worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void workerMain(unsigned workerIndex, unsigned long long seenGeneration)
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(stateMutex);
+				wake.wait(lock, [&] { return stopping || generation != seenGeneration; });
+				if (stopping)
+				{
+					return;
+				}
+				seenGeneration = generation;
+				if (workerIndex + 1 >= participants)
+				{
+					continue;
+				}
+			}
+
+			work(workerIndex + 1);
+
+			{
+				std::lock_guard<std::mutex> lock(stateMutex);
+				busyWorkers--;
+			}
+			done.notify_one();
+		}
+	}
+
+	void work(unsigned participant)
+	{
+		insideLoop() = true;
+		int tile;
+		while (!abandoned && takeTile(participant, tile))
+		{
+			try
+			{
+				(*currentBody)(tile);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error)
+				{
+					error = std::current_exception();
+				}
+				abandoned = true;
+			}
+		}
+		insideLoop() = false;
+	}
+
+	bool takeTile(unsigned participant, int & tile)
+	{
+		TileBlock & own = *blocks[participant];
+		{
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (own.begin < own.end)
+			{
+				tile = own.begin++;
+				return true;
+			}
+		}
+
+		// steal the back half of the largest remaining block
+		for (;;)
+		{
+			unsigned victim = participant;
+			int largest = 0;
+			for (unsigned i = 0; i < participants; i++)
+			{
+				if (i == participant)
+				{
+					continue;
+				}
+				std::lock_guard<std::mutex> lock(blocks[i]->mutex);
+				int remaining = blocks[i]->end - blocks[i]->begin;
+				if (remaining > largest)
+				{
+					largest = remaining;
+					victim = i;
+				}
+			}
+			if (victim == participant)
+			{
+				return false;
+			}
+
+			int stolenBegin, stolenEnd;
+			{
+				std::lock_guard<std::mutex> lock(blocks[victim]->mutex);
+				int remaining = blocks[victim]->end - blocks[victim]->begin;
+				if (remaining <= 0)
+				{
+					continue;
+				}
+				stolenEnd = blocks[victim]->end;
+				stolenBegin = stolenEnd - (remaining + 1) / 2;
+				blocks[victim]->end = stolenBegin;
+			}
+
+			std::lock_guard<std::mutex> lock(own.mutex);
+			own.begin = stolenBegin + 1;
+			own.end = stolenEnd;
+			tile = stolenBegin;
+			return true;
+		}
+	}
+};
+
+std::atomic<unsigned> & concurrencySetting()
+{
+	static std::atomic<unsigned> setting(0);
+	return setting;
+}
+
+}
+
+void LUTHelper::setConcurrency(unsigned threadCount)
+{
+	concurrencySetting() = threadCount;
+}
+
+unsigned LUTHelper::concurrency()
+{
+	unsigned threadCount = concurrencySetting();
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+	}
+	return (threadCount == 0) ? 1 : threadCount;
+}
+
+void LUTHelper::concurrentTileLoop(int tileCount, const std::function<void(int tile)> & body, unsigned threadCount)
+{
+	if (tileCount <= 0)
+	{
+		return;
+	}
+	if (threadCount == 0)
+	{
+		threadCount = concurrency();
+	}
+	if (threadCount > (unsigned)tileCount)
+	{
+		threadCount = tileCount;
+	}
+	if (threadCount <= 1 || ConcurrentLoopPool::insideLoop())
+	{
+		for (int tile = 0; tile < tileCount; tile++)
+		{
+			body(tile);
+		}
+		return;
+	}
+	ConcurrentLoopPool::shared().run(tileCount, body, threadCount);
+}
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "CppLUT.h"
+#include "LUTHalf.h"
 #include <vector> // std::vector
 #include <cmath> // std::sqrt std::pow 
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <functional> // std::function
 
+namespace CppLUT
+{
 class LUT;
-class LUT1D;
-class LUT3D;
+template <typename T> class BasicLUT1D;
+template <typename T> class BasicLUT3D;
+}
 
 // typedef NS_ENUM(NSInteger, LUT1DExtractionMethod); uh, yeah, wft?
 typedef int LUT1DExtractionMethod;
@@ -16,6 +23,20 @@ typedef int LUT1DExtractionMethod;
  */
 namespace LUTHelper
 {
+	/**
+	 * @brief      Keeps a parameter out of template argument deduction so that
+	 *             helpers default to `double` unless a value type is named,
+	 *             e.g. `LUTHelper::clamp<float>(value, 0, 1)`.
+	 */
+	template <typename T>
+	struct Identity
+	{
+		typedef T type;
+	};
+
+	template <typename T>
+	using NonDeduced = typename Identity<T>::type;
+
 	/**
 	 * @brief      Remaps a value to a new contrast range
 	 *
@@ -27,9 +48,10 @@ namespace LUTHelper
 	 *
 	 * @return     a double value in the new contrast range
 	 */
-	inline double contrastStretch(double value,
-	                              double currentMin, double currentMax,
-	                              double finalMin, double finalMax)
+	template <typename T = double>
+	inline T contrastStretch(NonDeduced<T> value,
+	                         NonDeduced<T> currentMin, NonDeduced<T> currentMax,
+	                         NonDeduced<T> finalMin, NonDeduced<T> finalMax)
 	{
 		return (value - currentMin)*((finalMax-finalMin)/(currentMax-currentMin)) + finalMin;
 	}
@@ -43,7 +65,8 @@ namespace LUTHelper
 	 *
 	 * @return     A double value in the given range
 	 */
-	inline double clamp(double value, double min, double max)
+	template <typename T = double>
+	inline T clamp(NonDeduced<T> value, NonDeduced<T> min, NonDeduced<T> max)
 	{
 		return (value > max) ? max : ((value < min) ? min : value);
 	}
@@ -55,7 +78,8 @@ namespace LUTHelper
 	 *
 	 * @return     A double in the range 0-1 inclusive
 	 */
-	inline double clamp01(double value) { return clamp(value, 0, 1); }
+	template <typename T = double>
+	inline T clamp01(NonDeduced<T> value) { return clamp<T>(value, 0, 1); }
 
 	/**
 	 * @brief      Clamps a value to the specified lower bound
@@ -65,7 +89,8 @@ namespace LUTHelper
 	 *
 	 * @return     { A clamped double value }
 	 */
-	inline double clampLowerBound(double value, double lowerBound)
+	template <typename T = double>
+	inline T clampLowerBound(NonDeduced<T> value, NonDeduced<T> lowerBound)
 	{
 		return (value < lowerBound) ? lowerBound : value;
 	}
@@ -78,9 +103,10 @@ namespace LUTHelper
 	 *
 	 * @return     { A clamped double value }
 	 */
-	inline double clampUpperBound(double value, double upperBound)
+	template <typename T = double>
+	inline T clampUpperBound(NonDeduced<T> value, NonDeduced<T> upperBound)
 	{
-		return (value < upperBound) ? upperBound : value;
+		return (value > upperBound) ? upperBound : value;
 	}
 
 	/**
@@ -91,7 +117,8 @@ namespace LUTHelper
 	 *
 	 * @return     A floating point value in the range 0 to 1 inclusive
 	 */
-	inline double remapInt01(int value, int maxValue) { return (double)value / maxValue; }
+	template <typename T = double>
+	inline T remapInt01(int value, int maxValue) { return (T)value / maxValue; }
 
 	/**
 	 * @brief      Remap a value from a given input range to a given output
@@ -109,8 +136,9 @@ namespace LUTHelper
 	 *
 	 * @return     A remapped value in the new output range
 	 */
-	double remap(double value, double inputLow, double inputHigh,
-		                double outputLow, double outputHigh);
+	template <typename T = double>
+	T remap(NonDeduced<T> value, NonDeduced<T> inputLow, NonDeduced<T> inputHigh,
+	        NonDeduced<T> outputLow, NonDeduced<T> outputHigh);
 
 	/**
 	 * @brief      Remap a value from a given input range to a given output
@@ -124,8 +152,9 @@ namespace LUTHelper
 	 *
 	 * @return     A remapped value in the new output range
 	 */
-	inline double remapNoError(double value, double inputLow, double inputHigh,
-		                       double outputLow, double outputHigh)
+	template <typename T = double>
+	constexpr T remapNoError(NonDeduced<T> value, NonDeduced<T> inputLow, NonDeduced<T> inputHigh,
+	                         NonDeduced<T> outputLow, NonDeduced<T> outputHigh) noexcept
 	{
 		return outputLow + ((value - inputLow) * (outputHigh - outputLow)) / (inputHigh - inputLow);
 	}
@@ -140,7 +169,8 @@ namespace LUTHelper
 	 *
 	 * @return     True if the value falls out of the range
 	 */
-	inline bool outOfBounds(double value, double min, double max, bool inclusive)
+	template <typename T = double>
+	inline bool outOfBounds(NonDeduced<T> value, NonDeduced<T> min, NonDeduced<T> max, bool inclusive)
 	{
 		return (inclusive ? (value < min || value > max) : (value <= min || value >= max));
 	}
@@ -155,7 +185,24 @@ namespace LUTHelper
 	 *
 	 * @return     An interpolated floating point value
 	 */
-	double lerp1d(double beginning, double end, double value01);
+	template <typename T = double>
+	T lerp1d(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> value01);
+
+	/**
+	 * @brief      Applies a linear interpolation without checking the range
+	 *             of `value01`, so that it can be inlined and vectorized
+	 *
+	 * @param[in]  beginning  The beginning point of the range (0)
+	 * @param[in]  end        The end point of the range (1)
+	 * @param[in]  value01    The value to interpolate, normally in the range 0-1
+	 *
+	 * @return     An interpolated floating point value
+	 */
+	template <typename T = double>
+	constexpr T lerp1dNoError(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> value01) noexcept
+	{
+		return beginning + (end - beginning) * value01;
+	}
 
 	/**
 	 * @brief      Applies smootherstep interpolation for a point at a specified
@@ -169,7 +216,30 @@ namespace LUTHelper
 	 *
 	 * @return     An intepolated floating point value
 	 */
-	double smootherstep(double beginning, double end, double percentage);
+	template <typename T = double>
+	T smootherstep(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage);
+
+	template <typename T = double>
+	constexpr T smootherstepPolynomial(NonDeduced<T> x) noexcept
+	{
+		return x*x*x*(x*(x*(T)6 - (T)15) + (T)10);
+	}
+
+	/**
+	 * @brief      Applies smootherstep interpolation without checking the
+	 *             range of `percentage`
+	 *
+	 * @param[in]  beginning   The beginning of the range
+	 * @param[in]  end         The end of the range
+	 * @param[in]  percentage  The percentage position of the point in the range
+	 *
+	 * @return     An intepolated floating point value
+	 */
+	template <typename T = double>
+	constexpr T smootherstepNoError(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage) noexcept
+	{
+		return smootherstepPolynomial<T>(remapNoError<T>(percentage, 0, 1, beginning, end));
+	}
 
 	/**
 	 * @brief      Applies smoothstep interpolation for a point at a specified
@@ -183,7 +253,82 @@ namespace LUTHelper
 	 *
 	 * @return     An intepolated floating point value
 	 */
-	double smoothstep(double beginning, double end, double percentage);
+	template <typename T = double>
+	T smoothstep(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage);
+
+	template <typename T = double>
+	constexpr T smoothstepPolynomial(NonDeduced<T> x) noexcept
+	{
+		return x*x*((T)3 - (T)2*x);
+	}
+
+	/**
+	 * @brief      Applies smoothstep interpolation without checking the range
+	 *             of `percentage`
+	 *
+	 * @param[in]  beginning   The beginning of the range
+	 * @param[in]  end         The end of the range
+	 * @param[in]  percentage  The percentage position of the point in the range
+	 *
+	 * @return     An intepolated floating point value
+	 */
+	template <typename T = double>
+	constexpr T smoothstepNoError(NonDeduced<T> beginning, NonDeduced<T> end, NonDeduced<T> percentage) noexcept
+	{
+		return smoothstepPolynomial<T>(remapNoError<T>(percentage, 0, 1, beginning, end));
+	}
+
+	/**
+	 * @brief      Remaps every value of an array from a given input range to a
+	 *             given output range
+	 * @discussion All values and both ranges are validated before anything is
+	 *             written, then the values are converted by a branch-free loop.
+	 *             `output` may equal `input`. Like the other interpolation
+	 *             helpers it is instantiated for float, double and `LUTHalf`;
+	 *             halves are checked and computed in single precision.
+	 *
+	 * @throws     std::domain_error  If any value does not fall in the input range
+	 * @throws     std::domain_error  If inputLow is greater than inputHigh
+	 * @throws     std::domain_error  If outputLow is greater than outputHigh
+	 *
+	 * @param[in]  input       The values to remap
+	 * @param[out] output      The remapped values
+	 * @param[in]  count       The number of values
+	 * @param[in]  inputLow    The input range lower bound
+	 * @param[in]  inputHigh   The input range higher bound
+	 * @param[in]  outputLow   The output range lower bound
+	 * @param[in]  outputHigh  The output range higher bound
+	 */
+	template <typename T>
+	void remap(const T * input, T * output, std::size_t count,
+	           NonDeduced<T> inputLow, NonDeduced<T> inputHigh, NonDeduced<T> outputLow, NonDeduced<T> outputHigh);
+
+	/**
+	 * @brief      Applies a linear interpolation to every value of an array,
+	 *             validating them all before anything is written
+	 *
+	 * @throws     std::domain_error  If any value is not in the range 0-1
+	 */
+	template <typename T>
+	void lerp1d(NonDeduced<T> beginning, NonDeduced<T> end, const T * values01, T * output, std::size_t count);
+
+	/**
+	 * @brief      Applies smoothstep interpolation to every value of an array,
+	 *             validating them all before anything is written
+	 *
+	 * @throws     std::domain_error  If any percentage is not in the range 0-1
+	 */
+	template <typename T>
+	void smoothstep(NonDeduced<T> beginning, NonDeduced<T> end, const T * percentages, T * output, std::size_t count);
+
+	/**
+	 * @brief      Applies smootherstep interpolation to every value of an
+	 *             array, validating them all before anything is written
+	 *
+	 * @throws     std::domain_error  If any percentage is not in the range 0-1
+	 */
+	template <typename T>
+	void smootherstep(NonDeduced<T> beginning, NonDeduced<T> end, const T * percentages, T * output, std::size_t count);
 
 	/**
 	 * @brief      Determines the distance between two XYZ points
@@ -197,12 +342,14 @@ namespace LUTHelper
 	 *
 	 * @return     { The length of the vector between the two points }
 	 */
-	inline float distancecalc(float x1, float y1, float z1, float x2, float y2, float z2)
+	template <typename T = float>
+	inline T distancecalc(NonDeduced<T> x1, NonDeduced<T> y1, NonDeduced<T> z1,
+	                      NonDeduced<T> x2, NonDeduced<T> y2, NonDeduced<T> z2)
 	{
-		float dx = x2 - x1;
-		float dy = y2 - y1;
-		float dz = z2 - z1;
-		return std::sqrt((float)(dx * dx + dy * dy + dz * dz));
+		T dx = x2 - x1;
+		T dy = y2 - y1;
+		T dz = z2 - z1;
+		return std::sqrt((T)(dx * dx + dy * dy + dz * dz));
 	}
 
 	/**
@@ -226,7 +373,8 @@ namespace LUTHelper
 	 *
 	 * @return     { description_of_the_return_value }
 	 */
-	inline double roundValueToNearest(double value, double nearestValue)
+	template <typename T = double>
+	inline T roundValueToNearest(NonDeduced<T> value, NonDeduced<T> nearestValue)
 	{
 		int multiplier = std::floor(value / nearestValue);
 		return multiplier* nearestValue;
@@ -241,14 +389,91 @@ namespace LUTHelper
 	 */
 	inline int maxIntegerFromBitdepth(int bitdepth) { return std::pow(2, bitdepth) - 1; }
 
+	/**
+	 * @brief      Sets the number of threads used by the concurrent loops when
+	 *             a call does not ask for a specific count
+	 *
+	 * @param[in]  threadCount  The number of threads, including the calling
+	 *                          thread. 0 uses one per hardware thread.
+	 */
+	void setConcurrency(unsigned threadCount);
+
+	/**
+	 * @brief      The number of threads used by the concurrent loops by default
+	 *
+	 * @return     The thread count, at least 1
+	 */
+	unsigned concurrency();
+
+	/**
+	 * @brief      Runs `body` once for every tile index in [0, tileCount) on a
+	 *             shared pool of worker threads.
+	 * @discussion Each thread starts on its own contiguous block of tiles and,
+	 *             once that is exhausted, steals the back half of the largest
+	 *             remaining block of another thread. The calling thread takes
+	 *             part and the call returns when every tile is done. If a tile
+	 *             throws, the remaining tiles are abandoned and the first
+	 *             exception is rethrown on the calling thread. Nested calls
+	 *             run serially on the thread that makes them.
+	 *
+	 * @param[in]  tileCount    The number of tiles
+	 * @param[in]  body         The function run for each tile index
+	 * @param[in]  threadCount  The number of threads to use, 0 for
+	 *                          `concurrency()`
+	 */
+	void concurrentTileLoop(int tileCount, const std::function<void(int tile)> & body, unsigned threadCount = 0);
+
+	/**
+	 * Runs the passed function over contiguous ranges of lattice indices
+	 * (`r + cubeSize * (g + cubeSize * b)`) that together cover a cube of edge
+	 * length `cubeSize`. Ranges are whole rows of red values, roughly
+	 * `CPPLUT_CONCURRENT_TILE_POINTS` long, so each one touches a contiguous
+	 * slice of every plane.
+	 *
+	 * @param[in]  cubeSize     The cube size
+	 * @param[in]  function     Called as `function(std::size_t begin, std::size_t end)`
+	 * @param[in]  threadCount  The number of threads to use, 0 for `concurrency()`
+	 */
+	template <typename Function>
+	inline void LUT3DConcurrentRangeLoop(int cubeSize, Function function, unsigned threadCount = 0)
+	{
+		const int rows = cubeSize * cubeSize;
+		const int rowsPerTile = (cubeSize >= CPPLUT_CONCURRENT_TILE_POINTS) ? 1 : CPPLUT_CONCURRENT_TILE_POINTS / cubeSize;
+		const int tileCount = (rows + rowsPerTile - 1) / rowsPerTile;
+		concurrentTileLoop(tileCount, [&](int tile)
+		{
+			int rowBegin = tile * rowsPerTile;
+			int rowEnd = (rowBegin + rowsPerTile < rows) ? rowBegin + rowsPerTile : rows;
+			function((std::size_t)rowBegin * cubeSize, (std::size_t)rowEnd * cubeSize);
+		}, threadCount);
+	}
+
 	/**
 	 * Runs the passed function cubeSize ^ 3 times, iterating over each point on a
-	 * cube of edge length `cubeSize`.
+	 * cube of edge length `cubeSize`. Points are visited in tiles of whole red
+	 * rows spread over `threadCount` threads, so `function` must be safe to
+	 * call concurrently for different points.
 	 *
-	 * @param[in]  cubeSize  The cube size
-	 * @param[in]  funcp     A pointer to the function to be run 
+	 * @param[in]  cubeSize     The cube size
+	 * @param[in]  function     Any callable invoked as `function(int r, int g, int b)`
+	 * @param[in]  threadCount  The number of threads to use, 0 for `concurrency()`
 	 */
-	//	inline void LUT3DConcurrentLoop(int cubeSize, void (*funcp)(int r, int g, int b));
+	template <typename Function>
+	inline void LUT3DConcurrentLoop(int cubeSize, Function function, unsigned threadCount = 0)
+	{
+		LUT3DConcurrentRangeLoop(cubeSize, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t row = begin / cubeSize; row < end / cubeSize; row++)
+			{
+				const int g = (int)(row % cubeSize);
+				const int b = (int)(row / cubeSize);
+				for (int r = 0; r < cubeSize; r++)
+				{
+					function(r, g, b);
+				}
+			}
+		}, threadCount);
+	}
 
 
 	/**
@@ -259,20 +484,83 @@ namespace LUTHelper
 	 */
 	//	inline void LUT1DLoop(int size, void (*funcp)(int index));
 
-	// inline void LUTConcurrentRectLoop(int width, int height, void (*funcp)(int x, int y));
+	/**
+	 * Runs the passed function over bands of whole rows that together cover
+	 * a `width` by `height` rectangle. Each band holds roughly
+	 * `CPPLUT_CONCURRENT_TILE_POINTS` pixels and at least one row, and bands
+	 * are spread over `threadCount` threads.
+	 *
+	 * @param[in]  width        The width of the rectangle
+	 * @param[in]  height       The height of the rectangle
+	 * @param[in]  function     Called as `function(int rowBegin, int rowEnd)`
+	 * @param[in]  threadCount  The number of threads to use, 0 for `concurrency()`
+	 */
+	template <typename Function>
+	inline void LUTConcurrentRectLoop(int width, int height, Function function, unsigned threadCount = 0)
+	{
+		const int rowsPerTile = (width >= CPPLUT_CONCURRENT_TILE_POINTS || width <= 0) ? 1 : CPPLUT_CONCURRENT_TILE_POINTS / width;
+		const int tileCount = (height + rowsPerTile - 1) / rowsPerTile;
+		concurrentTileLoop(tileCount, [&](int tile)
+		{
+			int rowBegin = tile * rowsPerTile;
+			int rowEnd = (rowBegin + rowsPerTile < height) ? rowBegin + rowsPerTile : height;
+			function(rowBegin, rowEnd);
+		}, threadCount);
+	}
 
-	// NSArray* arrayWithEmptyElementsRemoved(NSArray *array);
-	// NSArray* arrayWithComponentsSeperatedByWhitespaceWithEmptyElementsRemoved(NSString *string);
-	// NSArray* arrayWithComponentsSeperatedByNewlineWithEmptyElementsRemoved(NSString *string);
-	// NSArray* arrayWithComponentsSeperatedByNewlineAndWhitespaceWithEmptyElementsRemoved(NSString *string);
-	// NSString* substringBetweenTwoStrings(NSString *originString, NSString *firstString, NSString *secondString);
+	/**
+	 * @brief      Parses a decimal floating point number in place, without
+	 *             allocating or consulting the locale. Accepts an optional
+	 *             sign, digits with an optional fraction and an optional
+	 *             exponent, e.g. `-1.5e-3`.
+	 *
+	 * @param      cursor  The first character of the number. On success it is
+	 *                     moved past the number, otherwise it is unchanged.
+	 * @param[in]  end     One past the last readable character
+	 * @param[out] value   The parsed value
+	 *
+	 * @return     True if a number was parsed
+	 */
+	bool parseNumber(const char * & cursor, const char * end, double & value);
 
-	// NSInteger findFirstLUTLineInLines(NSArray *lines, NSString *seperator, int numValues, int startLine);
-	// NSInteger findFirstLUTLineInLinesWithWhitespaceSeparators(NSArray *lines, int numValues, int startLine);
+	/**
+	 * @brief      A fast 64-bit content hash of a block of memory. It reads
+	 *             eight bytes at a time into four independent lanes, so it
+	 *             runs close to memory bandwidth. Not suitable for security.
+	 *
+	 * @param[in]  data    The first byte
+	 * @param[in]  length  The number of bytes
+	 * @param[in]  seed    A value mixed into the hash, e.g. the hash of a
+	 *                     preceding block
+	 *
+	 * @return     The hash
+	 */
+	std::uint64_t hashBytes(const void * data, std::size_t length, std::uint64_t seed = 0);
 
-	// NSNumberFormatter* sharedNumberFormatter();
-	// NSCharacterSet* sharedInvertedNumericCharacterSet();
-	// bool stringIsValidNumber(NSString *string);
+	extern template float remap<float>(float, float, float, float, float);
+	extern template double remap<double>(double, double, double, double, double);
+	extern template CppLUT::LUTHalf remap<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+	extern template float lerp1d<float>(float, float, float);
+	extern template double lerp1d<double>(double, double, double);
+	extern template CppLUT::LUTHalf lerp1d<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+	extern template float smootherstep<float>(float, float, float);
+	extern template double smootherstep<double>(double, double, double);
+	extern template CppLUT::LUTHalf smootherstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+	extern template float smoothstep<float>(float, float, float);
+	extern template double smoothstep<double>(double, double, double);
+	extern template CppLUT::LUTHalf smoothstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+	extern template void remap<float>(const float *, float *, std::size_t, float, float, float, float);
+	extern template void remap<double>(const double *, double *, std::size_t, double, double, double, double);
+	extern template void remap<CppLUT::LUTHalf>(const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf, CppLUT::LUTHalf);
+	extern template void lerp1d<float>(float, float, const float *, float *, std::size_t);
+	extern template void lerp1d<double>(double, double, const double *, double *, std::size_t);
+	extern template void lerp1d<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
+	extern template void smoothstep<float>(float, float, const float *, float *, std::size_t);
+	extern template void smoothstep<double>(double, double, const double *, double *, std::size_t);
+	extern template void smoothstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
+	extern template void smootherstep<float>(float, float, const float *, float *, std::size_t);
+	extern template void smootherstep<double>(double, double, const double *, double *, std::size_t);
+	extern template void smootherstep<CppLUT::LUTHalf>(CppLUT::LUTHalf, CppLUT::LUTHalf, const CppLUT::LUTHalf *, CppLUT::LUTHalf *, std::size_t);
 };
 
 	// CGSize CGSizeProportionallyScaled(CGSize currentSize, CGSize targetSize);
@@ -0,0 +1,361 @@
+#include "LUTImage.h"
+#include "LUTHalf.h"
+#include "LUTHelper.h"
+
+#include <algorithm> // std::min
+#include <cstdint> // std::uint8_t std::uint16_t
+#include <cstring> // std::memcpy
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+/** @brief      The number of pixels widened into float at a time within a row */
+const int imageChunkPixels = 1024;
+
+/**
+ * @brief      Widens `count` samples of one channel into every third float of
+ *             `output`. Samples are read through memcpy as strided images need
+ *             not keep them aligned.
+ */
+template <typename S>
+void loadChannel(const unsigned char * source, std::ptrdiff_t pixelStride, int count, float scale, float * output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		S sample;
+		std::memcpy(&sample, source + i * pixelStride, sizeof(S));
+		output[i * 3] = (float)sample * scale;
+	}
+}
+
+template <>
+void loadChannel<LUTHalf>(const unsigned char * source, std::ptrdiff_t pixelStride, int count, float, float * output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		LUTHalf sample;
+		std::memcpy(&sample, source + i * pixelStride, sizeof(LUTHalf));
+		output[i * 3] = (float)sample;
+	}
+}
+
+template <>
+void loadChannel<float>(const unsigned char * source, std::ptrdiff_t pixelStride, int count, float, float * output)
+{
+	for (int i = 0; i < count; i++)
+	{
+		std::memcpy(&output[i * 3], source + i * pixelStride, sizeof(float));
+	}
+}
+
+/**
+ * @brief      Narrows every third float of `input` into `count` samples of one
+ *             channel. Integer samples are clamped to 0 to `maximum` and
+ *             rounded to the nearest code value.
+ */
+template <typename S>
+void storeChannel(const float * input, int count, float maximum, unsigned char * destination, std::ptrdiff_t pixelStride)
+{
+	for (int i = 0; i < count; i++)
+	{
+		float value = input[i * 3] * maximum;
+		value = value > 0.0f ? (value < maximum ? value : maximum) : 0.0f;
+		const S sample = (S)(value + 0.5f);
+		std::memcpy(destination + i * pixelStride, &sample, sizeof(S));
+	}
+}
+
+template <>
+void storeChannel<LUTHalf>(const float * input, int count, float, unsigned char * destination, std::ptrdiff_t pixelStride)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const LUTHalf sample(input[i * 3]);
+		std::memcpy(destination + i * pixelStride, &sample, sizeof(LUTHalf));
+	}
+}
+
+template <>
+void storeChannel<float>(const float * input, int count, float, unsigned char * destination, std::ptrdiff_t pixelStride)
+{
+	for (int i = 0; i < count; i++)
+	{
+		std::memcpy(destination + i * pixelStride, &input[i * 3], sizeof(float));
+	}
+}
+
+/**
+ * @brief      The code value that maps to 1 in an integer view, 1 otherwise
+ */
+float integerMaximum(const LUTImageView & view)
+{
+	if (view.getFormat() == LUTPixelFormat::Half || view.getFormat() == LUTPixelFormat::Float)
+	{
+		return 1.0f;
+	}
+	return (float)LUTHelper::maxIntegerFromBitdepth(view.getBitdepth());
+}
+
+void loadPixels(const LUTImageView & view, int row, int column, int count, float * output)
+{
+	const float scale = 1.0f / integerMaximum(view);
+	for (int c = 0; c < 3; c++)
+	{
+		const unsigned char * source = view.channelInRow(c, row) + column * view.getPixelStride();
+		switch (view.getFormat())
+		{
+		case LUTPixelFormat::UInt8:
+			loadChannel<std::uint8_t>(source, view.getPixelStride(), count, scale, output + c);
+			break;
+		case LUTPixelFormat::UInt16:
+			loadChannel<std::uint16_t>(source, view.getPixelStride(), count, scale, output + c);
+			break;
+		case LUTPixelFormat::Half:
+			loadChannel<LUTHalf>(source, view.getPixelStride(), count, scale, output + c);
+			break;
+		case LUTPixelFormat::Float:
+			loadChannel<float>(source, view.getPixelStride(), count, scale, output + c);
+			break;
+		}
+	}
+}
+
+void storePixels(const float * input, int count, const LUTImageView & view, int row, int column)
+{
+	const float maximum = integerMaximum(view);
+	for (int c = 0; c < 3; c++)
+	{
+		unsigned char * destination = view.channelInRow(c, row) + column * view.getPixelStride();
+		switch (view.getFormat())
+		{
+		case LUTPixelFormat::UInt8:
+			storeChannel<std::uint8_t>(input + c, count, maximum, destination, view.getPixelStride());
+			break;
+		case LUTPixelFormat::UInt16:
+			storeChannel<std::uint16_t>(input + c, count, maximum, destination, view.getPixelStride());
+			break;
+		case LUTPixelFormat::Half:
+			storeChannel<LUTHalf>(input + c, count, maximum, destination, view.getPixelStride());
+			break;
+		case LUTPixelFormat::Float:
+			storeChannel<float>(input + c, count, maximum, destination, view.getPixelStride());
+			break;
+		}
+	}
+}
+
+/**
+ * @brief      Whether a view holds interleaved float RGB that a span `apply`
+ *             can read or write directly, with red, green and blue adjacent
+ *             and each pixel a whole number of aligned floats apart.
+ */
+bool isInterleavedFloat(const LUTImageView & view)
+{
+	const unsigned char * red = view.channelInRow(0, 0);
+	return view.getFormat() == LUTPixelFormat::Float &&
+	       view.channelInRow(1, 0) == red + sizeof(float) &&
+	       view.channelInRow(2, 0) == red + 2 * sizeof(float) &&
+	       view.getPixelStride() >= (std::ptrdiff_t)(3 * sizeof(float)) &&
+	       view.getPixelStride() % sizeof(float) == 0 &&
+	       view.getRowStride() % sizeof(float) == 0 &&
+	       reinterpret_cast<std::uintptr_t>(red) % alignof(float) == 0;
+}
+
+/**
+ * @brief      Runs a span kernel, called as
+ *             `kernel(const float * input, float * output, std::size_t pixelCount, std::size_t pixelStride)`,
+ *             over every pixel of `source` and writes the result to
+ *             `destination`.
+ */
+template <typename Kernel>
+void applyToImage(const LUTImageView & source, const LUTImageView & destination, Kernel kernel)
+{
+	if (source.getWidth() != destination.getWidth() || source.getHeight() != destination.getHeight())
+	{
+		throw std::domain_error("Invalid Image: the source is " + std::to_string(source.getWidth()) + "x" +
+		                        std::to_string(source.getHeight()) + " but the destination is " +
+		                        std::to_string(destination.getWidth()) + "x" +
+		                        std::to_string(destination.getHeight()));
+	}
+	const int width = source.getWidth();
+
+	if (isInterleavedFloat(source) && isInterleavedFloat(destination) &&
+	    source.getPixelStride() == destination.getPixelStride())
+	{
+		const std::size_t pixelStride = source.getPixelStride() / sizeof(float);
+		LUTHelper::LUTConcurrentRectLoop(width, source.getHeight(), [&](int rowBegin, int rowEnd)
+		{
+			for (int row = rowBegin; row < rowEnd; row++)
+			{
+				kernel(reinterpret_cast<const float *>(source.channelInRow(0, row)),
+				       reinterpret_cast<float *>(destination.channelInRow(0, row)), (std::size_t)width, pixelStride);
+			}
+		});
+		return;
+	}
+
+	LUTHelper::LUTConcurrentRectLoop(width, source.getHeight(), [&](int rowBegin, int rowEnd)
+	{
+		std::vector<float> buffer(3 * std::min(width, imageChunkPixels));
+		for (int row = rowBegin; row < rowEnd; row++)
+		{
+			for (int column = 0; column < width; column += imageChunkPixels)
+			{
+				const int count = std::min(imageChunkPixels, width - column);
+				loadPixels(source, row, column, count, buffer.data());
+				kernel(buffer.data(), buffer.data(), (std::size_t)count, (std::size_t)3);
+				storePixels(buffer.data(), count, destination, row, column);
+			}
+		}
+	});
+}
+
+void checkDimensions(int width, int height)
+{
+	if (width < 0 || height < 0)
+	{
+		throw std::domain_error("Invalid Image: dimensions " + std::to_string(width) + "x" +
+		                        std::to_string(height) + " are negative");
+	}
+}
+
+}
+
+LUTImageView::LUTImageView(LUTPixelFormat format, int width, int height, void * red, void * green, void * blue,
+                           std::ptrdiff_t pixelStride, std::ptrdiff_t rowStride):
+	format(format), width(width), height(height), pixelStride(pixelStride), rowStride(rowStride),
+	bitdepth((int)(8 * bytesPerSample(format)))
+{
+	checkDimensions(width, height);
+	if (red == nullptr || green == nullptr || blue == nullptr)
+	{
+		throw std::domain_error("Invalid Image: a channel has no data");
+	}
+	channels[0] = static_cast<unsigned char *>(red);
+	channels[1] = static_cast<unsigned char *>(green);
+	channels[2] = static_cast<unsigned char *>(blue);
+}
+
+LUTImageView LUTImageView::interleaved(void * data, int width, int height, LUTPixelFormat format,
+                                       int channelCount, std::ptrdiff_t rowStride)
+{
+	if (channelCount < 3)
+	{
+		throw std::domain_error("Invalid Image: " + std::to_string(channelCount) +
+		                        " channels is too few for RGB");
+	}
+	checkDimensions(width, height);
+	const std::ptrdiff_t pixelStride = channelCount * bytesPerSample(format);
+	if (rowStride == 0)
+	{
+		rowStride = width * pixelStride;
+	}
+	unsigned char * bytes = static_cast<unsigned char *>(data);
+	const std::size_t sample = bytesPerSample(format);
+	return LUTImageView(format, width, height, bytes, bytes == nullptr ? nullptr : bytes + sample,
+	                    bytes == nullptr ? nullptr : bytes + 2 * sample, pixelStride, rowStride);
+}
+
+LUTImageView LUTImageView::planar(void * red, void * green, void * blue, int width, int height,
+                                  LUTPixelFormat format, std::ptrdiff_t rowStride)
+{
+	checkDimensions(width, height);
+	const std::ptrdiff_t pixelStride = bytesPerSample(format);
+	if (rowStride == 0)
+	{
+		rowStride = width * pixelStride;
+	}
+	return LUTImageView(format, width, height, red, green, blue, pixelStride, rowStride);
+}
+
+LUTImageView LUTImageView::strided(void * red, void * green, void * blue, int width, int height,
+                                   LUTPixelFormat format, std::ptrdiff_t pixelStride, std::ptrdiff_t rowStride)
+{
+	return LUTImageView(format, width, height, red, green, blue, pixelStride, rowStride);
+}
+
+LUTImageView LUTImageView::withBitdepth(int bitdepth) const
+{
+	LUTImageView view = *this;
+	if (format == LUTPixelFormat::UInt8 || format == LUTPixelFormat::UInt16)
+	{
+		const int sampleBits = (int)(8 * bytesPerSample(format));
+		if (bitdepth < 1 || bitdepth > sampleBits)
+		{
+			throw std::domain_error("Invalid Bitdepth: " + std::to_string(bitdepth) + " does not fit in a " +
+			                        std::to_string(sampleBits) + " bit sample");
+		}
+		view.bitdepth = bitdepth;
+	}
+	return view;
+}
+
+std::size_t LUTImageView::bytesPerSample(LUTPixelFormat format)
+{
+	switch (format)
+	{
+	case LUTPixelFormat::UInt8:
+		return 1;
+	case LUTPixelFormat::UInt16:
+	case LUTPixelFormat::Half:
+		return 2;
+	case LUTPixelFormat::Float:
+		return 4;
+	}
+	return 0;
+}
+
+template <typename T>
+void LUTImage::apply(const BasicLUT1D<T> & lut, const LUTImageView & source, const LUTImageView & destination)
+{
+	applyToImage(source, destination, [&lut](const float * input, float * output, std::size_t count, std::size_t stride)
+	{
+		lut.apply(input, output, count, stride);
+	});
+}
+
+template <typename T>
+void LUTImage::apply(const BasicLUT3D<T> & lut, const LUTImageView & source, const LUTImageView & destination,
+                     LUT3DInterpolation interpolation)
+{
+	applyToImage(source, destination, [&lut, interpolation](const float * input, float * output, std::size_t count, std::size_t stride)
+	{
+		lut.apply(input, output, count, interpolation, stride);
+	});
+}
+
+template <typename T>
+void LUTImage::apply(const BasicLUTShaper3D<T> & lut, const LUTImageView & source, const LUTImageView & destination,
+                     LUT3DInterpolation interpolation)
+{
+	applyToImage(source, destination, [&lut, interpolation](const float * input, float * output, std::size_t count, std::size_t stride)
+	{
+		lut.apply(input, output, count, interpolation, stride);
+	});
+}
+
+void LUTImage::apply(const LUTBakeChain & chain, const LUTImageView & source, const LUTImageView & destination)
+{
+	applyToImage(source, destination, [&chain](const float * input, float * output, std::size_t count, std::size_t stride)
+	{
+		chain.apply(input, output, count, stride);
+	});
+}
+
+namespace CppLUT
+{
+template void LUTImage::apply<float>(const LUT1Df &, const LUTImageView &, const LUTImageView &);
+template void LUTImage::apply<double>(const LUT1D &, const LUTImageView &, const LUTImageView &);
+template void LUTImage::apply<LUTHalf>(const LUT1Dh &, const LUTImageView &, const LUTImageView &);
+template void LUTImage::apply<float>(const LUT3Df &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+template void LUTImage::apply<double>(const LUT3D &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+template void LUTImage::apply<LUTHalf>(const LUT3Dh &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+template void LUTImage::apply<float>(const LUTShaper3Df &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+template void LUTImage::apply<double>(const LUTShaper3D &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+template void LUTImage::apply<LUTHalf>(const LUTShaper3Dh &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+#include "LUTBakeChain.h"
+#include "LUTShaper3D.h"
+
+#include <cstddef> // std::size_t std::ptrdiff_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      The storage type of each channel sample in an image
+ */
+enum class LUTPixelFormat
+{
+	/** @brief      Unsigned 8 bit integers, 0 to 2^bitdepth - 1 mapping to 0 to 1 */
+	UInt8,
+	/** @brief      Unsigned 16 bit integers, 0 to 2^bitdepth - 1 mapping to 0 to 1 */
+	UInt16,
+	/** @brief      IEEE 754 binary16 values, read and written through `LUTHalf` */
+	Half,
+	/** @brief      IEEE 754 binary32 values */
+	Float
+};
+
+/**
+ * @brief      A view of the red, green and blue channels of an image in
+ *             memory the caller owns.
+ * @discussion Each channel is described by the address of its first sample,
+ *             and every channel shares the same byte distance from one pixel
+ *             to the next and from one row to the next. That covers
+ *             interleaved RGB and RGBA, fully planar buffers and padded or
+ *             bottom-up rows. Any alpha or other channels between the RGB
+ *             samples are never read or written.
+ */
+class LUTImageView
+{
+	/** @brief      The storage type of the samples */
+	LUTPixelFormat format;
+
+	int width;
+	int height;
+
+	/** @brief      The first red, green and blue sample */
+	unsigned char * channels[3];
+
+	/** @brief      The number of bytes from one pixel to the next in a row */
+	std::ptrdiff_t pixelStride;
+
+	/** @brief      The number of bytes from one row to the next, negative for bottom-up rows */
+	std::ptrdiff_t rowStride;
+
+	/** @brief      The number of significant bits in integer samples */
+	int bitdepth;
+
+	/**
+	 * @brief      Private constructor for a LUTImageView
+	 */
+	LUTImageView(LUTPixelFormat format, int width, int height, void * red, void * green, void * blue,
+	             std::ptrdiff_t pixelStride, std::ptrdiff_t rowStride);
+
+public:
+	/**
+	 * @brief      A view of an interleaved image, with red, green and blue
+	 *             as the first three channels of each pixel
+	 *
+	 * @throws     std::domain_error  If data is null, the dimensions are
+	 *                                negative or channelCount is less than 3
+	 *
+	 * @param[in]  data          The first sample of the first row
+	 * @param[in]  width         The width of the image in pixels
+	 * @param[in]  height        The height of the image in pixels
+	 * @param[in]  format        The storage type of the samples
+	 * @param[in]  channelCount  The number of samples per pixel, 3 for RGB and
+	 *                           4 for RGBA
+	 * @param[in]  rowStride     The number of bytes from one row to the next,
+	 *                           0 for tightly packed rows
+	 *
+	 * @return     The view
+	 */
+	static LUTImageView interleaved(void * data, int width, int height, LUTPixelFormat format,
+	                                int channelCount = 3, std::ptrdiff_t rowStride = 0);
+
+	/**
+	 * @brief      A view of an image with each channel in its own plane
+	 *
+	 * @throws     std::domain_error  If a plane is null or the dimensions are
+	 *                                negative
+	 *
+	 * @param[in]  red        The first red sample
+	 * @param[in]  green      The first green sample
+	 * @param[in]  blue       The first blue sample
+	 * @param[in]  width      The width of the image in pixels
+	 * @param[in]  height     The height of the image in pixels
+	 * @param[in]  format     The storage type of the samples
+	 * @param[in]  rowStride  The number of bytes from one row to the next
+	 *                        within a plane, 0 for tightly packed rows
+	 *
+	 * @return     The view
+	 */
+	static LUTImageView planar(void * red, void * green, void * blue, int width, int height,
+	                           LUTPixelFormat format, std::ptrdiff_t rowStride = 0);
+
+	/**
+	 * @brief      A view of an image with arbitrary byte strides between
+	 *             pixels and rows
+	 *
+	 * @throws     std::domain_error  If a channel is null or the dimensions are
+	 *                                negative
+	 *
+	 * @param[in]  red          The first red sample
+	 * @param[in]  green        The first green sample
+	 * @param[in]  blue         The first blue sample
+	 * @param[in]  width        The width of the image in pixels
+	 * @param[in]  height       The height of the image in pixels
+	 * @param[in]  format       The storage type of the samples
+	 * @param[in]  pixelStride  The number of bytes from one pixel to the next
+	 * @param[in]  rowStride    The number of bytes from one row to the next
+	 *
+	 * @return     The view
+	 */
+	static LUTImageView strided(void * red, void * green, void * blue, int width, int height,
+	                            LUTPixelFormat format, std::ptrdiff_t pixelStride, std::ptrdiff_t rowStride);
+
+	/**
+	 * @brief      A copy of this view whose integer samples hold `bitdepth`
+	 *             significant bits, e.g. 10 bit code values in 16 bit words.
+	 *             Has no effect on half and float views.
+	 *
+	 * @throws     std::domain_error  If bitdepth is not in the range 1 to the
+	 *                                width of the integer sample
+	 *
+	 * @param[in]  bitdepth  The number of significant bits
+	 *
+	 * @return     The view
+	 */
+	LUTImageView withBitdepth(int bitdepth) const;
+
+	LUTPixelFormat getFormat() const { return format; }
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+	std::ptrdiff_t getPixelStride() const { return pixelStride; }
+	std::ptrdiff_t getRowStride() const { return rowStride; }
+	int getBitdepth() const { return bitdepth; }
+
+	/**
+	 * @brief      The address of a channel's sample in the first pixel of a row
+	 *
+	 * @param[in]  channel  0 for red, 1 for green and 2 for blue
+	 * @param[in]  row      The row
+	 */
+	unsigned char * channelInRow(int channel, int row) const { return channels[channel] + row * rowStride; }
+
+	/**
+	 * @brief      The number of bytes in one sample of a format
+	 */
+	static std::size_t bytesPerSample(LUTPixelFormat format);
+};
+
+/**
+ * @brief      Applies LUTs directly to images described by `LUTImageView`.
+ * @discussion Rows are split into bands of roughly
+ *             `CPPLUT_CONCURRENT_TILE_POINTS` pixels that run on
+ *             `LUTHelper::concurrency()` threads. Within a band, runs of
+ *             pixels are widened into a small interleaved float buffer, passed
+ *             through the LUT's span `apply`, and narrowed into the
+ *             destination; integer output is clamped to 0 to 1 and rounded.
+ *             Interleaved float images skip the buffer and are processed in
+ *             place in their rows. `source` and `destination` may be the same
+ *             view, and may differ in layout and format as long as they have
+ *             the same dimensions.
+ */
+class LUTImage
+{
+public:
+	LUTImage() = delete;
+
+	/**
+	 * @brief      Applies a LUT1D to every pixel of an image
+	 *
+	 * @throws     std::domain_error  If the views differ in width or height
+	 *
+	 * @param[in]  lut          The LUT
+	 * @param[in]  source       The input image
+	 * @param[in]  destination  The output image
+	 *
+	 * @tparam     T            The curve value type of the LUT
+	 */
+	template <typename T>
+	static void apply(const BasicLUT1D<T> & lut, const LUTImageView & source, const LUTImageView & destination);
+
+	/**
+	 * @brief      Applies a LUT3D to every pixel of an image
+	 *
+	 * @throws     std::domain_error  If the views differ in width or height
+	 *
+	 * @param[in]  lut            The LUT
+	 * @param[in]  source         The input image
+	 * @param[in]  destination    The output image
+	 * @param[in]  interpolation  The interpolation method
+	 *
+	 * @tparam     T              The lattice value type of the LUT
+	 */
+	template <typename T>
+	static void apply(const BasicLUT3D<T> & lut, const LUTImageView & source, const LUTImageView & destination,
+	                  LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      Applies a shaper and cube to every pixel of an image
+	 *
+	 * @throws     std::domain_error  If the views differ in width or height
+	 *
+	 * @param[in]  lut            The shaper and cube
+	 * @param[in]  source         The input image
+	 * @param[in]  destination    The output image
+	 * @param[in]  interpolation  The cube interpolation method
+	 *
+	 * @tparam     T              The table value type of the LUT
+	 */
+	template <typename T>
+	static void apply(const BasicLUTShaper3D<T> & lut, const LUTImageView & source, const LUTImageView & destination,
+	                  LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      Runs every stage of a chain over every pixel of an image
+	 *
+	 * @throws     std::domain_error  If the views differ in width or height
+	 *
+	 * @param[in]  chain        The chain
+	 * @param[in]  source       The input image
+	 * @param[in]  destination  The output image
+	 */
+	static void apply(const LUTBakeChain & chain, const LUTImageView & source, const LUTImageView & destination);
+};
+
+extern template void LUTImage::apply<float>(const LUT1Df &, const LUTImageView &, const LUTImageView &);
+extern template void LUTImage::apply<double>(const LUT1D &, const LUTImageView &, const LUTImageView &);
+extern template void LUTImage::apply<LUTHalf>(const LUT1Dh &, const LUTImageView &, const LUTImageView &);
+extern template void LUTImage::apply<float>(const LUT3Df &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+extern template void LUTImage::apply<double>(const LUT3D &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+extern template void LUTImage::apply<LUTHalf>(const LUT3Dh &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+extern template void LUTImage::apply<float>(const LUTShaper3Df &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+extern template void LUTImage::apply<double>(const LUTShaper3D &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+extern template void LUTImage::apply<LUTHalf>(const LUTShaper3Dh &, const LUTImageView &, const LUTImageView &, LUT3DInterpolation);
+
+}
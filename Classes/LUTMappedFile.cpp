@@ -0,0 +1,93 @@
+#include "LUTMappedFile.h"
+
+#include <fstream> // std::ifstream
+#include <iterator> // std::istreambuf_iterator
+#include <stdexcept> // std::runtime_error
+#include <utility> // std::swap
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CPPLUT_HAS_MMAP 1
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap munmap madvise
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+#endif
+
+using namespace CppLUT;
+
+LUTMappedFile::LUTMappedFile(): bytes(nullptr), length(0), mapped(false) {}
+
+LUTMappedFile LUTMappedFile::withPath(const std::string & path)
+{
+	LUTMappedFile file;
+#if defined(CPPLUT_HAS_MMAP)
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0)
+	{
+		throw std::runtime_error("Unable to open file: " + path);
+	}
+	struct stat status;
+	if (::fstat(descriptor, &status) != 0)
+	{
+		::close(descriptor);
+		throw std::runtime_error("Unable to read file: " + path);
+	}
+	file.length = (std::size_t)status.st_size;
+	if (file.length != 0)
+	{
+		void * memory = ::mmap(nullptr, file.length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (memory != MAP_FAILED)
+		{
+			::madvise(memory, file.length, MADV_SEQUENTIAL);
+			file.bytes = static_cast<const char *>(memory);
+			file.mapped = true;
+		}
+	}
+	::close(descriptor);
+	if (file.mapped || file.length == 0)
+	{
+		return file;
+	}
+#endif
+	std::ifstream stream(path.c_str(), std::ios::binary);
+	if (!stream)
+	{
+		throw std::runtime_error("Unable to open file: " + path);
+	}
+	file.fallback.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	file.bytes = file.fallback.data();
+	file.length = file.fallback.size();
+	return file;
+}
+
+LUTMappedFile::LUTMappedFile(LUTMappedFile && other): bytes(nullptr), length(0), mapped(false)
+{
+	*this = std::move(other);
+}
+
+LUTMappedFile & LUTMappedFile::operator=(LUTMappedFile && other)
+{
+	std::swap(bytes, other.bytes);
+	std::swap(length, other.length);
+	std::swap(mapped, other.mapped);
+	std::swap(fallback, other.fallback);
+	if (!mapped)
+	{
+		bytes = fallback.data();
+	}
+	if (!other.mapped)
+	{
+		other.bytes = other.fallback.data();
+	}
+	return *this;
+}
+
+LUTMappedFile::~LUTMappedFile()
+{
+#if defined(CPPLUT_HAS_MMAP)
+	if (mapped)
+	{
+		::munmap(const_cast<char *>(bytes), length);
+	}
+#endif
+}
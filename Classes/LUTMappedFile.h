@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CppLUT.h"
+
+#include <cstddef> // std::size_t
+#include <string> // std::string
+#include <vector> // std::vector
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A read-only view of a whole file.
+ * @discussion On POSIX systems the file is memory-mapped, so reading it costs
+ *             no copy and pages are only faulted in as a parser walks them.
+ *             Elsewhere the file is read into memory once.
+ */
+class LUTMappedFile
+{
+private:
+	/** @brief      The first byte of the file */
+	const char * bytes;
+
+	/** @brief      The length of the file in bytes */
+	std::size_t length;
+
+	/** @brief      Whether `bytes` is a mapping that must be unmapped */
+	bool mapped;
+
+	/** @brief      Holds the contents when the file could not be mapped */
+	std::vector<char> fallback;
+
+	/**
+	 * @brief      Private constructor for an empty file
+	 */
+	LUTMappedFile();
+
+public:
+	/**
+	 * @brief      Maps a file into memory
+	 *
+	 * @throws     std::runtime_error  If the file cannot be opened or read
+	 *
+	 * @param[in]  path  The path of the file
+	 *
+	 * @return     A `LUTMappedFile`
+	 */
+	static LUTMappedFile withPath(const std::string & path);
+
+	LUTMappedFile(LUTMappedFile && other);
+	LUTMappedFile & operator=(LUTMappedFile && other);
+	LUTMappedFile(const LUTMappedFile &) = delete;
+	LUTMappedFile & operator=(const LUTMappedFile &) = delete;
+	~LUTMappedFile();
+
+	/**
+	 * @brief      The contents of the file. Not null terminated.
+	 */
+	const char * data() const { return bytes; }
+
+	/**
+	 * @brief      The length of the file in bytes
+	 */
+	std::size_t size() const { return length; }
+};
+
+}
@@ -0,0 +1,248 @@
+#include "LUTMatrix3.h"
+#include "LUTSIMD.h"
+
+using namespace CppLUT;
+
+namespace
+{
+
+template <typename T, bool Clamp>
+void transformScalar(const LUTMatrix3 & matrix, const T * const input[3], T * const output[3],
+                     std::size_t begin, std::size_t end, double lowerBound, double upperBound)
+{
+	const double * m = matrix.m;
+	for (std::size_t i = begin; i < end; i++)
+	{
+		double r = (double)input[0][i];
+		double g = (double)input[1][i];
+		double b = (double)input[2][i];
+		double result[3] = {
+			m[0] * r + m[1] * g + m[2] * b,
+			m[3] * r + m[4] * g + m[5] * b,
+			m[6] * r + m[7] * g + m[8] * b
+		};
+		for (int c = 0; c < 3; c++)
+		{
+			if (Clamp)
+			{
+				// written so that NaN lands on the lower bound, as in the vector kernels
+				result[c] = (result[c] > lowerBound) ? result[c] : lowerBound;
+				result[c] = (result[c] < upperBound) ? result[c] : upperBound;
+			}
+			output[c][i] = (T)result[c];
+		}
+	}
+}
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+/**
+ * Per element type vector operations. Single and half precision planes are
+ * computed in single precision, double precision planes in double.
+ */
+template <typename T> struct AVX2Lanes;
+
+template <>
+struct AVX2Lanes<float>
+{
+	typedef __m256 V;
+	static const int count = 8;
+	CPPLUT_TARGET_AVX2 static V set1(double value) { return _mm256_set1_ps((float)value); }
+	CPPLUT_TARGET_AVX2 static V load(const float * p) { return _mm256_loadu_ps(p); }
+	CPPLUT_TARGET_AVX2 static void store(float * p, V v) { _mm256_storeu_ps(p, v); }
+	CPPLUT_TARGET_AVX2 static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+	CPPLUT_TARGET_AVX2 static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+	CPPLUT_TARGET_AVX2 static V max(V a, V b) { return _mm256_max_ps(a, b); }
+	CPPLUT_TARGET_AVX2 static V min(V a, V b) { return _mm256_min_ps(a, b); }
+};
+
+template <>
+struct AVX2Lanes<LUTHalf>: AVX2Lanes<float>
+{
+	CPPLUT_TARGET_AVX2 static V load(const LUTHalf * p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p)); }
+	CPPLUT_TARGET_AVX2 static void store(LUTHalf * p, V v)
+	{
+		_mm_storeu_si128((__m128i *)p, _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+	}
+};
+
+template <>
+struct AVX2Lanes<double>
+{
+	typedef __m256d V;
+	static const int count = 4;
+	CPPLUT_TARGET_AVX2 static V set1(double value) { return _mm256_set1_pd(value); }
+	CPPLUT_TARGET_AVX2 static V load(const double * p) { return _mm256_loadu_pd(p); }
+	CPPLUT_TARGET_AVX2 static void store(double * p, V v) { _mm256_storeu_pd(p, v); }
+	CPPLUT_TARGET_AVX2 static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+	CPPLUT_TARGET_AVX2 static V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+	CPPLUT_TARGET_AVX2 static V max(V a, V b) { return _mm256_max_pd(a, b); }
+	CPPLUT_TARGET_AVX2 static V min(V a, V b) { return _mm256_min_pd(a, b); }
+};
+
+template <typename T, bool Clamp>
+CPPLUT_TARGET_AVX2 void transformAVX2(const LUTMatrix3 & matrix, const T * const input[3], T * const output[3],
+                                      std::size_t count, double lowerBound, double upperBound)
+{
+	typedef AVX2Lanes<T> L;
+	typedef typename L::V V;
+	V m[9];
+	for (int i = 0; i < 9; i++)
+	{
+		m[i] = L::set1(matrix.m[i]);
+	}
+	const V lower = L::set1(lowerBound);
+	const V upper = L::set1(upperBound);
+
+	std::size_t i = 0;
+	for (; i + L::count <= count; i += L::count)
+	{
+		V r = L::load(input[0] + i);
+		V g = L::load(input[1] + i);
+		V b = L::load(input[2] + i);
+		V result[3];
+		for (int c = 0; c < 3; c++)
+		{
+			result[c] = L::fmadd(m[c * 3], r, L::fmadd(m[c * 3 + 1], g, L::mul(m[c * 3 + 2], b)));
+			if (Clamp)
+			{
+				result[c] = L::min(L::max(result[c], lower), upper);
+			}
+		}
+		L::store(output[0] + i, result[0]);
+		L::store(output[1] + i, result[1]);
+		L::store(output[2] + i, result[2]);
+	}
+	// the scalar tail is compiled as a sibling call, and GCC emits no vzeroupper
+	// before that jump, so without this the dirty upper state would slow the
+	// tail and any SSE code the caller runs next
+	_mm256_zeroupper();
+	transformScalar<T, Clamp>(matrix, input, output, i, count, lowerBound, upperBound);
+}
+
+template <typename T> struct AVX512Lanes;
+
+template <>
+struct AVX512Lanes<float>
+{
+	typedef __m512 V;
+	static const int count = 16;
+	CPPLUT_TARGET_AVX512 static V set1(double value) { return _mm512_set1_ps((float)value); }
+	CPPLUT_TARGET_AVX512 static V load(const float * p) { return _mm512_loadu_ps(p); }
+	CPPLUT_TARGET_AVX512 static void store(float * p, V v) { _mm512_storeu_ps(p, v); }
+	CPPLUT_TARGET_AVX512 static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+	CPPLUT_TARGET_AVX512 static V fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+	CPPLUT_TARGET_AVX512 static V max(V a, V b) { return _mm512_max_ps(a, b); }
+	CPPLUT_TARGET_AVX512 static V min(V a, V b) { return _mm512_min_ps(a, b); }
+};
+
+template <>
+struct AVX512Lanes<LUTHalf>: AVX512Lanes<float>
+{
+	CPPLUT_TARGET_AVX512 static V load(const LUTHalf * p) { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i *)p)); }
+	CPPLUT_TARGET_AVX512 static void store(LUTHalf * p, V v)
+	{
+		_mm256_storeu_si256((__m256i *)p, _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+	}
+};
+
+template <>
+struct AVX512Lanes<double>
+{
+	typedef __m512d V;
+	static const int count = 8;
+	CPPLUT_TARGET_AVX512 static V set1(double value) { return _mm512_set1_pd(value); }
+	CPPLUT_TARGET_AVX512 static V load(const double * p) { return _mm512_loadu_pd(p); }
+	CPPLUT_TARGET_AVX512 static void store(double * p, V v) { _mm512_storeu_pd(p, v); }
+	CPPLUT_TARGET_AVX512 static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+	CPPLUT_TARGET_AVX512 static V fmadd(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+	CPPLUT_TARGET_AVX512 static V max(V a, V b) { return _mm512_max_pd(a, b); }
+	CPPLUT_TARGET_AVX512 static V min(V a, V b) { return _mm512_min_pd(a, b); }
+};
+
+template <typename T, bool Clamp>
+CPPLUT_TARGET_AVX512 void transformAVX512(const LUTMatrix3 & matrix, const T * const input[3], T * const output[3],
+                                          std::size_t count, double lowerBound, double upperBound)
+{
+	typedef AVX512Lanes<T> L;
+	typedef typename L::V V;
+	V m[9];
+	for (int i = 0; i < 9; i++)
+	{
+		m[i] = L::set1(matrix.m[i]);
+	}
+	const V lower = L::set1(lowerBound);
+	const V upper = L::set1(upperBound);
+
+	std::size_t i = 0;
+	for (; i + L::count <= count; i += L::count)
+	{
+		V r = L::load(input[0] + i);
+		V g = L::load(input[1] + i);
+		V b = L::load(input[2] + i);
+		V result[3];
+		for (int c = 0; c < 3; c++)
+		{
+			result[c] = L::fmadd(m[c * 3], r, L::fmadd(m[c * 3 + 1], g, L::mul(m[c * 3 + 2], b)));
+			if (Clamp)
+			{
+				result[c] = L::min(L::max(result[c], lower), upper);
+			}
+		}
+		L::store(output[0] + i, result[0]);
+		L::store(output[1] + i, result[1]);
+		L::store(output[2] + i, result[2]);
+	}
+	// the scalar tail is compiled as a sibling call, and GCC emits no vzeroupper
+	// before that jump, so without this the dirty upper state would slow the
+	// tail and any SSE code the caller runs next
+	_mm256_zeroupper();
+	transformScalar<T, Clamp>(matrix, input, output, i, count, lowerBound, upperBound);
+}
+
+#endif
+
+template <typename T, bool Clamp>
+void transformDispatch(const LUTMatrix3 & matrix, const T * const input[3], T * const output[3],
+                       std::size_t count, double lowerBound, double upperBound)
+{
+#if defined(CPPLUT_X86_DISPATCH)
+	switch (LUTSIMD::activeLevel())
+	{
+		case LUTSIMD::AVX512:
+			transformAVX512<T, Clamp>(matrix, input, output, count, lowerBound, upperBound);
+			return;
+		case LUTSIMD::AVX2:
+			transformAVX2<T, Clamp>(matrix, input, output, count, lowerBound, upperBound);
+			return;
+		default:
+			break;
+	}
+#endif
+	transformScalar<T, Clamp>(matrix, input, output, 0, count, lowerBound, upperBound);
+}
+
+}
+
+template <typename T>
+void LUTMatrix3::transformPlanes(const T * const input[3], T * const output[3], std::size_t count) const
+{
+	transformDispatch<T, false>(*this, input, output, count, 0, 0);
+}
+
+template <typename T>
+void LUTMatrix3::transformPlanes(const T * const input[3], T * const output[3], std::size_t count,
+                                 double lowerBound, double upperBound) const
+{
+	transformDispatch<T, true>(*this, input, output, count, lowerBound, upperBound);
+}
+
+namespace CppLUT
+{
+template void LUTMatrix3::transformPlanes<float>(const float * const [3], float * const [3], std::size_t) const;
+template void LUTMatrix3::transformPlanes<double>(const double * const [3], double * const [3], std::size_t) const;
+template void LUTMatrix3::transformPlanes<LUTHalf>(const LUTHalf * const [3], LUTHalf * const [3], std::size_t) const;
+template void LUTMatrix3::transformPlanes<float>(const float * const [3], float * const [3], std::size_t, double, double) const;
+template void LUTMatrix3::transformPlanes<double>(const double * const [3], double * const [3], std::size_t, double, double) const;
+template void LUTMatrix3::transformPlanes<LUTHalf>(const LUTHalf * const [3], LUTHalf * const [3], std::size_t, double, double) const;
+}
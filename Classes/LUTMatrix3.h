@@ -0,0 +1,167 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUTHalf.h"
+
+#include <cstddef> // std::size_t
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A row-major 3x3 matrix used for RGB <-> XYZ transforms and
+ *             chromatic adaptation.
+ */
+struct LUTMatrix3
+{
+	/** @brief      The elements, row by row */
+	double m[9];
+
+	/**
+	 * @brief      Creates a matrix from its rows
+	 *
+	 * @return     A `LUTMatrix3`
+	 */
+	static LUTMatrix3 withRows(double m00, double m01, double m02,
+	                           double m10, double m11, double m12,
+	                           double m20, double m21, double m22)
+	{
+		LUTMatrix3 matrix = { { m00, m01, m02, m10, m11, m12, m20, m21, m22 } };
+		return matrix;
+	}
+
+	/**
+	 * @brief      The identity matrix
+	 *
+	 * @return     A `LUTMatrix3`
+	 */
+	static LUTMatrix3 identity()
+	{
+		return withRows(1, 0, 0, 0, 1, 0, 0, 0, 1);
+	}
+
+	/**
+	 * @brief      A matrix with the given values on its diagonal
+	 *
+	 * @return     A `LUTMatrix3`
+	 */
+	static LUTMatrix3 diagonal(double d0, double d1, double d2)
+	{
+		return withRows(d0, 0, 0, 0, d1, 0, 0, 0, d2);
+	}
+
+	double operator()(int row, int column) const { return m[row * 3 + column]; }
+
+	/**
+	 * @brief      Multiplies a column vector by the matrix
+	 *
+	 * @param[in]  in    The input vector
+	 * @param[out] out   The output vector, may not alias `in`
+	 */
+	void apply(const double in[3], double out[3]) const
+	{
+		out[0] = m[0] * in[0] + m[1] * in[1] + m[2] * in[2];
+		out[1] = m[3] * in[0] + m[4] * in[1] + m[5] * in[2];
+		out[2] = m[6] * in[0] + m[7] * in[1] + m[8] * in[2];
+	}
+
+	/**
+	 * @brief      Determine the determinant of the matrix
+	 *
+	 * @return     The determinant
+	 */
+	double determinant() const
+	{
+		return m[0] * (m[4] * m[8] - m[5] * m[7])
+		     - m[1] * (m[3] * m[8] - m[5] * m[6])
+		     + m[2] * (m[3] * m[7] - m[4] * m[6]);
+	}
+
+	/**
+	 * @brief      Determine the inverse of the matrix. A singular matrix
+	 *             produces non-finite elements.
+	 *
+	 * @return     The inverse matrix
+	 */
+	LUTMatrix3 inverse() const
+	{
+		double inverseDeterminant = 1.0 / determinant();
+		return withRows((m[4] * m[8] - m[5] * m[7]) * inverseDeterminant,
+		                (m[2] * m[7] - m[1] * m[8]) * inverseDeterminant,
+		                (m[1] * m[5] - m[2] * m[4]) * inverseDeterminant,
+		                (m[5] * m[6] - m[3] * m[8]) * inverseDeterminant,
+		                (m[0] * m[8] - m[2] * m[6]) * inverseDeterminant,
+		                (m[2] * m[3] - m[0] * m[5]) * inverseDeterminant,
+		                (m[3] * m[7] - m[4] * m[6]) * inverseDeterminant,
+		                (m[1] * m[6] - m[0] * m[7]) * inverseDeterminant,
+		                (m[0] * m[4] - m[1] * m[3]) * inverseDeterminant);
+	}
+
+	/**
+	 * @brief      Multiplies every point of three planes by the matrix
+	 * @discussion Runs with the widest vector instruction set available.
+	 *             `output` may be the same planes as `input` for an in-place
+	 *             transform. Half precision planes are computed in single
+	 *             precision.
+	 *
+	 * @param[in]  input   The red, green and blue input planes
+	 * @param[out] output  The red, green and blue output planes
+	 * @param[in]  count   The number of points in each plane
+	 *
+	 * @tparam     T       The plane element type
+	 */
+	template <typename T>
+	void transformPlanes(const T * const input[3], T * const output[3], std::size_t count) const;
+
+	/**
+	 * @brief      Multiplies every point of three planes by the matrix and
+	 *             clamps the result to a range in the same pass
+	 * @discussion Pass bounds of 0 and 1 for the equivalent of
+	 *             `LUTColor::clamp01`. NaN results clamp to `lowerBound`.
+	 *
+	 * @param[in]  input       The red, green and blue input planes
+	 * @param[out] output      The red, green and blue output planes
+	 * @param[in]  count       The number of points in each plane
+	 * @param[in]  lowerBound  The lower bound
+	 * @param[in]  upperBound  The upper bound
+	 *
+	 * @tparam     T           The plane element type
+	 */
+	template <typename T>
+	void transformPlanes(const T * const input[3], T * const output[3], std::size_t count,
+	                     double lowerBound, double upperBound) const;
+
+	LUTMatrix3 operator*(const LUTMatrix3 & other) const
+	{
+		LUTMatrix3 result;
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				result.m[row * 3 + column] = m[row * 3] * other.m[column]
+				                           + m[row * 3 + 1] * other.m[3 + column]
+				                           + m[row * 3 + 2] * other.m[6 + column];
+			}
+		}
+		return result;
+	}
+
+	LUTMatrix3 operator*(double scale) const
+	{
+		LUTMatrix3 result;
+		for (int i = 0; i < 9; i++)
+		{
+			result.m[i] = m[i] * scale;
+		}
+		return result;
+	}
+};
+
+extern template void LUTMatrix3::transformPlanes<float>(const float * const [3], float * const [3], std::size_t) const;
+extern template void LUTMatrix3::transformPlanes<double>(const double * const [3], double * const [3], std::size_t) const;
+extern template void LUTMatrix3::transformPlanes<LUTHalf>(const LUTHalf * const [3], LUTHalf * const [3], std::size_t) const;
+extern template void LUTMatrix3::transformPlanes<float>(const float * const [3], float * const [3], std::size_t, double, double) const;
+extern template void LUTMatrix3::transformPlanes<double>(const double * const [3], double * const [3], std::size_t, double, double) const;
+extern template void LUTMatrix3::transformPlanes<LUTHalf>(const LUTHalf * const [3], LUTHalf * const [3], std::size_t, double, double) const;
+
+}
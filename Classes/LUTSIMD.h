@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CppLUT.h"
+
+#include <atomic> // std::atomic
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPPLUT_X86_DISPATCH 1
+#include <immintrin.h>
+#define CPPLUT_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+#define CPPLUT_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma,f16c")))
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CPPLUT_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CPPLUT_ALWAYS_INLINE inline
+#endif
+
+namespace CppLUT
+{
+
+/**
+ * @brief      Runtime selection of the vector instruction set used by the
+ *             batch kernels.
+ * @discussion Kernels are compiled for every level with per-function target
+ *             attributes, so the library itself builds without `-mavx2` and
+ *             picks the widest level the running CPU supports.
+ */
+namespace LUTSIMD
+{
+	enum Level
+	{
+		Scalar = 0,
+		AVX2 = 1,
+		AVX512 = 2
+	};
+
+	/**
+	 * @brief      Determine the widest instruction set supported by the CPU
+	 *
+	 * @return     The supported `Level`
+	 */
+	inline Level supportedLevel()
+	{
+#if defined(CPPLUT_X86_DISPATCH)
+		static const Level level = __builtin_cpu_supports("avx512f") ? AVX512 :
+		                           ((__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+		                             && __builtin_cpu_supports("f16c")) ? AVX2 : Scalar);
+		return level;
+#else
+		return Scalar;
+#endif
+	}
+
+	inline std::atomic<int> & levelLimitStorage()
+	{
+		static std::atomic<int> limit(AVX512);
+		return limit;
+	}
+
+	/**
+	 * @brief      Caps the instruction set used by the batch kernels, e.g. to
+	 *             compare against the scalar fallback
+	 *
+	 * @param[in]  limit  The widest `Level` kernels may use
+	 */
+	inline void setLevelLimit(Level limit) { levelLimitStorage() = limit; }
+
+	/**
+	 * @brief      The instruction set the batch kernels will use
+	 *
+	 * @return     The lesser of `supportedLevel()` and the level limit
+	 */
+	inline Level activeLevel()
+	{
+		int limit = levelLimitStorage();
+		Level supported = supportedLevel();
+		return (supported < limit) ? supported : (Level)limit;
+	}
+}
+
+}
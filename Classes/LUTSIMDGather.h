@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUTHalf.h"
+#include "LUTSIMD.h"
+
+#if defined(CPPLUT_X86_DISPATCH)
+
+namespace CppLUT
+{
+
+namespace LUTSIMD
+{
+	/**
+	 * Gathers table entries at 32-bit indices into single precision lanes,
+	 * converting from the table value type.
+	 */
+	CPPLUT_TARGET_AVX2 inline __m256 gatherAVX2(const float * plane, __m256i index)
+	{
+		return _mm256_i32gather_ps(plane, index, 4);
+	}
+
+	CPPLUT_TARGET_AVX2 inline __m256 gatherAVX2(const double * plane, __m256i index)
+	{
+		__m256d low = _mm256_i32gather_pd(plane, _mm256_castsi256_si128(index), 8);
+		__m256d high = _mm256_i32gather_pd(plane, _mm256_extracti128_si256(index, 1), 8);
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low)), _mm256_cvtpd_ps(high), 1);
+	}
+
+	/**
+	 * @brief      Gathers half precision values with 32-bit loads at a 2 byte
+	 *             scale, keeping the low 16 bits of each lane. The upper bytes of
+	 *             the last point read into the slack at the end of each plane.
+	 */
+	CPPLUT_TARGET_AVX2 inline __m256 gatherAVX2(const LUTHalf * plane, __m256i index)
+	{
+		__m256i words = _mm256_i32gather_epi32((const int *)plane, index, 2);
+		words = _mm256_and_si256(words, _mm256_set1_epi32(0xFFFF));
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(words, words), 0x08);
+		return _mm256_cvtph_ps(_mm256_castsi256_si128(packed));
+	}
+
+	CPPLUT_TARGET_AVX512 inline __m512 gatherAVX512(const float * plane, __m512i index)
+	{
+		return _mm512_i32gather_ps(index, plane, 4);
+	}
+
+	CPPLUT_TARGET_AVX512 inline __m512 gatherAVX512(const LUTHalf * plane, __m512i index)
+	{
+		__m512i words = _mm512_i32gather_epi32(index, (const int *)plane, 2);
+		return _mm512_cvtph_ps(_mm512_cvtepi32_epi16(words));
+	}
+
+	CPPLUT_TARGET_AVX512 inline __m512 gatherAVX512(const double * plane, __m512i index)
+	{
+		__m256 low = _mm512_cvtpd_ps(_mm512_i32gather_pd(_mm512_castsi512_si256(index), plane, 8));
+		__m256 high = _mm512_cvtpd_ps(_mm512_i32gather_pd(_mm512_extracti64x4_epi64(index, 1), plane, 8));
+		return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(low)), _mm256_castps_pd(high), 1));
+	}
+}
+
+}
+
+#endif
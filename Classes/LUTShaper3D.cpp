@@ -0,0 +1,356 @@
+#include "LUTShaper3D.h"
+#include "LUTHelper.h"
+
+#include <algorithm> // std::max std::min
+#include <cmath> // std::fabs std::isnan std::pow
+#include <stdexcept> // std::domain_error
+#include <string> // std::to_string
+#include <vector> // std::vector
+
+using namespace CppLUT;
+
+namespace
+{
+
+/** @brief      The number of pixels passed through the shaper and cube at a time */
+const std::size_t blockPixels = 1024;
+
+/**
+ * @brief      The powers of the curvature tried when fitting a shaper. 0 is a
+ *             uniform shaper, higher powers pack more lattice points into the
+ *             regions that bend the most.
+ */
+const double fitPowers[] = { 0, 0.25, 0.5, 0.75, 1 };
+
+/**
+ * @brief      Finds the inputs an increasing curve maps onto a list
+ *             of ascending targets. Targets beyond the ends of the curve land
+ *             on the ends of the input range.
+ */
+template <typename T>
+std::vector<double> invertCurve(const T * curve, int size, double inputLowerBound, double inputUpperBound,
+                                const std::vector<double> & targets)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	const double step = (inputUpperBound - inputLowerBound) / (size - 1);
+	std::vector<double> inputs(targets.size());
+	int j = 0;
+	for (std::size_t i = 0; i < targets.size(); i++)
+	{
+		const double target = targets[i];
+		if (target <= (C)curve[0])
+		{
+			inputs[i] = inputLowerBound;
+			continue;
+		}
+		if (target >= (C)curve[size - 1])
+		{
+			inputs[i] = inputUpperBound;
+			continue;
+		}
+		while (j < size - 2 && (C)curve[j + 1] < target)
+		{
+			j++;
+		}
+		const double low = (C)curve[j];
+		const double high = (C)curve[j + 1];
+		inputs[i] = inputLowerBound + (j + (target - low) / (high - low)) * step;
+	}
+	return inputs;
+}
+
+/**
+ * @brief      Checks that a curve never decreases and ends higher than it
+ *             starts. Flat steps are allowed because half precision cannot
+ *             resolve neighbouring entries of a long curve.
+ */
+template <typename T>
+bool isIncreasing(const T * curve, int size)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	for (int i = 1; i < size; i++)
+	{
+		if (!((C)curve[i - 1] <= (C)curve[i]))
+		{
+			return false;
+		}
+	}
+	return (C)curve[0] < (C)curve[size - 1];
+}
+
+/**
+ * @brief      Sums the absolute second differences of the transform's
+ *             channels at each point of the neutral axis, averaged over a
+ *             window one lattice cell wide.
+ */
+std::vector<double> neutralCurvature(const std::function<LUTColor(const LUTColor &)> & transform,
+                                     const std::vector<double> & inputs, int cubeSize)
+{
+	const int count = (int)inputs.size();
+	std::vector<LUTColor> outputs(count, LUTColor::colorWithZeroes());
+	LUTHelper::concurrentTileLoop(count, [&](int i)
+	{
+		outputs[i] = transform(LUTColor::colorWithValue(inputs[i]));
+	});
+
+	std::vector<double> curvature(count, 0);
+	for (int i = 1; i < count - 1; i++)
+	{
+		curvature[i] = std::fabs(outputs[i + 1].getR() - 2 * outputs[i].getR() + outputs[i - 1].getR())
+		             + std::fabs(outputs[i + 1].getG() - 2 * outputs[i].getG() + outputs[i - 1].getG())
+		             + std::fabs(outputs[i + 1].getB() - 2 * outputs[i].getB() + outputs[i - 1].getB());
+	}
+	curvature[0] = curvature[1];
+	curvature[count - 1] = curvature[count - 2];
+
+	// a running sum gives the windowed average in one pass
+	const int radius = std::max(1, count / (2 * (cubeSize - 1)));
+	std::vector<double> prefix(count + 1, 0);
+	for (int i = 0; i < count; i++)
+	{
+		prefix[i + 1] = prefix[i] + curvature[i];
+	}
+	std::vector<double> smoothed(count);
+	for (int i = 0; i < count; i++)
+	{
+		const int begin = std::max(0, i - radius);
+		const int end = std::min(count, i + radius + 1);
+		smoothed[i] = (prefix[end] - prefix[begin]) / (end - begin);
+	}
+	return smoothed;
+}
+
+}
+
+template <typename T>
+BasicLUTShaper3D<T> BasicLUTShaper3D<T>::withShaperAndCube(const BasicLUT1D<T> & shaper, const BasicLUT3D<T> & cube)
+{
+	return BasicLUTShaper3D(shaper, cube);
+}
+
+template <typename T>
+BasicLUTShaper3D<T> BasicLUTShaper3D<T>::withShaperAndTransform(const BasicLUT1D<T> & shaper, int cubeSize,
+                                                                const Transform & transform)
+{
+	typedef typename LUTColorValueTraits<T>::ComputeType C;
+	const int shaperSize = shaper.getSize();
+	const T * curves[3] = { shaper.redCurve(), shaper.greenCurve(), shaper.blueCurve() };
+	double lowerBound = (C)curves[0][0];
+	double upperBound = (C)curves[0][shaperSize - 1];
+	for (int c = 0; c < 3; c++)
+	{
+		if (!isIncreasing(curves[c], shaperSize))
+		{
+			throw std::domain_error("Invalid Shaper: shaper curves must be increasing");
+		}
+		lowerBound = std::min(lowerBound, (double)(C)curves[c][0]);
+		upperBound = std::max(upperBound, (double)(C)curves[c][shaperSize - 1]);
+	}
+
+	BasicLUT3D<T> cube = BasicLUT3D<T>::withSize(cubeSize, lowerBound, upperBound);
+	std::vector<double> latticeValues(cubeSize);
+	for (int i = 0; i < cubeSize; i++)
+	{
+		latticeValues[i] = lowerBound + i * (upperBound - lowerBound) / (cubeSize - 1);
+	}
+	std::vector<double> inputs[3];
+	for (int c = 0; c < 3; c++)
+	{
+		inputs[c] = invertCurve(curves[c], shaperSize, shaper.getInputLowerBound(), shaper.getInputUpperBound(),
+		                        latticeValues);
+	}
+
+	T * red = cube.redPlane();
+	T * green = cube.greenPlane();
+	T * blue = cube.bluePlane();
+	LUTHelper::LUT3DConcurrentLoop(cubeSize, [&](int r, int g, int b)
+	{
+		LUTColor color = transform(LUTColor::colorWithRGB(inputs[0][r], inputs[1][g], inputs[2][b]));
+		const std::size_t index = cube.indexOfPoint(r, g, b);
+		red[index] = (T)color.getR();
+		green[index] = (T)color.getG();
+		blue[index] = (T)color.getB();
+	});
+	return BasicLUTShaper3D(shaper, cube);
+}
+
+template <typename T>
+BasicLUTShaper3D<T> BasicLUTShaper3D<T>::fitToTransform(const Transform & transform, double inputLowerBound,
+                                                        double inputUpperBound, int cubeSize, int shaperSize,
+                                                        LUT3DInterpolation interpolation)
+{
+	if (cubeSize < 2 || cubeSize > CPPLUT_MAX_LUT3D_SIZE)
+	{
+		throw std::domain_error("Invalid LUT3D Size: size " + std::to_string(cubeSize) + " must be in the range 2 to "
+		                        + std::to_string(CPPLUT_MAX_LUT3D_SIZE));
+	}
+	BasicLUT1D<T> shaper = BasicLUT1D<T>::withSize(shaperSize, inputLowerBound, inputUpperBound);
+
+	std::vector<double> inputs = LUTHelper::indicesDoubleVector(0, 1, shaperSize);
+	for (double & input : inputs)
+	{
+		input = inputLowerBound + input * (inputUpperBound - inputLowerBound);
+	}
+	std::vector<double> curvature = neutralCurvature(transform, inputs, cubeSize);
+	double meanCurvature = 0;
+	for (double value : curvature)
+	{
+		meanCurvature += value;
+	}
+	meanCurvature /= shaperSize;
+	// keeps flat regions from being starved of lattice points
+	const double floor = (meanCurvature > 0) ? meanCurvature * 1e-2 : 1;
+
+	BasicLUTShaper3D best(shaper, BasicLUT3D<T>::withSize(2));
+	double bestError = -1;
+	std::vector<double> cumulative(shaperSize);
+	for (double power : fitPowers)
+	{
+		cumulative[0] = 0;
+		double previous = std::pow(curvature[0] + floor, power);
+		for (int i = 1; i < shaperSize; i++)
+		{
+			const double density = std::pow(curvature[i] + floor, power);
+			cumulative[i] = cumulative[i - 1] + 0.5 * (previous + density);
+			previous = density;
+		}
+		T * curves[3] = { shaper.redCurve(), shaper.greenCurve(), shaper.blueCurve() };
+		for (int i = 0; i < shaperSize; i++)
+		{
+			curves[0][i] = curves[1][i] = curves[2][i] = (T)(cumulative[i] / cumulative[shaperSize - 1]);
+		}
+		BasicLUTShaper3D candidate = withShaperAndTransform(shaper, cubeSize, transform);
+		const double error = candidate.maxErrorAgainst(transform, 17, interpolation);
+		if (bestError < 0 || error < bestError || std::isnan(bestError))
+		{
+			best = candidate;
+			bestError = error;
+		}
+	}
+	return best;
+}
+
+template <typename T>
+std::size_t BasicLUTShaper3D<T>::getTableSize() const
+{
+	return (3 * (std::size_t)shaper.getSize() + 3 * cube.getPointCount()) * sizeof(T);
+}
+
+template <typename T>
+typename BasicLUTShaper3D<T>::Color BasicLUTShaper3D<T>::colorAtColor(const Color & color,
+                                                                    LUT3DInterpolation interpolation) const
+{
+	return cube.colorAtColor(shaper.colorAtColor(color), interpolation);
+}
+
+template <typename T>
+void BasicLUTShaper3D<T>::apply(const float * input, float * output, std::size_t pixelCount,
+                                LUT3DInterpolation interpolation, std::size_t pixelStride) const
+{
+	for (std::size_t p = 0; p < pixelCount; p += blockPixels)
+	{
+		const std::size_t count = std::min(blockPixels, pixelCount - p);
+		float * block = output + p * pixelStride;
+		shaper.apply(input + p * pixelStride, block, count, pixelStride);
+		cube.apply(block, block, count, interpolation, pixelStride);
+	}
+}
+
+template <typename T>
+double BasicLUTShaper3D<T>::maxErrorAgainst(const Transform & transform, int samplesPerAxis,
+                                            LUT3DInterpolation interpolation) const
+{
+	if (samplesPerAxis < 2)
+	{
+		throw std::domain_error("Invalid Sample Count: samples per axis " + std::to_string(samplesPerAxis)
+		                        + " must be at least 2");
+	}
+	std::vector<double> axes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		axes[c] = LUTHelper::indicesDoubleVector(0, 1, samplesPerAxis);
+		for (double & value : axes[c])
+		{
+			value = shaper.getInputLowerBound() + value * (shaper.getInputUpperBound() - shaper.getInputLowerBound());
+		}
+	}
+
+	// the input that lands in the centre of each lattice cell
+	const int cells = cube.getSize() - 1;
+	std::vector<double> centres(cells);
+	for (int i = 0; i < cells; i++)
+	{
+		centres[i] = cube.getInputLowerBound() + (i + 0.5) * (cube.getInputUpperBound() - cube.getInputLowerBound()) / cells;
+	}
+	const T * curves[3] = { shaper.redCurve(), shaper.greenCurve(), shaper.blueCurve() };
+	std::vector<double> cellAxes[3];
+	for (int c = 0; c < 3; c++)
+	{
+		cellAxes[c] = invertCurve(curves[c], shaper.getSize(), shaper.getInputLowerBound(), shaper.getInputUpperBound(),
+		                          centres);
+	}
+
+	const std::size_t gridCount = (std::size_t)samplesPerAxis * samplesPerAxis * samplesPerAxis;
+	const std::size_t cellCount = (std::size_t)cells * cells * cells;
+	std::vector<float> inputs(3 * (gridCount + cellCount));
+	for (std::size_t i = 0; i < gridCount; i++)
+	{
+		inputs[3 * i] = (float)axes[0][i % samplesPerAxis];
+		inputs[3 * i + 1] = (float)axes[1][(i / samplesPerAxis) % samplesPerAxis];
+		inputs[3 * i + 2] = (float)axes[2][i / ((std::size_t)samplesPerAxis * samplesPerAxis)];
+	}
+	for (std::size_t i = 0; i < cellCount; i++)
+	{
+		float * point = &inputs[3 * (gridCount + i)];
+		point[0] = (float)cellAxes[0][i % cells];
+		point[1] = (float)cellAxes[1][(i / cells) % cells];
+		point[2] = (float)cellAxes[2][i / ((std::size_t)cells * cells)];
+	}
+
+	const std::size_t pointCount = gridCount + cellCount;
+	std::vector<float> outputs(inputs.size());
+	apply(inputs.data(), outputs.data(), pointCount, interpolation);
+
+	const int tileCount = (int)((pointCount + CPPLUT_CONCURRENT_TILE_POINTS - 1) / CPPLUT_CONCURRENT_TILE_POINTS);
+	std::vector<double> tileErrors(tileCount, 0);
+	LUTHelper::concurrentTileLoop(tileCount, [&](int tile)
+	{
+		const std::size_t begin = (std::size_t)tile * CPPLUT_CONCURRENT_TILE_POINTS;
+		const std::size_t end = std::min(pointCount, begin + CPPLUT_CONCURRENT_TILE_POINTS);
+		double error = 0;
+		for (std::size_t i = begin; i < end; i++)
+		{
+			const float * in = &inputs[3 * i];
+			const float * out = &outputs[3 * i];
+			LUTColor expected = transform(LUTColor::colorWithRGB(in[0], in[1], in[2]));
+			const double differences[3] = { std::fabs(expected.getR() - out[0]), std::fabs(expected.getG() - out[1]),
+			                                std::fabs(expected.getB() - out[2]) };
+			for (double difference : differences)
+			{
+				// a NaN difference replaces the maximum and is never replaced itself
+				if (std::isnan(difference) || difference > error)
+				{
+					error = difference;
+				}
+			}
+		}
+		tileErrors[tile] = error;
+	});
+
+	double error = 0;
+	for (double tileError : tileErrors)
+	{
+		if (std::isnan(tileError) || tileError > error)
+		{
+			error = tileError;
+		}
+	}
+	return error;
+}
+
+namespace CppLUT
+{
+template class BasicLUTShaper3D<float>;
+template class BasicLUTShaper3D<double>;
+template class BasicLUTShaper3D<LUTHalf>;
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "CppLUT.h"
+#include "LUT1D.h"
+#include "LUT3D.h"
+
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+
+namespace CppLUT
+{
+
+/**
+ * @brief      A 1D shaper followed by a 3D cube.
+ * @discussion The shaper redistributes the input so that the cube's lattice
+ *             points fall where the transform bends the most. Log, PQ and
+ *             scene-linear input that would need a 65^3 cube on its own can
+ *             usually be held to the same error by a 33^3 cube behind a
+ *             shaper, an eighth of the lattice memory. The cube's input
+ *             bounds are the range of the shaper's output.
+ *
+ * @tparam     T     The shaper and lattice value type: `float`, `double` or
+ *                   `LUTHalf`
+ */
+template <typename T>
+class BasicLUTShaper3D
+{
+public:
+	/** @brief      The color type handed out for single lookups */
+	typedef BasicLUTColor<T> Color;
+
+	/**
+	 * @brief      A transform to be sampled into a shaper and cube. It is
+	 *             called concurrently from several threads.
+	 */
+	typedef std::function<LUTColor(const LUTColor &)> Transform;
+
+private:
+	/** @brief      The 1D shaper applied first */
+	BasicLUT1D<T> shaper;
+
+	/** @brief      The 3D cube applied to the shaper's output */
+	BasicLUT3D<T> cube;
+
+	/**
+	 * @brief      Private constructor for a LUTShaper3D
+	 *
+	 * @param[in]  shaper  The 1D shaper
+	 * @param[in]  cube    The 3D cube
+	 */
+	BasicLUTShaper3D(const BasicLUT1D<T> & shaper, const BasicLUT3D<T> & cube): shaper(shaper), cube(cube) {}
+
+public:
+	/**
+	 * @brief      Creates a `LUTShaper3D` from an existing shaper and cube
+	 *
+	 * @param[in]  shaper  The 1D shaper
+	 * @param[in]  cube    The 3D cube, taking the shaper's output as input
+	 *
+	 * @return     A `LUTShaper3D`
+	 */
+	static BasicLUTShaper3D withShaperAndCube(const BasicLUT1D<T> & shaper, const BasicLUT3D<T> & cube);
+
+	/**
+	 * @brief      Creates a `LUTShaper3D` by sampling a transform through an
+	 *             existing shaper. Each lattice point holds the transform of
+	 *             the input that the shaper maps onto it.
+	 *
+	 * @throws     std::domain_error  If a shaper curve decreases anywhere
+	 *                                or does not end above its start
+	 * @throws     std::domain_error  If cubeSize is not in the range 2 to
+	 *                                `CPPLUT_MAX_LUT3D_SIZE`
+	 *
+	 * @param[in]  shaper     The 1D shaper
+	 * @param[in]  cubeSize   The edge length of the cube
+	 * @param[in]  transform  The transform to sample
+	 *
+	 * @return     A `LUTShaper3D`
+	 */
+	static BasicLUTShaper3D withShaperAndTransform(const BasicLUT1D<T> & shaper, int cubeSize, const Transform & transform);
+
+	/**
+	 * @brief      Fits a shaper and cube to a transform.
+	 * @discussion Lattice density is steered by the curvature of the
+	 *             transform along the neutral axis: the shaper is the
+	 *             normalised integral of the curvature raised to a power.
+	 *             Several powers, including 0 for a plain uniform cube, are
+	 *             tried and the one with the lowest maximum error against the
+	 *             transform is kept.
+	 *
+	 * @throws     std::domain_error  If the sizes or bounds are invalid
+	 *
+	 * @param[in]  transform        The transform to fit
+	 * @param[in]  inputLowerBound  The lowest input value to cover
+	 * @param[in]  inputUpperBound  The highest input value to cover
+	 * @param[in]  cubeSize         The edge length of the cube
+	 * @param[in]  shaperSize       The number of entries in each shaper curve
+	 * @param[in]  interpolation    The interpolation the error is measured
+	 *                              with
+	 *
+	 * @return     The best fitting `LUTShaper3D`
+	 */
+	static BasicLUTShaper3D fitToTransform(const Transform & transform, double inputLowerBound, double inputUpperBound,
+	                                       int cubeSize, int shaperSize = 4096,
+	                                       LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral);
+
+	/**
+	 * @brief      Fits a shaper and a smaller cube to a larger cube
+	 *
+	 * @throws     std::domain_error  If the sizes are invalid
+	 *
+	 * @param[in]  reference      The cube to approximate
+	 * @param[in]  cubeSize       The edge length of the fitted cube
+	 * @param[in]  shaperSize     The number of entries in each shaper curve
+	 * @param[in]  interpolation  The interpolation used to read `reference`
+	 *                            and to measure the error
+	 *
+	 * @tparam     U              The lattice value type of `reference`
+	 *
+	 * @return     The best fitting `LUTShaper3D`
+	 */
+	template <typename U>
+	static BasicLUTShaper3D fitToLUT3D(const BasicLUT3D<U> & reference, int cubeSize, int shaperSize = 4096,
+	                                   LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral)
+	{
+		return fitToTransform([&reference, interpolation](const LUTColor & color)
+		{
+			typedef typename LUTColorValueTraits<U>::ComputeType C;
+			return LUTColor::colorWithColor(reference.colorAtColor(BasicLUTColor<U>::colorWithRGB(
+				(U)(C)color.getR(), (U)(C)color.getG(), (U)(C)color.getB()), interpolation));
+		}, reference.getInputLowerBound(), reference.getInputUpperBound(), cubeSize, shaperSize, interpolation);
+	}
+
+	const BasicLUT1D<T> & getShaper() const { return shaper; }
+	const BasicLUT3D<T> & getCube() const { return cube; }
+
+	/**
+	 * @brief      The number of bytes held by the shaper and cube tables
+	 */
+	std::size_t getTableSize() const;
+
+	/**
+	 * @brief      Look up a single color through the shaper and the cube
+	 *
+	 * @param[in]  color          The input color
+	 * @param[in]  interpolation  The cube interpolation method
+	 *
+	 * @return     The output color
+	 */
+	Color colorAtColor(const Color & color, LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral) const;
+
+	/**
+	 * @brief      Applies the shaper and cube to a span of interleaved RGB
+	 *             pixels. Pixels are processed in blocks so that each block
+	 *             passes through the cube while it is still in cache.
+	 *             `input` and `output` may point to the same buffer.
+	 *
+	 * @param[in]  input          The first input pixel
+	 * @param[out] output         The first output pixel
+	 * @param[in]  pixelCount     The number of pixels to process
+	 * @param[in]  interpolation  The cube interpolation method
+	 * @param[in]  pixelStride    The number of floats from one pixel to the
+	 *                            next, 3 for RGB and 4 for RGBA
+	 */
+	void apply(const float * input, float * output, std::size_t pixelCount,
+	           LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral,
+	           std::size_t pixelStride = 3) const;
+
+	/**
+	 * @brief      Measures the largest per-channel difference from a
+	 *             transform, over a regular grid of inputs and over the
+	 *             centre of every lattice cell.
+	 *
+	 * @throws     std::domain_error  If samplesPerAxis is less than 2
+	 *
+	 * @param[in]  transform       The transform to compare against
+	 * @param[in]  samplesPerAxis  The edge length of the regular input grid
+	 * @param[in]  interpolation   The cube interpolation method
+	 *
+	 * @return     The maximum absolute error, or NaN if the shaper and cube
+	 *             produce NaN for any sample
+	 */
+	double maxErrorAgainst(const Transform & transform, int samplesPerAxis = 32,
+	                       LUT3DInterpolation interpolation = LUT3DInterpolation::Tetrahedral) const;
+};
+
+extern template class BasicLUTShaper3D<float>;
+extern template class BasicLUTShaper3D<double>;
+extern template class BasicLUTShaper3D<LUTHalf>;
+
+/** @brief      A shaper and cube with double precision tables */
+typedef BasicLUTShaper3D<LUTColorValue> LUTShaper3D;
+
+/** @brief      A shaper and cube with single precision tables */
+typedef BasicLUTShaper3D<float> LUTShaper3Df;
+
+/** @brief      A shaper and cube with half precision tables */
+typedef BasicLUTShaper3D<LUTHalf> LUTShaper3Dh;
+
+}